@@ -2,11 +2,14 @@
 #define ANY_H
 #pragma once
 
+#include <cstddef>
 #include <typeinfo>
 #include <utility>
 #include <type_traits>
 #include <stdexcept>
+#include <atomic>
 #include <memory>
+#include "AnyAllocator.h"
 
 namespace Evently
 {
@@ -32,9 +35,25 @@ namespace Evently
         Any(const T &value)
             : content_(new Holder<typename std::remove_reference<T>::type>(value)) {}
 
-        /// 拷贝构造函数
+        /**
+         * @brief 以共享不可变方式存储值
+         *
+         * 拷贝这样的 Any 只增加原子引用计数，不拷贝值；通过 cast<T>()、any_cast<T*> 请求可修改访问时，
+         * 若值仍被其他 Any 共享，先拷贝一份再修改（写时复制）。作为非 const 引用参数传给反射调用时，
+         * 方法写入的是调用期间的副本，实参本身不变。
+         * 适合在多层反射调用间传递的大字符串、大结构体。
+         */
+        template <typename T>
+        static Any shared(const T &value)
+        {
+            Any result;
+            result.content_ = new SharedHolder<typename std::remove_reference<T>::type>(value);
+            return result;
+        }
+
+        /// 拷贝构造函数（共享存储的值只增加引用计数）
         Any(const Any &other)
-            : content_(other.content_ ? other.content_->clone() : nullptr) {}
+            : content_(other.content_ ? other.content_->share() : nullptr) {}
 
         /// 移动构造函数（C++11 noexcept）
         Any(Any &&other) noexcept : content_(other.content_)
@@ -45,7 +64,10 @@ namespace Evently
         /// 析构函数，释放存储的对象
         ~Any()
         {
-            delete content_;
+            if (content_)
+            {
+                content_->release();
+            }
         }
 
         /// 拷贝赋值操作符
@@ -93,6 +115,18 @@ namespace Evently
             return content_ ? content_->type() : typeid(void);
         }
 
+        /// 是否以共享方式存储（见 shared()）
+        bool isShared() const noexcept
+        {
+            return content_ && content_->isShared();
+        }
+
+        /// 存储值的地址（类型由 type() 给出），空对象返回 nullptr
+        const void *data() const noexcept
+        {
+            return content_ ? content_->data() : nullptr;
+        }
+
         /**
          * @brief 尝试将存储的值转换为指定类型的指针
          * @tparam T 目标类型
@@ -101,7 +135,12 @@ namespace Evently
         template <typename T>
         T *cast()
         {
-            return content_ ? &static_cast<Holder<T> *>(content_)->held : nullptr;
+            if (!content_)
+            {
+                return nullptr;
+            }
+            detach();
+            return &static_cast<Holder<T> *>(content_)->held;
         }
 
         /**
@@ -113,6 +152,9 @@ namespace Evently
         template <typename T>
         friend T *any_cast(Any *operand);
 
+        template <typename T>
+        friend const T *any_cast(const Any *operand);
+
     private:
         /**
          * @brief 占位符基类，用于类型擦除
@@ -125,11 +167,48 @@ namespace Evently
         public:
             virtual ~PlaceHolder() {}
 
+            /// Holder 的内存来自 AnyAllocator（默认按大小分级池化），块只保证 max_align_t 的对齐
+            static void *operator new(std::size_t size)
+            {
+                return anyAllocate(size);
+            }
+
+            static void operator delete(void *memory) noexcept
+            {
+                anyDeallocate(memory);
+            }
+
             /// 获取存储值的类型信息
             virtual const std::type_info &type() const = 0;
 
             /// 克隆当前对象
             virtual PlaceHolder *clone() const = 0;
+
+            /// 存储值的地址
+            virtual const void *data() const = 0;
+
+            /// 为新的 Any 拷贝提供内容：默认深拷贝，共享存储增加引用计数
+            virtual PlaceHolder *share()
+            {
+                return clone();
+            }
+
+            /// 放弃一份引用：默认直接销毁，共享存储在最后一个引用时销毁
+            virtual void release()
+            {
+                delete this;
+            }
+
+            /// 是否还有其他 Any 引用同一份内容
+            virtual bool isUnique() const
+            {
+                return true;
+            }
+
+            virtual bool isShared() const
+            {
+                return false;
+            }
         };
 
         /**
@@ -157,9 +236,104 @@ namespace Evently
                 return new Holder(held);
             }
 
+            const void *data() const override
+            {
+                return &held;
+            }
+
+            /// 对齐要求超过 max_align_t 的值在分配器的块内另行对齐（SharedHolder 沿用）
+            static void *operator new(std::size_t size)
+            {
+                return allocate(size, OverAligned());
+            }
+
+            static void operator delete(void *memory) noexcept
+            {
+                deallocate(memory, OverAligned());
+            }
+
             T held; ///< 实际存储的值
+
+        private:
+            typedef std::integral_constant<bool, (alignof(T) > alignof(std::max_align_t))> OverAligned;
+
+            static void *allocate(std::size_t size, std::false_type)
+            {
+                return anyAllocate(size);
+            }
+
+            static void *allocate(std::size_t size, std::true_type)
+            {
+                return anyAllocateAligned(size, alignof(T));
+            }
+
+            static void deallocate(void *memory, std::false_type) noexcept
+            {
+                anyDeallocate(memory);
+            }
+
+            static void deallocate(void *memory, std::true_type) noexcept
+            {
+                anyDeallocateAligned(memory);
+            }
+        };
+
+        /**
+         * @brief 原子引用计数的共享持有者
+         *
+         * 派生自 Holder<T>，按类型取值的代码不需要区分两者。
+         */
+        template <typename T>
+        class SharedHolder : public Holder<T>
+        {
+        public:
+            SharedHolder(const T &value) : Holder<T>(value), refs_(1) {}
+
+            /// 写时复制产生的新副本仍是共享存储
+            PlaceHolder *clone() const override
+            {
+                return new SharedHolder(this->held);
+            }
+
+            PlaceHolder *share() override
+            {
+                refs_.fetch_add(1, std::memory_order_relaxed);
+                return this;
+            }
+
+            void release() override
+            {
+                if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    delete this;
+                }
+            }
+
+            bool isUnique() const override
+            {
+                return refs_.load(std::memory_order_acquire) == 1;
+            }
+
+            bool isShared() const override
+            {
+                return true;
+            }
+
+        private:
+            std::atomic<std::size_t> refs_;
         };
 
+        /// 可修改访问前调用：内容被共享时换成独占的副本
+        void detach()
+        {
+            if (!content_->isUnique())
+            {
+                PlaceHolder *copy = content_->clone();
+                content_->release();
+                content_ = copy;
+            }
+        }
+
         PlaceHolder *content_; ///< 指向实际存储对象的指针
     };
 
@@ -212,6 +386,22 @@ namespace Evently
         return operand ? operand->cast<T>() : nullptr;
     }
 
+    /**
+     * @brief 只读指针版本的类型转换函数（带类型检查，不抛异常）
+     * @tparam T 目标类型
+     * @param operand 指向Any对象的指针
+     * @return const T* 类型匹配时返回指向存储值的指针，否则返回nullptr
+     */
+    template <typename T>
+    const T *any_cast(const Any *operand)
+    {
+        if (operand == nullptr || operand->type() != typeid(T))
+        {
+            return nullptr;
+        }
+        return &static_cast<const Any::Holder<T> *>(operand->content_)->held;
+    }
+
 } // namespace Evently
 
 #endif // ANY_H
@@ -0,0 +1,316 @@
+#include "AnyAllocator.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace Evently
+{
+
+    namespace
+    {
+        /**
+         * @brief 每块内存前的头部：记录分配器和请求的总大小
+         *
+         * 用 max_align_t 补齐，保证头部之后的值仍满足基本对齐。
+         */
+        union BlockHeader
+        {
+            struct
+            {
+                const AnyAllocator *allocator;
+                std::size_t size;
+            } info;
+            std::max_align_t align;
+        };
+
+        const std::size_t kClassCount = 6;         ///< 32, 64, 128, 256, 512, 1024
+        const std::size_t kMinClassShift = 5;
+        const std::size_t kMaxPooledSize = 1024;
+        const std::size_t kTransferBatch = 32;     ///< 与中央链表之间每次搬运的块数
+        const std::size_t kLocalLimit = 64;        ///< 线程本地链表的长度上限
+        const std::size_t kChunkSize = 64 * 1024;  ///< 中央链表每次向系统申请的大小
+
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        std::size_t sizeClassOf(std::size_t size)
+        {
+            // size <= 1024：按 (size - 1) / 32 的最高位确定级别
+            std::size_t units = (size - 1) >> kMinClassShift;
+            std::size_t sizeClass = 0;
+            while (units != 0)
+            {
+                units >>= 1;
+                ++sizeClass;
+            }
+            return sizeClass;
+        }
+
+        std::size_t classSize(std::size_t sizeClass)
+        {
+            return std::size_t(1) << (sizeClass + kMinClassShift);
+        }
+
+        /**
+         * @brief 中央链表：每个级别一把锁，只在线程本地链表耗尽或溢出时访问
+         *
+         * 向系统申请的大块内存不再归还（与常见的池化分配器一致），
+         * 对象本身也有意不析构，保证静态析构阶段释放 Any 时仍然可用。
+         */
+        class CentralPool
+        {
+        public:
+            CentralPool()
+            {
+                for (std::size_t i = 0; i < kClassCount; ++i)
+                {
+                    heads_[i] = nullptr;
+                }
+            }
+
+            /// 取出最多 count 个块组成的链表，返回实际个数
+            std::size_t take(std::size_t sizeClass, std::size_t count, FreeBlock *&head)
+            {
+                std::lock_guard<std::mutex> lock(mutexes_[sizeClass]);
+                if (heads_[sizeClass] == nullptr)
+                {
+                    refillLocked(sizeClass);
+                }
+                head = heads_[sizeClass];
+                FreeBlock *tail = head;
+                std::size_t taken = 1;
+                while (taken < count && tail->next != nullptr)
+                {
+                    tail = tail->next;
+                    ++taken;
+                }
+                heads_[sizeClass] = tail->next;
+                tail->next = nullptr;
+                return taken;
+            }
+
+            /// 归还 head 到 tail 的一串块
+            void give(std::size_t sizeClass, FreeBlock *head, FreeBlock *tail)
+            {
+                std::lock_guard<std::mutex> lock(mutexes_[sizeClass]);
+                tail->next = heads_[sizeClass];
+                heads_[sizeClass] = head;
+            }
+
+        private:
+            void refillLocked(std::size_t sizeClass)
+            {
+                const std::size_t blockSize = classSize(sizeClass);
+                char *chunk = static_cast<char *>(::operator new(kChunkSize));
+                FreeBlock *head = nullptr;
+                for (std::size_t offset = kChunkSize; offset >= blockSize; offset -= blockSize)
+                {
+                    FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + offset - blockSize);
+                    block->next = head;
+                    head = block;
+                }
+                heads_[sizeClass] = head;
+            }
+
+            std::mutex mutexes_[kClassCount];
+            FreeBlock *heads_[kClassCount];
+        };
+
+        CentralPool &centralPool()
+        {
+            static CentralPool *pool = new CentralPool();
+            return *pool;
+        }
+
+        /**
+         * @brief 线程本地的空闲链表
+         *
+         * 本身是平凡类型，快路径上不需要线程局部变量的初始化检查；
+         * 线程第一次向中央链表取块时才注册 ThreadCacheReaper，线程退出时归还剩余的块。
+         */
+        struct ThreadCache
+        {
+            FreeBlock *heads[kClassCount];
+            std::size_t counts[kClassCount];
+            bool registered; ///< 已注册退出时的归还
+            bool destroyed;  ///< 已归还，之后该线程直接访问中央链表
+        };
+
+        thread_local ThreadCache threadCache = {};
+
+        /// 把链表头部的 count 个块归还中央链表
+        void releaseBlocks(ThreadCache &cache, std::size_t sizeClass, std::size_t count)
+        {
+            if (count == 0 || cache.heads[sizeClass] == nullptr)
+            {
+                return;
+            }
+            FreeBlock *head = cache.heads[sizeClass];
+            FreeBlock *tail = head;
+            for (std::size_t i = 1; i < count && tail->next != nullptr; ++i)
+            {
+                tail = tail->next;
+            }
+            cache.heads[sizeClass] = tail->next;
+            cache.counts[sizeClass] -= count;
+            centralPool().give(sizeClass, head, tail);
+        }
+
+        struct ThreadCacheReaper
+        {
+            ~ThreadCacheReaper()
+            {
+                for (std::size_t i = 0; i < kClassCount; ++i)
+                {
+                    releaseBlocks(threadCache, i, threadCache.counts[i]);
+                }
+                threadCache.destroyed = true;
+            }
+        };
+
+        void registerReaper()
+        {
+            thread_local ThreadCacheReaper reaper;
+            (void)reaper;
+            threadCache.registered = true;
+        }
+
+        void *pooledAllocate(std::size_t size)
+        {
+            if (size > kMaxPooledSize)
+            {
+                return ::operator new(size);
+            }
+            std::size_t sizeClass = sizeClassOf(size);
+            ThreadCache &cache = threadCache;
+            FreeBlock *block = cache.heads[sizeClass];
+            if (block == nullptr)
+            {
+                if (cache.destroyed)
+                {
+                    centralPool().take(sizeClass, 1, block);
+                    return block;
+                }
+                if (!cache.registered)
+                {
+                    registerReaper();
+                }
+                cache.counts[sizeClass] = centralPool().take(sizeClass, kTransferBatch, block);
+            }
+            cache.heads[sizeClass] = block->next;
+            --cache.counts[sizeClass];
+            return block;
+        }
+
+        void pooledDeallocate(void *memory, std::size_t size)
+        {
+            if (size > kMaxPooledSize)
+            {
+                ::operator delete(memory);
+                return;
+            }
+            std::size_t sizeClass = sizeClassOf(size);
+            FreeBlock *block = static_cast<FreeBlock *>(memory);
+            ThreadCache &cache = threadCache;
+            if (cache.destroyed)
+            {
+                centralPool().give(sizeClass, block, block);
+                return;
+            }
+            if (!cache.registered)
+            {
+                registerReaper();
+            }
+            block->next = cache.heads[sizeClass];
+            cache.heads[sizeClass] = block;
+            if (++cache.counts[sizeClass] > kLocalLimit)
+            {
+                releaseBlocks(cache, sizeClass, kTransferBatch);
+            }
+        }
+
+        void *systemAllocate(std::size_t size)
+        {
+            return ::operator new(size);
+        }
+
+        void systemDeallocate(void *memory, std::size_t)
+        {
+            ::operator delete(memory);
+        }
+
+        const AnyAllocator pooledAllocator = {&pooledAllocate, &pooledDeallocate};
+        const AnyAllocator systemAllocator = {&systemAllocate, &systemDeallocate};
+
+        std::atomic<const AnyAllocator *> currentAllocator(&pooledAllocator);
+    }
+
+    const AnyAllocator &AnyAllocator::pooled()
+    {
+        return pooledAllocator;
+    }
+
+    const AnyAllocator &AnyAllocator::system()
+    {
+        return systemAllocator;
+    }
+
+    void setAnyAllocator(const AnyAllocator &allocator)
+    {
+        currentAllocator.store(&allocator, std::memory_order_release);
+    }
+
+    const AnyAllocator &anyAllocator()
+    {
+        return *currentAllocator.load(std::memory_order_acquire);
+    }
+
+    void *anyAllocate(std::size_t size)
+    {
+        const AnyAllocator *allocator = currentAllocator.load(std::memory_order_acquire);
+        std::size_t total = sizeof(BlockHeader) + size;
+        void *memory = allocator->allocate(total);
+        if (memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        BlockHeader *header = static_cast<BlockHeader *>(memory);
+        header->info.allocator = allocator;
+        header->info.size = total;
+        return header + 1;
+    }
+
+    void anyDeallocate(void *memory) noexcept
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+        BlockHeader *header = static_cast<BlockHeader *>(memory) - 1;
+        header->info.allocator->deallocate(header, header->info.size);
+    }
+
+    void *anyAllocateAligned(std::size_t size, std::size_t alignment)
+    {
+        // 块的起始地址满足基本对齐：对齐后至多前移 alignment 字节，且之前至少留出一个指针
+        char *block = static_cast<char *>(anyAllocate(size + alignment));
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block + sizeof(void *));
+        address = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+        void **aligned = reinterpret_cast<void **>(address);
+        aligned[-1] = block;
+        return aligned;
+    }
+
+    void anyDeallocateAligned(void *memory) noexcept
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+        anyDeallocate(static_cast<void **>(memory)[-1]);
+    }
+
+} // namespace Evently
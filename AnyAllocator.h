@@ -0,0 +1,61 @@
+#ifndef ANY_ALLOCATOR_H
+#define ANY_ALLOCATOR_H
+#pragma once
+
+#include <cstddef>
+
+namespace Evently
+{
+
+    /**
+     * @brief Any 存储值所用的分配器
+     *
+     * 以一对函数指针描述，可以替换为自定义实现。每块内存记录分配它的分配器，
+     * 因此切换分配器后，之前分配的值仍会交还给原来的分配器释放；
+     * 自定义分配器对象必须在其分配的所有值释放之前保持有效。
+     */
+    struct AnyAllocator
+    {
+        void *(*allocate)(std::size_t size);
+        void (*deallocate)(void *memory, std::size_t size);
+
+        /**
+         * @brief 默认的池化分配器
+         *
+         * 按大小分级（32 到 1024 字节），每个线程有自己的空闲链表，分配和释放不加锁；
+         * 线程本地链表过长或线程退出时，成批归还到按级别加锁的中央链表。
+         * 一个线程分配、另一个线程释放的内存进入释放线程的链表，可以安全复用。
+         * 超过 1024 字节的请求直接使用全局 operator new。
+         */
+        static const AnyAllocator &pooled();
+
+        /// 直接使用全局 operator new / delete
+        static const AnyAllocator &system();
+    };
+
+    /// 设置之后新分配的 Any 值所用的分配器（线程安全）
+    void setAnyAllocator(const AnyAllocator &allocator);
+
+    /// 当前的 Any 分配器
+    const AnyAllocator &anyAllocator();
+
+    /// 为 Any 的值分配内存（Any 内部使用）
+    void *anyAllocate(std::size_t size);
+
+    /// 释放 anyAllocate 分配的内存，交还给分配它的分配器
+    void anyDeallocate(void *memory) noexcept;
+
+    /**
+     * @brief 为对齐要求超过 max_align_t 的值分配内存（Any 内部使用）
+     *
+     * 分配器的块只保证基本对齐：多申请 alignment 字节，在块内对齐，并在对齐地址之前记下块的起始地址。
+     * @param alignment 2 的幂，大于 alignof(std::max_align_t)
+     */
+    void *anyAllocateAligned(std::size_t size, std::size_t alignment);
+
+    /// 释放 anyAllocateAligned 分配的内存
+    void anyDeallocateAligned(void *memory) noexcept;
+
+} // namespace Evently
+
+#endif // ANY_ALLOCATOR_H
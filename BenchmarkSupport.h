@@ -0,0 +1,170 @@
+#ifndef BENCHMARK_SUPPORT_H
+#define BENCHMARK_SUPPORT_H
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Evently
+{
+
+    /**
+     * @brief 简单计时器
+     */
+    class Stopwatch
+    {
+    public:
+        Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+        double elapsedMs() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief 单个硬件 / 软件事件计数（Linux perf_event_open；不支持或无权限时不可用）
+     *
+     * 只统计创建计数器的线程，多线程测试需在每个线程中各建一个再求和。
+     */
+    class PerfCounter
+    {
+    public:
+        enum class Event
+        {
+            Cycles,         ///< CPU 周期
+            Instructions,   ///< 执行的指令
+            CacheMisses,    ///< 末级缓存未命中
+            ContextSwitches ///< 上下文切换（软件事件，通常无需特权也可用）
+        };
+
+        explicit PerfCounter(Event event) : fd_(-1)
+        {
+#if defined(__linux__)
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            switch (event)
+            {
+            case Event::Cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case Event::Instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Event::CacheMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case Event::ContextSwitches:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+                break;
+            }
+            attr.disabled = 1;
+            // 上下文切换发生在内核中，排除内核时计数总为 0
+            attr.exclude_kernel = event == Event::ContextSwitches ? 0 : 1;
+            attr.exclude_hv = 1;
+            fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+            (void)event;
+#endif
+        }
+
+        ~PerfCounter()
+        {
+#if defined(__linux__)
+            if (fd_ >= 0)
+            {
+                close(fd_);
+            }
+#endif
+        }
+
+        PerfCounter(const PerfCounter &) = delete;
+        PerfCounter &operator=(const PerfCounter &) = delete;
+
+        bool available() const { return fd_ >= 0; }
+
+        void start()
+        {
+#if defined(__linux__)
+            if (fd_ >= 0)
+            {
+                ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        /// 停止计数并返回 start 以来的事件数（不可用时返回 0）
+        std::uint64_t stop()
+        {
+            std::uint64_t count = 0;
+#if defined(__linux__)
+            if (fd_ >= 0)
+            {
+                ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+                {
+                    count = 0;
+                }
+            }
+#endif
+            return count;
+        }
+
+    private:
+        int fd_;
+    };
+
+    /**
+     * @brief 硬件缓存未命中计数
+     */
+    class CacheMissCounter : public PerfCounter
+    {
+    public:
+        CacheMissCounter() : PerfCounter(Event::CacheMisses) {}
+    };
+
+    /**
+     * @brief 扩展性测试使用的线程数序列：1, 2, 4, ... 以及 maxThreads（0 表示硬件并发数）
+     */
+    inline std::vector<std::size_t> threadCounts(std::size_t maxThreads = 0)
+    {
+        if (maxThreads == 0)
+        {
+            maxThreads = std::thread::hardware_concurrency();
+        }
+        if (maxThreads == 0)
+        {
+            maxThreads = 1;
+        }
+        std::vector<std::size_t> counts;
+        for (std::size_t threads = 1; threads < maxThreads; threads *= 2)
+        {
+            counts.push_back(threads);
+        }
+        counts.push_back(maxThreads);
+        return counts;
+    }
+
+} // namespace Evently
+
+#endif // BENCHMARK_SUPPORT_H
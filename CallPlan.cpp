@@ -0,0 +1,215 @@
+#include "CallPlan.h"
+#include <stdexcept>
+
+namespace Evently
+{
+
+    const std::size_t CallPlan::npos;
+
+    CallPlan::CallPlan(const ReflectionRegistry &registry, const std::string &className)
+        : registry_(registry), className_(className), frameSize_(0)
+    {
+        if (className.empty())
+        {
+            throw std::invalid_argument("CallPlan: 类名不能为空");
+        }
+    }
+
+    std::size_t CallPlan::addSlot(const TypeOps &ops, std::shared_ptr<void> constant)
+    {
+        if (ops.construct == nullptr || ops.assign == nullptr)
+        {
+            throw std::invalid_argument("CallPlan: 槽位类型必须可默认构造且可拷贝赋值: " +
+                                        std::string(ops.type->name()));
+        }
+        if (ops.align > alignof(std::max_align_t))
+        {
+            throw std::invalid_argument("CallPlan: 不支持超对齐的槽位类型: " + std::string(ops.type->name()));
+        }
+
+        Slot slot;
+        slot.ops = &ops;
+        slot.offset = (frameSize_ + ops.align - 1) / ops.align * ops.align;
+        slot.constant = std::move(constant);
+        frameSize_ = slot.offset + ops.size;
+        slots_.push_back(std::move(slot));
+        return slots_.size() - 1;
+    }
+
+    const PropertySetterBase &CallPlan::requireField(const std::string &fieldName) const
+    {
+        const PropertySetterBase *field = registry_.findField(className_, fieldName);
+        if (field == nullptr)
+        {
+            throw std::runtime_error("CallPlan: 未找到字段: " + className_ + "::" + fieldName);
+        }
+        return *field;
+    }
+
+    void CallPlan::checkSlot(std::size_t slot) const
+    {
+        if (slot >= slots_.size())
+        {
+            throw std::out_of_range("CallPlan: 槽位编号越界");
+        }
+    }
+
+    const std::type_info &CallPlan::slotType(std::size_t slot) const
+    {
+        checkSlot(slot);
+        return *slots_[slot].ops->type;
+    }
+
+    std::size_t CallPlan::readField(const std::string &fieldName)
+    {
+        const PropertySetterBase &field = requireField(fieldName);
+        std::size_t slot = addSlot(field.fieldOps(), std::shared_ptr<void>());
+
+        Instruction instruction = {OpCode::ReadField, field, ResolvedMethod(), slot, 0, 0};
+        instructions_.push_back(instruction);
+        return slot;
+    }
+
+    void CallPlan::writeField(const std::string &fieldName, std::size_t slot)
+    {
+        checkSlot(slot);
+        const PropertySetterBase &field = requireField(fieldName);
+        if (!field.writable())
+        {
+            throw std::invalid_argument("CallPlan: 字段不可写: " + className_ + "::" + fieldName);
+        }
+        if (field.fieldType() != *slots_[slot].ops->type)
+        {
+            throw std::invalid_argument("CallPlan: 槽位类型与字段类型不匹配: " + className_ + "::" + fieldName);
+        }
+
+        Instruction instruction = {OpCode::WriteField, field, ResolvedMethod(), slot, 0, 0};
+        instructions_.push_back(instruction);
+    }
+
+    std::size_t CallPlan::callMethod(const std::string &methodName, const std::vector<std::size_t> &argSlots)
+    {
+        std::vector<const std::type_info *> argTypes;
+        for (std::size_t slot : argSlots)
+        {
+            checkSlot(slot);
+            argTypes.push_back(slots_[slot].ops->type);
+        }
+        ResolvedMethod method = registry_.resolveMethod(className_, methodName, argTypes);
+
+        const TypeOps &returnOps = method.invoker.returnOps();
+        std::size_t result = returnOps.size == 0 ? npos : addSlot(returnOps, std::shared_ptr<void>());
+
+        Instruction instruction = {OpCode::CallMethod, FieldThunk(), method, result, argSlots_.size(), argSlots.size()};
+        argSlots_.insert(argSlots_.end(), argSlots.begin(), argSlots.end());
+        instructions_.push_back(instruction);
+        return result;
+    }
+
+    CallPlanFrame CallPlan::createFrame() const
+    {
+        return CallPlanFrame(*this);
+    }
+
+    void CallPlan::execute(void *instance, CallPlanFrame &frame) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        if (frame.plan_ != this)
+        {
+            throw std::invalid_argument("CallPlan: 执行帧不属于该计划");
+        }
+
+        for (const auto &instruction : instructions_)
+        {
+            switch (instruction.op)
+            {
+            case OpCode::ReadField:
+                instruction.field.readRaw(instance, frame.slots_[instruction.slot]);
+                break;
+            case OpCode::WriteField:
+                instruction.field.writeRaw(instance, frame.slots_[instruction.slot]);
+                break;
+            case OpCode::CallMethod:
+                instruction.method.invokeRaw(instance, frame.args_.data() + instruction.argBegin,
+                                             instruction.slot == npos ? nullptr : frame.slots_[instruction.slot]);
+                break;
+            }
+        }
+    }
+
+    CallPlanFrame::CallPlanFrame(const CallPlan &plan)
+        : plan_(&plan), constructed_(0)
+    {
+        const std::size_t words = (plan.frameSize_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        storage_.reset(new std::max_align_t[words == 0 ? 1 : words]);
+        char *base = reinterpret_cast<char *>(storage_.get());
+
+        slots_.reserve(plan.slots_.size());
+        try
+        {
+            for (const auto &slot : plan.slots_)
+            {
+                void *address = base + slot.offset;
+                slot.ops->construct(address);
+                slots_.push_back(address);
+                ++constructed_;
+                if (slot.constant)
+                {
+                    slot.ops->assign(address, slot.constant.get());
+                }
+            }
+        }
+        catch (...)
+        {
+            destroySlots();
+            throw;
+        }
+
+        args_.reserve(plan.argSlots_.size());
+        for (std::size_t slot : plan.argSlots_)
+        {
+            args_.push_back(slots_[slot]);
+        }
+    }
+
+    CallPlanFrame::CallPlanFrame(CallPlanFrame &&other) noexcept
+        : plan_(other.plan_),
+          storage_(std::move(other.storage_)),
+          slots_(std::move(other.slots_)),
+          args_(std::move(other.args_)),
+          constructed_(other.constructed_)
+    {
+        other.constructed_ = 0;
+    }
+
+    CallPlanFrame::~CallPlanFrame()
+    {
+        destroySlots();
+    }
+
+    void CallPlanFrame::destroySlots()
+    {
+        for (std::size_t i = constructed_; i > 0; --i)
+        {
+            plan_->slots_[i - 1].ops->destroy(slots_[i - 1]);
+        }
+        constructed_ = 0;
+    }
+
+    void *CallPlanFrame::slotAddress(std::size_t index, const std::type_info &type)
+    {
+        if (index >= slots_.size())
+        {
+            throw std::out_of_range("CallPlanFrame: 槽位编号越界");
+        }
+        if (*plan_->slots_[index].ops->type != type)
+        {
+            throw std::invalid_argument("CallPlanFrame: 槽位类型不匹配");
+        }
+        return slots_[index];
+    }
+
+} // namespace Evently
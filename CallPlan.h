@@ -0,0 +1,163 @@
+#ifndef CALL_PLAN_H
+#define CALL_PLAN_H
+#pragma once
+
+#include "Reflection.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Evently
+{
+
+    class CallPlanFrame;
+
+    /**
+     * @brief 编译后的反射调用序列
+     *
+     * 构建阶段按顺序描述字段读写和方法调用，每一步都立即在注册表中解析并做类型检查
+     * （找不到成员或类型不匹配时抛出异常）。中间值保存在类型化的槽位中，
+     * 执行时只按扁平的指令数组依次调用，不做字符串查找，也不经过 Any。
+     *
+     * 计划持有注册表中访问器和调用器的指针，之后不应再替换这些成员的注册。
+     *
+     * @code
+     * CallPlan plan(registry, "Person");
+     * std::size_t name = plan.readField("name");
+     * std::size_t greeting = plan.callMethod("greet", {name});
+     * plan.writeField("name", greeting);
+     * CallPlanFrame frame = plan.createFrame();
+     * plan.execute(&person, frame);
+     * @endcode
+     */
+    class CallPlan
+    {
+    public:
+        /// 无结果槽（void 方法的返回值）
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        CallPlan(const ReflectionRegistry &registry, const std::string &className);
+
+        /// 输入槽：每次执行前由调用方通过帧写入
+        template <typename T>
+        std::size_t input()
+        {
+            return addSlot(TypeOps::of<T>(), std::shared_ptr<void>());
+        }
+
+        /// 常量槽：创建帧时写入 value
+        template <typename T>
+        std::size_t constant(const T &value)
+        {
+            return addSlot(TypeOps::of<T>(), std::shared_ptr<void>(new T(value)));
+        }
+
+        /// 读取字段到新槽位，返回槽位编号
+        std::size_t readField(const std::string &fieldName);
+
+        /// 把槽位的值写入字段（类型必须与字段一致，且字段可写）
+        void writeField(const std::string &fieldName, std::size_t slot);
+
+        /**
+         * @brief 以若干槽位为参数调用方法（按槽位类型选择重载）
+         * @return 保存返回值的槽位编号；void 方法返回 npos
+         */
+        std::size_t callMethod(const std::string &methodName,
+                               const std::vector<std::size_t> &argSlots = std::vector<std::size_t>());
+
+        std::size_t slotCount() const { return slots_.size(); }
+        const std::type_info &slotType(std::size_t slot) const;
+
+        /// 为执行分配槽位存储；同一帧可反复执行，但不能被多个线程同时使用
+        CallPlanFrame createFrame() const;
+
+        /// 在实例上执行计划：不做查找，不分配堆内存
+        void execute(void *instance, CallPlanFrame &frame) const;
+
+    private:
+        enum class OpCode
+        {
+            ReadField,
+            WriteField,
+            CallMethod
+        };
+
+        struct Instruction
+        {
+            OpCode op;
+            FieldThunk field;     ///< 按值保存，之后该类再注册成员也不受影响
+            ResolvedMethod method;
+            std::size_t slot;     ///< 读取目标 / 写入来源 / 调用结果
+            std::size_t argBegin; ///< 参数槽位在 argSlots_ 中的起始位置
+            std::size_t argCount;
+        };
+
+        struct Slot
+        {
+            const TypeOps *ops;
+            std::size_t offset;             ///< 在帧存储中的偏移
+            std::shared_ptr<void> constant; ///< 常量槽的初始值
+        };
+
+        std::size_t addSlot(const TypeOps &ops, std::shared_ptr<void> constant);
+        const PropertySetterBase &requireField(const std::string &fieldName) const;
+        void checkSlot(std::size_t slot) const;
+
+        friend class CallPlanFrame;
+
+        const ReflectionRegistry &registry_;
+        std::string className_;
+        std::vector<Instruction> instructions_;
+        std::vector<std::size_t> argSlots_;
+        std::vector<Slot> slots_;
+        std::size_t frameSize_;
+    };
+
+    /**
+     * @brief 调用计划的执行帧：保存所有槽位的值
+     *
+     * 创建时一次性分配并构造全部槽位，预先算好每条调用指令的参数指针，
+     * 之后每次执行都复用这些存储。帧的生命周期不能超过创建它的计划。
+     */
+    class CallPlanFrame
+    {
+    public:
+        CallPlanFrame(CallPlanFrame &&other) noexcept;
+        ~CallPlanFrame();
+
+        CallPlanFrame(const CallPlanFrame &) = delete;
+        CallPlanFrame &operator=(const CallPlanFrame &) = delete;
+        CallPlanFrame &operator=(CallPlanFrame &&) = delete;
+
+        /// 访问槽位的值（检查类型）
+        template <typename T>
+        T &slot(std::size_t index)
+        {
+            return *static_cast<T *>(slotAddress(index, typeid(T)));
+        }
+
+        template <typename T>
+        const T &slot(std::size_t index) const
+        {
+            return *static_cast<const T *>(const_cast<CallPlanFrame *>(this)->slotAddress(index, typeid(T)));
+        }
+
+    private:
+        friend class CallPlan;
+
+        explicit CallPlanFrame(const CallPlan &plan);
+        void *slotAddress(std::size_t index, const std::type_info &type);
+        void destroySlots();
+
+        const CallPlan *plan_;
+        std::unique_ptr<std::max_align_t[]> storage_;
+        std::vector<void *> slots_;       ///< 各槽位地址
+        std::vector<const void *> args_;  ///< 按指令展开的参数指针
+        std::size_t constructed_;         ///< 已构造的槽位数（用于异常安全的析构）
+    };
+
+} // namespace Evently
+
+#endif // CALL_PLAN_H
@@ -0,0 +1,233 @@
+#include "ComparePlan.h"
+#include "MemberTable.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    namespace
+    {
+        struct ElementHashContext
+        {
+            std::uint64_t (*hashKey)(const void *);
+            std::uint64_t (*hashElement)(const void *);
+            std::uint64_t hash;
+        };
+
+        void hashElement(void *context, const void *key, const void *element)
+        {
+            ElementHashContext &state = *static_cast<ElementHashContext *>(context);
+            if (key != nullptr)
+            {
+                state.hash = hashCombine(state.hash, state.hashKey(key));
+            }
+            state.hash = hashCombine(state.hash, state.hashElement(element));
+        }
+
+        /// 无序容器：相等的容器可能以不同顺序遍历，各项的哈希混合后求和，与顺序无关
+        void hashUnorderedEntry(void *context, const void *key, const void *element)
+        {
+            ElementHashContext &state = *static_cast<ElementHashContext *>(context);
+            std::uint64_t entry = state.hashElement(element);
+            if (key != nullptr)
+            {
+                entry = hashCombine(state.hashKey(key), entry);
+            }
+            // 求和前先充分混合，避免各项哈希的线性关系互相抵消
+            entry ^= entry >> 33;
+            entry *= 0xff51afd7ed558ccdULL;
+            entry ^= entry >> 33;
+            entry *= 0xc4ceb9fe1a85ec53ULL;
+            entry ^= entry >> 33;
+            state.hash += entry;
+        }
+
+        /// 没有 std::hash 的容器：有序容器按遍历顺序组合元素（和键）的哈希，无序容器与顺序无关
+        bool containerHashable(const TypeOps &ops)
+        {
+            if (ops.container == nullptr || ops.container->elementOps().hash == nullptr)
+            {
+                return false;
+            }
+            return !ops.container->associative || ops.container->keyOps().hash != nullptr;
+        }
+
+        std::uint64_t hashContainer(const TypeOps &ops, const void *container)
+        {
+            const ContainerOps &container_ = *ops.container;
+            const std::uint64_t size = container_.size(container);
+            ElementHashContext context = {container_.associative ? container_.keyOps().hash : nullptr,
+                                          container_.elementOps().hash, container_.unordered ? 0 : size};
+            if (container_.unordered)
+            {
+                container_.forEach(container, &hashUnorderedEntry, &context);
+                return hashCombine(size, context.hash);
+            }
+            container_.forEach(container, &hashElement, &context);
+            return context.hash;
+        }
+
+        bool byOffset(const std::pair<std::size_t, const TypeOps *> &a,
+                      const std::pair<std::size_t, const TypeOps *> &b)
+        {
+            return a.first < b.first;
+        }
+    } // namespace
+
+    ComparePlan::ComparePlan(const ReflectionRegistry &registry, const std::string &className, const void *sample)
+    {
+        if (sample == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const MemberTable *table = registry.memberTable(className);
+        if (table == nullptr || table->fieldCount() == 0)
+        {
+            throw std::runtime_error("类没有注册字段: " + className);
+        }
+
+        std::vector<std::pair<std::size_t, const TypeOps *>> slots;
+        for (std::size_t i = 0; i < table->fieldCount(); ++i)
+        {
+            const FieldThunk &field = table->field(i);
+            const std::size_t offset = static_cast<std::size_t>(static_cast<const char *>(field.fieldAddress(sample)) -
+                                                                static_cast<const char *>(sample));
+            bool duplicate = false;
+            for (const auto &slot : slots)
+            {
+                duplicate = duplicate || slot.first == offset;
+            }
+            if (duplicate)
+            {
+                continue;
+            }
+            slots.push_back(std::make_pair(offset, field.ops));
+
+            // 记录每种能力的第一个不支持的字段，用到该能力时再报错
+            const std::string name = className + "::" + table->fieldName(i);
+            if (unequalField_.empty() && !field.ops->bitwise && field.ops->equals == nullptr)
+            {
+                unequalField_ = name;
+            }
+            if (uncomparableField_.empty() && field.ops->compare == nullptr)
+            {
+                uncomparableField_ = name;
+            }
+            if (unhashableField_.empty() && !field.ops->bitwise && field.ops->hash == nullptr &&
+                !containerHashable(*field.ops))
+            {
+                unhashableField_ = name;
+            }
+            Step step = {offset, field.ops->size, field.ops};
+            fields_.push_back(step);
+        }
+        std::stable_sort(slots.begin(), slots.end(), byOffset);
+
+        for (const auto &slot : slots)
+        {
+            const TypeOps &ops = *slot.second;
+            if (ops.bitwise)
+            {
+                // 只合并首尾相接的字段：中间的填充字节的值不确定
+                if (!steps_.empty() && steps_.back().ops == nullptr &&
+                    steps_.back().offset + steps_.back().size == slot.first)
+                {
+                    steps_.back().size += ops.size;
+                    continue;
+                }
+                Step step = {slot.first, ops.size, nullptr};
+                steps_.push_back(step);
+            }
+            else
+            {
+                Step step = {slot.first, ops.size, &ops};
+                steps_.push_back(step);
+            }
+        }
+    }
+
+    bool ComparePlan::equals(const void *a, const void *b) const
+    {
+        if (!unequalField_.empty())
+        {
+            throw std::invalid_argument("字段不支持相等比较: " + unequalField_);
+        }
+        if (a == b)
+        {
+            return true;
+        }
+        const char *left = static_cast<const char *>(a);
+        const char *right = static_cast<const char *>(b);
+        for (const auto &step : steps_)
+        {
+            const bool same = step.ops == nullptr
+                                  ? std::memcmp(left + step.offset, right + step.offset, step.size) == 0
+                                  : step.ops->equals(left + step.offset, right + step.offset);
+            if (!same)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int ComparePlan::compare(const void *a, const void *b) const
+    {
+        if (!uncomparableField_.empty())
+        {
+            throw std::invalid_argument("字段不支持大小比较: " + uncomparableField_);
+        }
+        const char *left = static_cast<const char *>(a);
+        const char *right = static_cast<const char *>(b);
+        for (const auto &field : fields_)
+        {
+            const int result = field.ops->compare(left + field.offset, right + field.offset);
+            if (result != 0)
+            {
+                return result;
+            }
+        }
+        return 0;
+    }
+
+    std::uint64_t ComparePlan::hash(const void *object) const
+    {
+        if (!unhashableField_.empty())
+        {
+            throw std::invalid_argument("字段不支持哈希: " + unhashableField_);
+        }
+        const char *base = static_cast<const char *>(object);
+        std::uint64_t hash = 0;
+        for (const auto &step : steps_)
+        {
+            std::uint64_t value;
+            if (step.ops == nullptr)
+            {
+                value = hashBytes(base + step.offset, step.size);
+            }
+            else if (step.ops->hash != nullptr)
+            {
+                value = step.ops->hash(base + step.offset);
+            }
+            else
+            {
+                value = hashContainer(*step.ops, base + step.offset);
+            }
+            hash = hashCombine(hash, value);
+        }
+        return hash;
+    }
+
+    std::size_t ComparePlan::byteRunCount() const
+    {
+        std::size_t count = 0;
+        for (const auto &step : steps_)
+        {
+            count += step.ops == nullptr;
+        }
+        return count;
+    }
+
+} // namespace Evently
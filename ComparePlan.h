@@ -0,0 +1,137 @@
+#ifndef COMPARE_PLAN_H
+#define COMPARE_PLAN_H
+#pragma once
+
+#include "Reflection.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 编译后的对象比较与哈希：由字段元数据生成 equals / compare / hash
+     *
+     * equals 和 hash 按字段偏移排序，首尾相接的按字节可比字段（整数、枚举、指针）
+     * 合并为一次 memcmp / 一段字节哈希，其余字段用自身的 operator== 和哈希；
+     * compare 按注册顺序逐字段三路比较（operator<），第一个不等的字段决定结果。
+     * 只参与注册过的字段（含继承字段），同一成员以多个名字注册时只算一次。
+     * 字段偏移在构建时由一个已有实例（sample）求出，与 CopyPlan 相同。
+     *
+     * @code
+     * ComparePlan plan(registry, "Person", &people[0]);
+     * bool same = plan.equals(&people[0], &people[1]);
+     * std::uint64_t hash = plan.hash(&people[0]);
+     * @endcode
+     */
+    class ComparePlan
+    {
+    public:
+        /**
+         * @throws std::runtime_error 类没有注册字段
+         */
+        ComparePlan(const ReflectionRegistry &registry, const std::string &className, const void *sample);
+
+        /// @throws std::invalid_argument 某个字段不支持 operator==
+        bool equals(const void *a, const void *b) const;
+
+        /// 小于返回负数，相等返回 0，大于返回正数
+        /// @throws std::invalid_argument 某个字段不支持 operator<
+        int compare(const void *a, const void *b) const;
+
+        /// @throws std::invalid_argument 某个字段既没有 std::hash 也不是元素可哈希的容器
+        std::uint64_t hash(const void *object) const;
+
+        bool canEqual() const { return unequalField_.empty(); }
+        bool canCompare() const { return uncomparableField_.empty(); }
+        bool canHash() const { return unhashableField_.empty(); }
+
+        /// 参与比较的字段数
+        std::size_t fieldCount() const { return fields_.size(); }
+
+        /// equals / hash 的步骤数，其中 byteRunCount() 个是合并后的字节段
+        std::size_t stepCount() const { return steps_.size(); }
+        std::size_t byteRunCount() const;
+
+    private:
+        struct Step
+        {
+            std::size_t offset;
+            std::size_t size;
+            const TypeOps *ops; ///< nullptr 表示按字节比较和哈希
+        };
+
+        std::vector<Step> steps_;  ///< 按偏移排序
+        std::vector<Step> fields_; ///< 按注册顺序，供 compare 使用
+        std::string unequalField_;
+        std::string uncomparableField_;
+        std::string unhashableField_;
+    };
+
+    /**
+     * @brief 基于 ComparePlan 的函数对象，可直接用作无序容器和有序容器的模板参数
+     *
+     * 计划在构造时建立（偏移由 T 的未初始化存储求出，不要求 T 可默认构造），
+     * 之后的调用不加锁、不查表。
+     *
+     * @code
+     * std::unordered_map<Person, int, ReflectedHash<Person>, ReflectedEqual<Person>> counts(
+     *     16, ReflectedHash<Person>(registry, "Person"), ReflectedEqual<Person>(registry, "Person"));
+     * @endcode
+     */
+    template <typename T>
+    class ReflectedFunctor
+    {
+    public:
+        ReflectedFunctor(const ReflectionRegistry &registry, const std::string &className)
+        {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            plan_ = registry.comparePlan(className, &storage);
+        }
+
+        const ComparePlan &plan() const { return *plan_; }
+
+    protected:
+        std::shared_ptr<const ComparePlan> plan_;
+    };
+
+    template <typename T>
+    class ReflectedHash : public ReflectedFunctor<T>
+    {
+    public:
+        ReflectedHash(const ReflectionRegistry &registry, const std::string &className)
+            : ReflectedFunctor<T>(registry, className) {}
+
+        std::size_t operator()(const T &object) const
+        {
+            return static_cast<std::size_t>(this->plan_->hash(&object));
+        }
+    };
+
+    template <typename T>
+    class ReflectedEqual : public ReflectedFunctor<T>
+    {
+    public:
+        ReflectedEqual(const ReflectionRegistry &registry, const std::string &className)
+            : ReflectedFunctor<T>(registry, className) {}
+
+        bool operator()(const T &a, const T &b) const { return this->plan_->equals(&a, &b); }
+    };
+
+    template <typename T>
+    class ReflectedLess : public ReflectedFunctor<T>
+    {
+    public:
+        ReflectedLess(const ReflectionRegistry &registry, const std::string &className)
+            : ReflectedFunctor<T>(registry, className) {}
+
+        bool operator()(const T &a, const T &b) const { return this->plan_->compare(&a, &b) < 0; }
+    };
+
+} // namespace Evently
+
+#endif // COMPARE_PLAN_H
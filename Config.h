@@ -0,0 +1,37 @@
+#ifndef EVENTLY_CONFIG_H
+#define EVENTLY_CONFIG_H
+#pragma once
+
+/**
+ * @brief 编译所用的 C++ 标准（由 CMake 的 EVENTLY_CXX_STANDARD 选择）
+ *
+ * 公共接口在各标准下相同；较新的标准只替换内部实现：
+ * C++14 起 index_sequence 使用 std::index_sequence（编译器内建，不再递归实例化），
+ * C++17 起 NameRef 可由 std::string_view 构造，参数包改用折叠表达式展开，
+ * 编译期分支使用 if constexpr。
+ */
+#if defined(_MSVC_LANG) && _MSVC_LANG > __cplusplus
+#define EVENTLY_CPLUSPLUS _MSVC_LANG
+#else
+#define EVENTLY_CPLUSPLUS __cplusplus
+#endif
+
+#if EVENTLY_CPLUSPLUS >= 201402L
+#define EVENTLY_HAS_CXX14 1
+#else
+#define EVENTLY_HAS_CXX14 0
+#endif
+
+#if EVENTLY_CPLUSPLUS >= 201703L
+#define EVENTLY_HAS_CXX17 1
+#else
+#define EVENTLY_HAS_CXX17 0
+#endif
+
+#if EVENTLY_CPLUSPLUS >= 202002L
+#define EVENTLY_HAS_CXX20 1
+#else
+#define EVENTLY_HAS_CXX20 0
+#endif
+
+#endif // EVENTLY_CONFIG_H
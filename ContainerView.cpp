@@ -0,0 +1,161 @@
+#include "ContainerView.h"
+#include <stdexcept>
+#include <string>
+
+namespace Evently
+{
+
+    ContainerView::ContainerView(const TypeOps &ops, const void *container, bool writable)
+        : type_(&ops), ops_(ops.container), container_(container), writable_(writable)
+    {
+        if (ops_ == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 不是支持的容器类型: " + std::string(ops.type->name()));
+        }
+        if (container == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 容器指针不能为空");
+        }
+    }
+
+    Any ContainerView::get(std::size_t index) const
+    {
+        const TypeOps &element = ops_->elementOps();
+        if (element.box == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 元素类型不可拷贝");
+        }
+        return element.box(elementAt(index));
+    }
+
+    void ContainerView::set(std::size_t index, const Any &value)
+    {
+        checkElement(value.type());
+        checkWritable();
+        const TypeOps &element = ops_->elementOps();
+        if (element.assign == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 元素类型不可赋值");
+        }
+        element.assign(const_cast<void *>(elementAt(index)), value.data());
+    }
+
+    void ContainerView::append(const Any &value)
+    {
+        checkElement(value.type());
+        appendRaw(value.data());
+    }
+
+    Any ContainerView::find(const Any &key) const
+    {
+        checkKey(key.type());
+        const void *element = findRaw(key.data());
+        if (element == nullptr)
+        {
+            return Any();
+        }
+        const TypeOps &mapped = ops_->elementOps();
+        if (mapped.box == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 元素类型不可拷贝");
+        }
+        return mapped.box(element);
+    }
+
+    void ContainerView::insert(const Any &key, const Any &value)
+    {
+        checkKey(key.type());
+        checkElement(value.type());
+        insertRaw(key.data(), value.data());
+    }
+
+    void ContainerView::clear()
+    {
+        checkWritable();
+        if (ops_->clear == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 定长容器不能清空");
+        }
+        ops_->clear(const_cast<void *>(container_));
+    }
+
+    void ContainerView::forEachRaw(ContainerOps::Visitor visit, void *context) const
+    {
+        ops_->forEach(container_, visit, context);
+    }
+
+    const void *ContainerView::elementAt(std::size_t index) const
+    {
+        if (ops_->at == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 容器不支持下标访问");
+        }
+        if (index >= ops_->size(container_))
+        {
+            throw std::out_of_range("ContainerView: 下标越界");
+        }
+        return ops_->at(container_, index);
+    }
+
+    void ContainerView::appendRaw(const void *element)
+    {
+        checkWritable();
+        if (ops_->append == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 容器不支持追加元素");
+        }
+        ops_->append(const_cast<void *>(container_), element);
+    }
+
+    const void *ContainerView::findRaw(const void *key) const
+    {
+        if (ops_->find == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 只有关联容器支持按键查找");
+        }
+        return ops_->find(container_, key);
+    }
+
+    void ContainerView::insertRaw(const void *key, const void *element)
+    {
+        checkWritable();
+        if (ops_->insert == nullptr)
+        {
+            throw std::invalid_argument("ContainerView: 只有关联容器支持按键插入");
+        }
+        ops_->insert(const_cast<void *>(container_), key, element);
+    }
+
+    void ContainerView::checkElement(const std::type_info &type) const
+    {
+        if (type != elementType())
+        {
+            throw std::invalid_argument("ContainerView: 元素类型不匹配");
+        }
+    }
+
+    void ContainerView::checkKey(const std::type_info &type) const
+    {
+        if (!ops_->associative || type != keyType())
+        {
+            throw std::invalid_argument("ContainerView: 键类型不匹配");
+        }
+    }
+
+    void ContainerView::checkSequence() const
+    {
+        if (ops_->associative)
+        {
+            throw std::invalid_argument("ContainerView: 关联容器请使用 forEachEntry 遍历");
+        }
+    }
+
+    void ContainerView::checkWritable() const
+    {
+        if (!writable_)
+        {
+            throw std::invalid_argument("ContainerView: 只读视图不能修改容器");
+        }
+    }
+
+} // namespace Evently
@@ -0,0 +1,164 @@
+#ifndef CONTAINER_VIEW_H
+#define CONTAINER_VIEW_H
+#pragma once
+
+#include "Any.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <typeinfo>
+
+namespace Evently
+{
+
+    /**
+     * @brief 容器字段的非拥有视图
+     *
+     * 直接引用实例中的容器，读取、遍历、修改都作用于原容器，不拷贝容器。
+     * 视图不延长容器的生命周期；容器被销毁或重新分配后（如 vector 扩容），
+     * 之前取得的元素引用随之失效，视图本身仍可继续使用。
+     *
+     * @code
+     * ContainerView items = registry.containerField("Order", "items", &order);
+     * items.forEach<LineItem>([](const LineItem &item) { ... });
+     * items.append(LineItem());
+     * @endcode
+     */
+    class ContainerView
+    {
+    public:
+        /**
+         * @brief 在类型为 ops 的容器上建立视图
+         * @throws std::invalid_argument ops 不是支持的容器类型
+         */
+        ContainerView(const TypeOps &ops, const void *container, bool writable);
+
+        bool writable() const { return writable_; }
+        bool associative() const { return ops_->associative; }
+        /// 是否支持下标访问（vector、deque、array）
+        bool indexable() const { return ops_->at != nullptr; }
+
+        const TypeOps &containerOps() const { return *type_; }
+        /// 元素类型（关联容器为映射值类型）
+        const std::type_info &elementType() const { return *ops_->elementOps().type; }
+        /// 键类型（顺序容器为 void）
+        const std::type_info &keyType() const { return *ops_->keyOps().type; }
+
+        std::size_t size() const { return ops_->size(container_); }
+        bool empty() const { return size() == 0; }
+
+        /**
+         * @brief 第 index 个元素的引用（检查类型和越界）
+         * @throws std::out_of_range 越界；std::invalid_argument 类型不匹配或不支持下标
+         */
+        template <typename T>
+        const T &at(std::size_t index) const
+        {
+            checkElement(typeid(T));
+            return *static_cast<const T *>(elementAt(index));
+        }
+
+        /// 可修改的元素引用（只读视图抛出 std::invalid_argument）
+        template <typename T>
+        T &mutableAt(std::size_t index)
+        {
+            checkElement(typeid(T));
+            checkWritable();
+            return *static_cast<T *>(const_cast<void *>(elementAt(index)));
+        }
+
+        /// 把第 index 个元素拷贝到 Any
+        Any get(std::size_t index) const;
+        /// 用 Any 中的值覆盖第 index 个元素
+        void set(std::size_t index, const Any &value);
+
+        template <typename T>
+        void append(const T &value)
+        {
+            checkElement(typeid(T));
+            appendRaw(&value);
+        }
+
+        void append(const Any &value);
+
+        /// 关联容器按键查找，不存在时返回 nullptr
+        template <typename V, typename K>
+        const V *find(const K &key) const
+        {
+            checkKey(typeid(K));
+            checkElement(typeid(V));
+            return static_cast<const V *>(findRaw(&key));
+        }
+
+        /// 关联容器按键查找并拷贝到 Any，不存在时返回空 Any
+        Any find(const Any &key) const;
+
+        /// 关联容器插入或覆盖
+        template <typename K, typename V>
+        void insert(const K &key, const V &value)
+        {
+            checkKey(typeid(K));
+            checkElement(typeid(V));
+            insertRaw(&key, &value);
+        }
+
+        void insert(const Any &key, const Any &value);
+
+        void clear();
+
+        /**
+         * @brief 按容器顺序遍历元素（不拷贝）
+         *
+         * 顺序容器调用 visitor(const T &element)；元素类型在遍历前检查一次。
+         */
+        template <typename T, typename Visitor>
+        void forEach(Visitor visitor) const
+        {
+            checkElement(typeid(T));
+            checkSequence();
+            ops_->forEach(container_, &visitElement<T, Visitor>, &visitor);
+        }
+
+        /// 遍历关联容器，调用 visitor(const K &key, const V &value)
+        template <typename K, typename V, typename Visitor>
+        void forEachEntry(Visitor visitor) const
+        {
+            checkKey(typeid(K));
+            checkElement(typeid(V));
+            ops_->forEach(container_, &visitEntry<K, V, Visitor>, &visitor);
+        }
+
+        /// 类型擦除的遍历：key 对顺序容器为 nullptr
+        void forEachRaw(ContainerOps::Visitor visit, void *context) const;
+
+    private:
+        template <typename T, typename Visitor>
+        static void visitElement(void *context, const void *, const void *element)
+        {
+            (*static_cast<Visitor *>(context))(*static_cast<const T *>(element));
+        }
+
+        template <typename K, typename V, typename Visitor>
+        static void visitEntry(void *context, const void *key, const void *element)
+        {
+            (*static_cast<Visitor *>(context))(*static_cast<const K *>(key), *static_cast<const V *>(element));
+        }
+
+        const void *elementAt(std::size_t index) const;
+        void appendRaw(const void *element);
+        const void *findRaw(const void *key) const;
+        void insertRaw(const void *key, const void *element);
+
+        void checkElement(const std::type_info &type) const;
+        void checkKey(const std::type_info &type) const;
+        void checkSequence() const;
+        void checkWritable() const;
+
+        const TypeOps *type_;
+        const ContainerOps *ops_;
+        const void *container_;
+        bool writable_;
+    };
+
+} // namespace Evently
+
+#endif // CONTAINER_VIEW_H
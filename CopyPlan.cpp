@@ -0,0 +1,118 @@
+#include "CopyPlan.h"
+#include "MemberTable.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    namespace
+    {
+        struct FieldSlot
+        {
+            std::size_t offset;
+            const TypeOps *ops;
+
+            bool operator<(const FieldSlot &other) const { return offset < other.offset; }
+        };
+    } // namespace
+
+    CopyPlan::CopyPlan(const ReflectionRegistry &registry, const std::string &className, const void *sample)
+        : fieldCount_(0)
+    {
+        if (sample == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const MemberTable *table = registry.memberTable(className);
+        if (table == nullptr || table->fieldCount() == 0)
+        {
+            throw std::runtime_error("类没有注册字段: " + className);
+        }
+
+        std::vector<FieldSlot> slots;
+        for (std::size_t i = 0; i < table->fieldCount(); ++i)
+        {
+            const FieldThunk &field = table->field(i);
+            if (!field.writable())
+            {
+                continue;
+            }
+            if (!field.ops->trivial && field.ops->assign == nullptr)
+            {
+                throw std::invalid_argument("字段不可拷贝赋值: " + className + "::" + table->fieldName(i));
+            }
+            FieldSlot slot = {static_cast<std::size_t>(static_cast<const char *>(field.fieldAddress(sample)) -
+                                                       static_cast<const char *>(sample)),
+                              field.ops};
+            slots.push_back(slot);
+        }
+        std::stable_sort(slots.begin(), slots.end());
+
+        std::size_t end = 0;
+        for (const auto &slot : slots)
+        {
+            // 同一成员以多个名字注册时偏移相同，只拷贝一次
+            if (fieldCount_ != 0 && slot.offset < end)
+            {
+                continue;
+            }
+            ++fieldCount_;
+            end = slot.offset + slot.ops->size;
+            if (slot.ops->trivial)
+            {
+                // 只合并首尾相接的字段：中间的填充可能放着未注册的成员
+                if (!steps_.empty() && steps_.back().assign == nullptr &&
+                    steps_.back().offset + steps_.back().size == slot.offset)
+                {
+                    steps_.back().size += slot.ops->size;
+                    continue;
+                }
+                Step step = {slot.offset, slot.ops->size, nullptr};
+                steps_.push_back(step);
+            }
+            else
+            {
+                Step step = {slot.offset, slot.ops->size, slot.ops->assign};
+                steps_.push_back(step);
+            }
+        }
+    }
+
+    void CopyPlan::copy(void *dst, const void *src) const
+    {
+        if (dst == nullptr || src == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        if (dst == src)
+        {
+            return;
+        }
+        char *target = static_cast<char *>(dst);
+        const char *source = static_cast<const char *>(src);
+        for (const auto &step : steps_)
+        {
+            if (step.assign == nullptr)
+            {
+                std::memcpy(target + step.offset, source + step.offset, step.size);
+            }
+            else
+            {
+                step.assign(target + step.offset, source + step.offset);
+            }
+        }
+    }
+
+    std::size_t CopyPlan::memcpyCount() const
+    {
+        std::size_t count = 0;
+        for (const auto &step : steps_)
+        {
+            count += step.assign == nullptr;
+        }
+        return count;
+    }
+
+} // namespace Evently
@@ -0,0 +1,60 @@
+#ifndef COPY_PLAN_H
+#define COPY_PLAN_H
+#pragma once
+
+#include "Reflection.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 编译后的对象拷贝：按字段偏移排序的拷贝步骤
+     *
+     * 地址相邻的平凡可拷贝字段合并为一次 memcpy，其余字段用自身的拷贝赋值。
+     * 只拷贝注册过的可写字段（含继承字段）；const 字段和未注册的成员保持目标对象原值。
+     * 字段偏移在构建时由一个已有实例（sample）求出，同一类的所有实例偏移相同。
+     *
+     * @code
+     * CopyPlan plan(registry, "Person", &people[0]);
+     * for (std::size_t i = 0; i < people.size(); ++i)
+     * {
+     *     plan.copy(&copies[i], &people[i]);
+     * }
+     * @endcode
+     */
+    class CopyPlan
+    {
+    public:
+        /**
+         * @throws std::runtime_error 类没有注册字段；std::invalid_argument 某个字段不可拷贝赋值
+         */
+        CopyPlan(const ReflectionRegistry &registry, const std::string &className, const void *sample);
+
+        /// 把 src 的字段拷贝到 dst（两者须是构建时的类的实例）
+        void copy(void *dst, const void *src) const;
+
+        /// 参与拷贝的字段数（同一成员以多个名字注册时只计一次）
+        std::size_t fieldCount() const { return fieldCount_; }
+
+        /// 拷贝步骤数，其中 memcpyCount() 个是合并后的 memcpy
+        std::size_t stepCount() const { return steps_.size(); }
+        std::size_t memcpyCount() const;
+
+    private:
+        struct Step
+        {
+            std::size_t offset;
+            std::size_t size;
+            void (*assign)(void *dst, const void *src); ///< nullptr 表示 memcpy
+        };
+
+        std::vector<Step> steps_;
+        std::size_t fieldCount_;
+    };
+
+} // namespace Evently
+
+#endif // COPY_PLAN_H
@@ -0,0 +1,964 @@
+#include "CsvTable.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    namespace
+    {
+        const char *skipSpaces(const char *begin, const char *end)
+        {
+            while (begin < end && (*begin == ' ' || *begin == '\t'))
+            {
+                ++begin;
+            }
+            return begin;
+        }
+
+        const char *trimSpaces(const char *begin, const char *end)
+        {
+            while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+            {
+                --end;
+            }
+            return end;
+        }
+
+        /// 解析十进制整数的绝对值，溢出或含非数字时返回 false
+        bool parseDigits(const char *begin, const char *end, unsigned long long &value)
+        {
+            if (begin == end)
+            {
+                return false;
+            }
+            value = 0;
+            for (; begin < end; ++begin)
+            {
+                const unsigned digit = static_cast<unsigned>(*begin - '0');
+                if (digit > 9 || value > (std::numeric_limits<unsigned long long>::max() - digit) / 10)
+                {
+                    return false;
+                }
+                value = value * 10 + digit;
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool parseSigned(const char *begin, const char *end, void *field)
+        {
+            begin = skipSpaces(begin, end);
+            end = trimSpaces(begin, end);
+            if (begin == end)
+            {
+                return true; // 空值保持字段默认值
+            }
+            const bool negative = *begin == '-';
+            if (*begin == '-' || *begin == '+')
+            {
+                ++begin;
+            }
+            unsigned long long magnitude;
+            if (!parseDigits(begin, end, magnitude))
+            {
+                return false;
+            }
+            const unsigned long long limit =
+                negative ? static_cast<unsigned long long>(std::numeric_limits<T>::max()) + 1
+                         : static_cast<unsigned long long>(std::numeric_limits<T>::max());
+            if (magnitude > limit)
+            {
+                return false;
+            }
+            // 先取反再转换：最小值的绝对值超出 T 的范围
+            *static_cast<T *>(field) =
+                negative ? static_cast<T>(-static_cast<long long>(magnitude - 1) - 1) : static_cast<T>(magnitude);
+            return true;
+        }
+
+        template <typename T>
+        bool parseUnsigned(const char *begin, const char *end, void *field)
+        {
+            begin = skipSpaces(begin, end);
+            end = trimSpaces(begin, end);
+            if (begin == end)
+            {
+                return true;
+            }
+            if (*begin == '+')
+            {
+                ++begin;
+            }
+            unsigned long long value;
+            if (!parseDigits(begin, end, value) || value > std::numeric_limits<T>::max())
+            {
+                return false;
+            }
+            *static_cast<T *>(field) = static_cast<T>(value);
+            return true;
+        }
+
+        bool parseBool(const char *begin, const char *end, void *field)
+        {
+            begin = skipSpaces(begin, end);
+            end = trimSpaces(begin, end);
+            std::string text(begin, end);
+            for (auto &c : text)
+            {
+                c = static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+            }
+            if (text.empty())
+            {
+                return true;
+            }
+            if (text == "1" || text == "true")
+            {
+                *static_cast<bool *>(field) = true;
+                return true;
+            }
+            if (text == "0" || text == "false")
+            {
+                *static_cast<bool *>(field) = false;
+                return true;
+            }
+            return false;
+        }
+
+        /// char 字段按字符读写；signed char / unsigned char 按小整数读写
+        bool parseChar(const char *begin, const char *end, void *field)
+        {
+            if (end - begin > 1)
+            {
+                return false;
+            }
+            *static_cast<char *>(field) = begin == end ? '\0' : *begin;
+            return true;
+        }
+
+        /**
+         * @brief 浮点数：有效数字不超过 2^53 且十进制指数在 ±22 内时一次乘除即得精确结果，
+         * 其余情况（含 inf、nan、十六进制）交给 strtod
+         */
+        bool parseDouble(const char *begin, const char *end, double &value)
+        {
+            static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            const char *p = begin;
+            const bool negative = p < end && *p == '-';
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                ++p;
+            }
+            unsigned long long mantissa = 0;
+            int digits = 0;
+            int exponent = 0;
+            bool any = false;
+            for (; p < end && static_cast<unsigned>(*p - '0') <= 9; ++p, any = true)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                digits += mantissa != 0;
+            }
+            if (p < end && *p == '.')
+            {
+                for (++p; p < end && static_cast<unsigned>(*p - '0') <= 9; ++p, any = true)
+                {
+                    mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                    digits += mantissa != 0;
+                    --exponent;
+                }
+            }
+            if (any && p < end && (*p == 'e' || *p == 'E'))
+            {
+                const char *e = p + 1;
+                const bool negativeExponent = e < end && *e == '-';
+                if (e < end && (*e == '-' || *e == '+'))
+                {
+                    ++e;
+                }
+                int written = 0;
+                bool exponentDigits = false;
+                for (; e < end && static_cast<unsigned>(*e - '0') <= 9 && written < 10000; ++e)
+                {
+                    written = written * 10 + (*e - '0');
+                    exponentDigits = true;
+                }
+                if (exponentDigits)
+                {
+                    exponent += negativeExponent ? -written : written;
+                    p = e;
+                }
+            }
+            if (any && p == end && digits <= 19 && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+            {
+                double result = static_cast<double>(mantissa);
+                result = exponent < 0 ? result / powers[-exponent] : result * powers[exponent];
+                value = negative ? -result : result;
+                return true;
+            }
+
+            std::string text(begin, end);
+            char *stop = nullptr;
+            value = std::strtod(text.c_str(), &stop);
+            return !text.empty() && stop == text.c_str() + text.size();
+        }
+
+        template <typename T>
+        bool parseFloating(const char *begin, const char *end, void *field)
+        {
+            begin = skipSpaces(begin, end);
+            end = trimSpaces(begin, end);
+            if (begin == end)
+            {
+                return true;
+            }
+            double value;
+            if (!parseDouble(begin, end, value))
+            {
+                return false;
+            }
+            *static_cast<T *>(field) = static_cast<T>(value);
+            return true;
+        }
+
+        bool parseString(const char *begin, const char *end, void *field)
+        {
+            static_cast<std::string *>(field)->assign(begin, end);
+            return true;
+        }
+
+        void formatUnsigned(unsigned long long value, std::string &out)
+        {
+            char buffer[24];
+            char *p = buffer + sizeof(buffer);
+            do
+            {
+                *--p = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            out.append(p, buffer + sizeof(buffer));
+        }
+
+        template <typename T>
+        void formatSigned(const void *field, std::string &out)
+        {
+            const long long value = static_cast<long long>(*static_cast<const T *>(field));
+            if (value < 0)
+            {
+                out.push_back('-');
+                formatUnsigned(0ULL - static_cast<unsigned long long>(value), out);
+            }
+            else
+            {
+                formatUnsigned(static_cast<unsigned long long>(value), out);
+            }
+        }
+
+        template <typename T>
+        void formatUnsignedField(const void *field, std::string &out)
+        {
+            formatUnsigned(static_cast<unsigned long long>(*static_cast<const T *>(field)), out);
+        }
+
+        void formatBool(const void *field, std::string &out)
+        {
+            out += *static_cast<const bool *>(field) ? "true" : "false";
+        }
+
+        void formatChar(const void *field, std::string &out)
+        {
+            const char c = *static_cast<const char *>(field);
+            if (c != '\0')
+            {
+                out.push_back(c);
+            }
+        }
+
+        /**
+         * @brief 浮点数的最短常见写法
+         *
+         * 先找最少的小数位 k（不超过 7）使 m / 10^k 恰好还原原值，与解析的快速路径一致，
+         * 直接输出整数 m 并插入小数点；否则用 snprintf 输出 15 位或 17 位有效数字。
+         */
+        template <typename T>
+        void formatFloating(const void *field, std::string &out)
+        {
+            static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7};
+            const T original = *static_cast<const T *>(field);
+            const double value = static_cast<double>(original);
+            const double magnitude = value < 0 ? -value : value;
+            if (magnitude < 1e15)
+            {
+                for (int k = 0; k < 8 && magnitude * powers[k] < 9e15; ++k)
+                {
+                    const double scaled = magnitude * powers[k] + 0.5;
+                    const unsigned long long m = static_cast<unsigned long long>(scaled);
+                    if (static_cast<T>(static_cast<double>(m) / powers[k]) != static_cast<T>(magnitude))
+                    {
+                        continue;
+                    }
+                    if (value < 0 && m != 0)
+                    {
+                        out.push_back('-');
+                    }
+                    const std::size_t start = out.size();
+                    formatUnsigned(m, out);
+                    if (k > 0)
+                    {
+                        // 不足 k + 1 位时补前导 0，再在倒数第 k 位前插入小数点
+                        std::size_t digits = out.size() - start;
+                        if (digits <= static_cast<std::size_t>(k))
+                        {
+                            out.insert(start, static_cast<std::size_t>(k) + 1 - digits, '0');
+                        }
+                        out.insert(out.end() - k, '.');
+                    }
+                    return;
+                }
+            }
+
+            char buffer[40];
+            int length = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+            double readBack;
+            if (!parseDouble(buffer, buffer + length, readBack) || static_cast<T>(readBack) != original)
+            {
+                length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+            }
+            out.append(buffer, static_cast<std::size_t>(length));
+        }
+
+        void formatString(const void *field, std::string &out)
+        {
+            out += *static_cast<const std::string *>(field);
+        }
+
+        bool parseEnum(const EnumInfo &info, const char *begin, const char *end, void *field)
+        {
+            long long value;
+            if (!info.parse(begin, end, value))
+            {
+                return false;
+            }
+            info.write(field, value);
+            return true;
+        }
+
+        /// 按字段的值类型选择解析和格式化函数；不支持的类型返回 false
+        bool bindColumn(ValueKind kind, CsvColumn &column)
+        {
+            switch (kind)
+            {
+            case ValueKind::Bool:
+                column.parse = &parseBool;
+                column.format = &formatBool;
+                return true;
+            case ValueKind::Char:
+                column.parse = &parseChar;
+                column.format = &formatChar;
+                return true;
+            case ValueKind::SignedChar:
+                column.parse = &parseSigned<signed char>;
+                column.format = &formatSigned<signed char>;
+                return true;
+            case ValueKind::UnsignedChar:
+                column.parse = &parseUnsigned<unsigned char>;
+                column.format = &formatUnsignedField<unsigned char>;
+                return true;
+            case ValueKind::Short:
+                column.parse = &parseSigned<short>;
+                column.format = &formatSigned<short>;
+                return true;
+            case ValueKind::UnsignedShort:
+                column.parse = &parseUnsigned<unsigned short>;
+                column.format = &formatUnsignedField<unsigned short>;
+                return true;
+            case ValueKind::Int:
+                column.parse = &parseSigned<int>;
+                column.format = &formatSigned<int>;
+                return true;
+            case ValueKind::UnsignedInt:
+                column.parse = &parseUnsigned<unsigned int>;
+                column.format = &formatUnsignedField<unsigned int>;
+                return true;
+            case ValueKind::Long:
+                column.parse = &parseSigned<long>;
+                column.format = &formatSigned<long>;
+                return true;
+            case ValueKind::UnsignedLong:
+                column.parse = &parseUnsigned<unsigned long>;
+                column.format = &formatUnsignedField<unsigned long>;
+                return true;
+            case ValueKind::LongLong:
+                column.parse = &parseSigned<long long>;
+                column.format = &formatSigned<long long>;
+                return true;
+            case ValueKind::UnsignedLongLong:
+                column.parse = &parseUnsigned<unsigned long long>;
+                column.format = &formatUnsignedField<unsigned long long>;
+                return true;
+            case ValueKind::Float:
+                column.parse = &parseFloating<float>;
+                column.format = &formatFloating<float>;
+                return true;
+            case ValueKind::Double:
+                column.parse = &parseFloating<double>;
+                column.format = &formatFloating<double>;
+                return true;
+            case ValueKind::LongDouble:
+                column.parse = &parseFloating<long double>;
+                column.format = &formatFloating<long double>;
+                return true;
+            case ValueKind::String:
+                column.parse = &parseString;
+                column.format = &formatString;
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /// 类的全部常用类型字段（按注册顺序，同一成员的多个名字各成一列）
+        std::vector<CsvColumn> bindFields(const ReflectionRegistry &registry, const std::string &className,
+                                          bool writableOnly)
+        {
+            const MemberTable *table = registry.memberTable(className);
+            if (table == nullptr || table->fieldCount() == 0)
+            {
+                throw std::runtime_error("类没有注册字段: " + className);
+            }
+            std::vector<CsvColumn> columns;
+            for (std::size_t i = 0; i < table->fieldCount(); ++i)
+            {
+                CsvColumn column;
+                column.name = table->fieldName(i);
+                column.field = table->field(i);
+                column.parse = nullptr;
+                column.format = nullptr;
+                column.enumType = column.field.ops->enumInfo != nullptr ? column.field.ops->enumInfo() : nullptr;
+                if ((!writableOnly || column.field.writable()) &&
+                    (column.enumType != nullptr || bindColumn(column.field.ops->kind, column)))
+                {
+                    columns.push_back(column);
+                }
+            }
+            return columns;
+        }
+
+        /**
+         * @brief 找到下一行：引号外的换行结束一行
+         *
+         * rowEnd 是行内容的末尾（不含换行和行尾的 \r），返回下一行的开头。
+         */
+        const char *nextRow(const char *p, const char *end, char quote, const char *&rowEnd)
+        {
+            bool quoted = false;
+            const char *row = p;
+            for (; p < end; ++p)
+            {
+                const char c = *p;
+                if (c == quote)
+                {
+                    quoted = !quoted;
+                }
+                else if (c == '\n' && !quoted)
+                {
+                    rowEnd = p > row && p[-1] == '\r' ? p - 1 : p;
+                    return p + 1;
+                }
+            }
+            if (quoted)
+            {
+                throw std::invalid_argument("CSV 中的引号不成对");
+            }
+            rowEnd = p > row && p[-1] == '\r' ? p - 1 : p;
+            return end;
+        }
+
+        /// 一段字节的引号统计：引号个数的奇偶，以及按两种起始状态各自遇到的第一个引号外换行
+        struct Segment
+        {
+            const char *begin;
+            const char *end;
+            bool oddQuotes;
+            const char *firstBreak[2]; ///< [起始在引号外, 起始在引号内]，没有时为 nullptr
+        };
+
+        void scanSegment(Segment &segment, char quote)
+        {
+            bool odd = false;
+            segment.firstBreak[0] = nullptr;
+            segment.firstBreak[1] = nullptr;
+            for (const char *p = segment.begin; p < segment.end; ++p)
+            {
+                if (*p == quote)
+                {
+                    odd = !odd;
+                }
+                else if (*p == '\n')
+                {
+                    // 起始状态为 s 时，此处在引号外当且仅当段内已见的引号奇偶等于 s
+                    const char *&slot = segment.firstBreak[odd ? 1 : 0];
+                    if (slot == nullptr)
+                    {
+                        slot = p + 1;
+                    }
+                }
+            }
+            segment.oddQuotes = odd;
+        }
+
+        std::size_t grainFor(const ThreadPool &pool, std::size_t count)
+        {
+            std::size_t grain = (count + pool.workerCount() * 4 - 1) / (pool.workerCount() * 4);
+            return grain == 0 ? 1 : grain;
+        }
+    } // namespace
+
+    CsvReader::CsvReader(const ReflectionRegistry &registry, const std::string &className, const CsvFormat &format)
+        : registry_(registry), className_(className), format_(format),
+          fields_(bindFields(registry, className, true)), parallel_(true)
+    {
+        if (format.delimiter == format.quote || format.delimiter == '\n' || format.quote == '\n')
+        {
+            throw std::invalid_argument("分隔符、引号和换行必须互不相同");
+        }
+    }
+
+    CsvReader &CsvReader::parallel(bool enabled)
+    {
+        parallel_ = enabled;
+        return *this;
+    }
+
+    CsvReader::Layout CsvReader::prepare(const char *data, std::size_t size) const
+    {
+        Layout layout;
+        layout.rowCount = 0;
+        layout.parallel = parallel_ && size >= parallelThreshold;
+        const char *begin = data;
+        const char *end = data + size;
+
+        // 表头：列名与字段对应一次；没有表头时按注册顺序
+        if (format_.header)
+        {
+            const char *rowEnd;
+            const char *next = nextRow(begin, end, format_.quote, rowEnd);
+            const char *p = begin;
+            while (p <= rowEnd && begin != rowEnd)
+            {
+                const char *cell = p;
+                while (p < rowEnd && *p != format_.delimiter)
+                {
+                    ++p;
+                }
+                const char *cellEnd = p;
+                if (cellEnd - cell >= 2 && *cell == format_.quote && cellEnd[-1] == format_.quote)
+                {
+                    ++cell;
+                    --cellEnd;
+                }
+                const std::string name(skipSpaces(cell, cellEnd), trimSpaces(cell, cellEnd));
+                const CsvColumn *column = nullptr;
+                for (const auto &field : fields_)
+                {
+                    if (field.name == name)
+                    {
+                        column = &field;
+                        break;
+                    }
+                }
+                layout.columns.push_back(column);
+                ++p;
+            }
+            begin = next;
+        }
+        else
+        {
+            for (const auto &field : fields_)
+            {
+                layout.columns.push_back(&field);
+            }
+        }
+
+        // 分块边界：引号外的换行。并行时先按字节等分，各段独立统计后再串行传递引号奇偶
+        std::vector<const char *> bounds(1, begin);
+        if (layout.parallel)
+        {
+            const std::shared_ptr<ThreadPool> pool = registry_.asyncPool();
+            const std::size_t segmentCount = pool->workerCount() * 4;
+            const std::size_t length = static_cast<std::size_t>(end - begin);
+            std::vector<Segment> segments(segmentCount);
+            for (std::size_t i = 0; i < segmentCount; ++i)
+            {
+                segments[i].begin = begin + length * i / segmentCount;
+                segments[i].end = begin + length * (i + 1) / segmentCount;
+            }
+            pool->parallelFor(segmentCount, 1, [&](std::size_t first, std::size_t last)
+                             {
+                                 for (std::size_t i = first; i < last; ++i)
+                                 {
+                                     scanSegment(segments[i], format_.quote);
+                                 }
+                             });
+            bool quoted = false;
+            for (std::size_t i = 0; i < segmentCount; ++i)
+            {
+                if (i > 0)
+                {
+                    const char *bound = segments[i].firstBreak[quoted ? 1 : 0];
+                    if (bound != nullptr && bound > bounds.back() && bound < end)
+                    {
+                        bounds.push_back(bound);
+                    }
+                }
+                quoted = quoted != segments[i].oddQuotes;
+            }
+        }
+        bounds.push_back(end);
+
+        // 各分块的行数（跳过空行），用于预先分配对象和确定每块的起始行号
+        layout.chunks.resize(bounds.size() - 1);
+        const char quote = format_.quote;
+        auto countRows = [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                Chunk &chunk = layout.chunks[i];
+                chunk.begin = bounds[i];
+                chunk.end = bounds[i + 1];
+                chunk.rows = 0;
+                for (const char *p = chunk.begin; p < chunk.end;)
+                {
+                    const char *rowEnd;
+                    const char *next = nextRow(p, chunk.end, quote, rowEnd);
+                    chunk.rows += rowEnd != p;
+                    p = next;
+                }
+            }
+        };
+        if (layout.parallel)
+        {
+            registry_.asyncPool()->parallelFor(layout.chunks.size(), 1, countRows);
+        }
+        else
+        {
+            countRows(0, layout.chunks.size());
+        }
+        for (auto &chunk : layout.chunks)
+        {
+            chunk.firstRow = layout.rowCount;
+            layout.rowCount += chunk.rows;
+        }
+        return layout;
+    }
+
+    void CsvReader::parse(const Layout &layout, void *objects, std::size_t stride) const
+    {
+        if (layout.rowCount == 0)
+        {
+            return;
+        }
+        char *base = static_cast<char *>(objects);
+        std::vector<std::size_t> offsets;
+        for (const CsvColumn *column : layout.columns)
+        {
+            offsets.push_back(column == nullptr ? 0
+                                                : static_cast<std::size_t>(static_cast<const char *>(
+                                                                               column->field.fieldAddress(base)) -
+                                                                           base));
+        }
+        if (!layout.parallel)
+        {
+            for (const auto &chunk : layout.chunks)
+            {
+                parseChunk(layout, chunk, base, stride, offsets);
+            }
+            return;
+        }
+        registry_.asyncPool()->parallelFor(layout.chunks.size(), 1, [&](std::size_t first, std::size_t last)
+                                           {
+                                               for (std::size_t i = first; i < last; ++i)
+                                               {
+                                                   parseChunk(layout, layout.chunks[i], base, stride, offsets);
+                                               }
+                                           });
+    }
+
+    void CsvReader::parseChunk(const Layout &layout, const Chunk &chunk, char *base, std::size_t stride,
+                               const std::vector<std::size_t> &offsets) const
+    {
+        const char delimiter = format_.delimiter;
+        const char quote = format_.quote;
+        const std::size_t columnCount = layout.columns.size();
+        std::string unescaped;
+        std::size_t row = chunk.firstRow;
+
+        for (const char *p = chunk.begin; p < chunk.end;)
+        {
+            const char *rowEnd;
+            const char *next = nextRow(p, chunk.end, quote, rowEnd);
+            if (rowEnd == p)
+            {
+                p = next;
+                continue;
+            }
+            char *object = base + row * stride;
+            std::size_t column = 0;
+            const char *cell = p;
+            for (;;)
+            {
+                const char *valueBegin;
+                const char *valueEnd;
+                const char *cellEnd;
+                if (cell < rowEnd && *cell == quote)
+                {
+                    // 带引号的值：两个连续引号表示一个引号字符
+                    const char *q = cell + 1;
+                    bool escaped = false;
+                    while (q < rowEnd && (*q != quote || (q + 1 < rowEnd && q[1] == quote)))
+                    {
+                        if (*q == quote)
+                        {
+                            escaped = true;
+                            ++q;
+                        }
+                        ++q;
+                    }
+                    valueBegin = cell + 1;
+                    valueEnd = q;
+                    if (escaped)
+                    {
+                        unescaped.clear();
+                        for (const char *c = valueBegin; c < valueEnd; ++c)
+                        {
+                            unescaped.push_back(*c);
+                            c += *c == quote;
+                        }
+                        valueBegin = unescaped.data();
+                        valueEnd = valueBegin + unescaped.size();
+                    }
+                    cellEnd = static_cast<const char *>(
+                        std::memchr(q, delimiter, static_cast<std::size_t>(rowEnd - q)));
+                }
+                else
+                {
+                    cellEnd = static_cast<const char *>(
+                        std::memchr(cell, delimiter, static_cast<std::size_t>(rowEnd - cell)));
+                    valueBegin = cell;
+                    valueEnd = cellEnd != nullptr ? cellEnd : rowEnd;
+                }
+
+                if (column < columnCount && layout.columns[column] != nullptr)
+                {
+                    const CsvColumn &target = *layout.columns[column];
+                    if (!(target.enumType != nullptr
+                              ? parseEnum(*target.enumType, valueBegin, valueEnd, object + offsets[column])
+                              : target.parse(valueBegin, valueEnd, object + offsets[column])))
+                    {
+                        throw std::invalid_argument("CSV 第 " + std::to_string(row + 1) + " 条记录的字段 " +
+                                                    target.name + " 无法解析: " +
+                                                    std::string(valueBegin, valueEnd));
+                    }
+                }
+                if (cellEnd == nullptr)
+                {
+                    break;
+                }
+                cell = cellEnd + 1;
+                ++column;
+            }
+            ++row;
+            p = next;
+        }
+    }
+
+    std::string CsvReader::loadFile(const std::string &path)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("无法打开文件: " + path);
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    CsvWriter::CsvWriter(const ReflectionRegistry &registry, const std::string &className, const CsvFormat &format)
+        : registry_(registry), format_(format), columns_(bindFields(registry, className, false)), parallel_(true)
+    {
+    }
+
+    CsvWriter::CsvWriter(const ReflectionRegistry &registry, const std::string &className,
+                         const std::vector<std::string> &fieldNames, const CsvFormat &format)
+        : registry_(registry), format_(format), parallel_(true)
+    {
+        std::vector<CsvColumn> fields = bindFields(registry, className, false);
+        for (const auto &name : fieldNames)
+        {
+            auto it = std::find_if(fields.begin(), fields.end(),
+                                   [&name](const CsvColumn &column)
+                                   { return column.name == name; });
+            if (it == fields.end())
+            {
+                throw std::invalid_argument("字段不存在或类型不支持 CSV: " + className + "::" + name);
+            }
+            columns_.push_back(*it);
+        }
+    }
+
+    CsvWriter &CsvWriter::parallel(bool enabled)
+    {
+        parallel_ = enabled;
+        return *this;
+    }
+
+    void CsvWriter::appendText(const std::string &text, std::string &out) const
+    {
+        const char special[] = {format_.delimiter, format_.quote, '\n', '\r', '\0'};
+        if (text.find_first_of(special) == std::string::npos)
+        {
+            out += text;
+            return;
+        }
+        out.push_back(format_.quote);
+        for (char c : text)
+        {
+            if (c == format_.quote)
+            {
+                out.push_back(c);
+            }
+            out.push_back(c);
+        }
+        out.push_back(format_.quote);
+    }
+
+    void CsvWriter::formatRows(const char *base, std::size_t begin, std::size_t end, std::size_t stride,
+                               const std::vector<std::size_t> &offsets, std::string &out) const
+    {
+        std::string text;
+        for (std::size_t row = begin; row < end; ++row)
+        {
+            const char *object = base + row * stride;
+            for (std::size_t c = 0; c < columns_.size(); ++c)
+            {
+                if (c != 0)
+                {
+                    out.push_back(format_.delimiter);
+                }
+                const CsvColumn &column = columns_[c];
+                const ValueKind kind = column.field.ops->kind;
+                if (column.enumType != nullptr)
+                {
+                    // 枚举名可能含分隔符（如位标志的 |），按文本处理
+                    text.clear();
+                    column.enumType->appendTo(column.enumType->read(object + offsets[c]), text);
+                    appendText(text, out);
+                }
+                else if (kind == ValueKind::String || kind == ValueKind::Char)
+                {
+                    // 文本可能含分隔符、引号或换行，需要加引号
+                    text.clear();
+                    column.format(object + offsets[c], text);
+                    appendText(text, out);
+                }
+                else
+                {
+                    column.format(object + offsets[c], out);
+                }
+            }
+            out.push_back('\n');
+        }
+    }
+
+    void CsvWriter::write(std::ostream &out, const void *objects, std::size_t count, std::size_t stride) const
+    {
+        std::string buffer;
+        if (format_.header)
+        {
+            for (std::size_t c = 0; c < columns_.size(); ++c)
+            {
+                if (c != 0)
+                {
+                    buffer.push_back(format_.delimiter);
+                }
+                appendText(columns_[c].name, buffer);
+            }
+            buffer.push_back('\n');
+        }
+        if (count == 0)
+        {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            return;
+        }
+        if (objects == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+
+        const char *base = static_cast<const char *>(objects);
+        std::vector<std::size_t> offsets;
+        for (const auto &column : columns_)
+        {
+            offsets.push_back(static_cast<std::size_t>(static_cast<const char *>(column.field.fieldAddress(base)) - base));
+        }
+
+        if (!parallel_ || count < 2 * blockRows)
+        {
+            // 串行：攒到约 1 MB 再写出
+            const std::size_t flushBytes = 1 << 20;
+            for (std::size_t row = 0; row < count; row += 1024)
+            {
+                formatRows(base, row, std::min(row + 1024, count), stride, offsets, buffer);
+                if (buffer.size() >= flushBytes)
+                {
+                    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                    buffer.clear();
+                }
+            }
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            return;
+        }
+
+        // 并行：每批若干块同时格式化，再按顺序写出，内存占用限于一批
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::shared_ptr<ThreadPool> pool = registry_.asyncPool();
+        const std::size_t blocksPerBatch = pool->workerCount() * 2;
+        std::vector<std::string> blocks(blocksPerBatch);
+        for (std::size_t first = 0; first < count; first += blocksPerBatch * blockRows)
+        {
+            const std::size_t batchBlocks =
+                std::min(blocksPerBatch, (count - first + blockRows - 1) / blockRows);
+            pool->parallelFor(batchBlocks, grainFor(*pool, batchBlocks), [&](std::size_t begin, std::size_t end)
+                             {
+                                 for (std::size_t b = begin; b < end; ++b)
+                                 {
+                                     const std::size_t row = first + b * blockRows;
+                                     blocks[b].clear();
+                                     formatRows(base, row, std::min(row + blockRows, count), stride, offsets,
+                                                blocks[b]);
+                                 }
+                             });
+            for (std::size_t b = 0; b < batchBlocks; ++b)
+            {
+                out.write(blocks[b].data(), static_cast<std::streamsize>(blocks[b].size()));
+            }
+        }
+    }
+
+    std::string CsvWriter::toString(const void *objects, std::size_t count, std::size_t stride) const
+    {
+        std::ostringstream out;
+        write(out, objects, count, stride);
+        return out.str();
+    }
+
+} // namespace Evently
@@ -0,0 +1,185 @@
+#ifndef CSV_TABLE_H
+#define CSV_TABLE_H
+#pragma once
+
+#include "MemberTable.h"
+#include "Reflection.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief CSV / TSV 的分隔符、引号和表头设置
+     */
+    struct CsvFormat
+    {
+        char delimiter;
+        char quote;
+        bool header; ///< 第一行是列名
+
+        static CsvFormat csv() { return CsvFormat{',', '"', true}; }
+        static CsvFormat tsv() { return CsvFormat{'\t', '"', true}; }
+    };
+
+    /**
+     * @brief 一列与字段的对应关系：按字段类型实例化的解析和格式化函数
+     *
+     * 注册过的枚举类型的字段按名字读写（parse / format 为 nullptr，改用 enumType）。
+     */
+    struct CsvColumn
+    {
+        typedef bool (*Parser)(const char *begin, const char *end, void *field);
+        typedef void (*Formatter)(const void *field, std::string &out);
+
+        std::string name;
+        FieldThunk field;
+        Parser parse;
+        Formatter format;
+        const EnumInfo *enumType;
+    };
+
+    /**
+     * @brief 把 CSV / TSV 文本批量读入注册类的对象
+     *
+     * 表头中的列名只在开始时与注册字段对应一次（表中没有的字段保持默认值，
+     * 类中没有的列被忽略）；数值直接解析为字段的原生类型，不经过 Any。
+     * 大文本按字节切成若干段，先并行统计每段的引号奇偶，确定引号外的换行作为分块边界，
+     * 再在注册表的异步线程池上并行解析各分块，因此引号内的换行和分隔符可以跨越分块。
+     *
+     * @code
+     * CsvReader reader(registry, "Person");
+     * std::vector<Person> people = reader.read<Person>(text);
+     * @endcode
+     */
+    class CsvReader
+    {
+    public:
+        /// 不少于这么多字节时并行解析
+        static const std::size_t parallelThreshold = 1 << 20;
+
+        CsvReader(const ReflectionRegistry &registry, const std::string &className,
+                  const CsvFormat &format = CsvFormat::csv());
+
+        /// 是否允许并行解析（默认允许）
+        CsvReader &parallel(bool enabled);
+
+        /**
+         * @brief 解析全部行，T 须可默认构造
+         * @throws std::invalid_argument 某个值不能解析为字段类型，或引号不成对
+         */
+        template <typename T>
+        std::vector<T> read(const char *data, std::size_t size) const
+        {
+            Layout layout = prepare(data, size);
+            std::vector<T> rows(layout.rowCount);
+            parse(layout, rows.data(), sizeof(T));
+            return rows;
+        }
+
+        template <typename T>
+        std::vector<T> read(const std::string &text) const
+        {
+            return read<T>(text.data(), text.size());
+        }
+
+        /// @throws std::runtime_error 文件无法打开
+        template <typename T>
+        std::vector<T> readFile(const std::string &path) const
+        {
+            std::string text = loadFile(path);
+            return read<T>(text);
+        }
+
+    private:
+        struct Chunk
+        {
+            const char *begin;
+            const char *end;
+            std::size_t firstRow;
+            std::size_t rows;
+        };
+
+        /// 一次读取的分块和列映射（nullptr 表示忽略该列）
+        struct Layout
+        {
+            std::vector<Chunk> chunks;
+            std::vector<const CsvColumn *> columns;
+            std::size_t rowCount;
+            bool parallel;
+        };
+
+        Layout prepare(const char *data, std::size_t size) const;
+        void parse(const Layout &layout, void *objects, std::size_t stride) const;
+        void parseChunk(const Layout &layout, const Chunk &chunk, char *base, std::size_t stride,
+                        const std::vector<std::size_t> &offsets) const;
+        static std::string loadFile(const std::string &path);
+
+        const ReflectionRegistry &registry_;
+        std::string className_;
+        CsvFormat format_;
+        std::vector<CsvColumn> fields_;
+        bool parallel_;
+    };
+
+    /**
+     * @brief 把注册类的对象批量写为 CSV / TSV
+     *
+     * 默认输出按注册顺序的全部常用类型字段（算术类型、std::string 和注册过的枚举）。
+     * 行按块在异步线程池上并行格式化为文本，再按顺序以大块写入输出流。
+     *
+     * @code
+     * CsvWriter writer(registry, "Person");
+     * writer.write(file, people);
+     * @endcode
+     */
+    class CsvWriter
+    {
+    public:
+        /// 每个格式化块的行数
+        static const std::size_t blockRows = 16384;
+
+        CsvWriter(const ReflectionRegistry &registry, const std::string &className,
+                  const CsvFormat &format = CsvFormat::csv());
+
+        /// 只输出指定的字段（按给定顺序）
+        /// @throws std::invalid_argument 字段不存在或类型不支持
+        CsvWriter(const ReflectionRegistry &registry, const std::string &className,
+                  const std::vector<std::string> &fieldNames, const CsvFormat &format = CsvFormat::csv());
+
+        CsvWriter &parallel(bool enabled);
+
+        /// 写出表头（按设置）和 count 个相隔 stride 字节的对象
+        void write(std::ostream &out, const void *objects, std::size_t count, std::size_t stride) const;
+
+        template <typename T>
+        void write(std::ostream &out, const std::vector<T> &objects) const
+        {
+            write(out, objects.data(), objects.size(), sizeof(T));
+        }
+
+        template <typename T>
+        std::string toString(const std::vector<T> &objects) const
+        {
+            return toString(objects.data(), objects.size(), sizeof(T));
+        }
+
+        std::string toString(const void *objects, std::size_t count, std::size_t stride) const;
+
+    private:
+        void formatRows(const char *base, std::size_t begin, std::size_t end, std::size_t stride,
+                        const std::vector<std::size_t> &offsets, std::string &out) const;
+        void appendText(const std::string &text, std::string &out) const;
+
+        const ReflectionRegistry &registry_;
+        CsvFormat format_;
+        std::vector<CsvColumn> columns_;
+        bool parallel_;
+    };
+
+} // namespace Evently
+
+#endif // CSV_TABLE_H
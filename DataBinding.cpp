@@ -0,0 +1,255 @@
+#include "DataBinding.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    BindingSet::BindingSet(ReflectionRegistry &registry, Mode mode)
+        : registry_(registry), mode_(mode), bindingCount_(0)
+    {
+        registry_.addWriteListener(this);
+    }
+
+    BindingSet::~BindingSet()
+    {
+        registry_.removeWriteListener(this);
+    }
+
+    BindingSet::Id BindingSet::bind(const std::string &sourceClass, const void *source, const std::string &sourcePath,
+                                    const std::string &targetClass, void *target, const std::string &targetPath)
+    {
+        return bindImpl(sourceClass, source, sourcePath, targetClass, target, targetPath, typeid(void), typeid(void),
+                        Converter());
+    }
+
+    BindingSet::Id BindingSet::bindImpl(const std::string &sourceClass, const void *source,
+                                        const std::string &sourcePath, const std::string &targetClass, void *target,
+                                        const std::string &targetPath, const std::type_info &from,
+                                        const std::type_info &to, Converter convert)
+    {
+        if (source == nullptr || target == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        std::shared_ptr<const PropertyPath> sourceField = registry_.cachedPath(sourceClass, sourcePath);
+        std::shared_ptr<const PropertyPath> targetField = registry_.cachedPath(targetClass, targetPath);
+        const std::string description = sourceClass + "." + sourcePath + " -> " + targetClass + "." + targetPath;
+        if (!targetField->writable())
+        {
+            throw std::invalid_argument("绑定目标不可写: " + description);
+        }
+        if (convert)
+        {
+            if (sourceField->valueType() != from || targetField->valueType() != to)
+            {
+                throw std::invalid_argument("转换函数的参数或返回类型与字段类型不一致: " + description);
+            }
+        }
+        else if (sourceField->valueType() != targetField->valueType())
+        {
+            throw std::invalid_argument("字段类型不同，需要转换函数: " + description);
+        }
+        else if (!sourceField->valueOps().trivial && sourceField->valueOps().assign == nullptr)
+        {
+            throw std::invalid_argument("字段类型不可拷贝赋值: " + description);
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        Binding binding;
+        binding.source = sourceField->address(source);
+        binding.target = targetField->address(target);
+        binding.ops = &sourceField->valueOps();
+        binding.convert = std::move(convert);
+        binding.active = true;
+        binding.dirty = false;
+        binding.running = false;
+
+        Id id;
+        if (!freeIds_.empty())
+        {
+            id = freeIds_.back();
+            freeIds_.pop_back();
+            bindings_[id] = std::move(binding);
+        }
+        else
+        {
+            id = bindings_.size();
+            bindings_.push_back(std::move(binding));
+        }
+        bySource_[bindings_[id].source].push_back(id);
+        ++bindingCount_;
+
+        // 建立时同步一次，并按模式把变化继续传给下游
+        apply(bindings_[id]);
+        changed(bindings_[id].target);
+        return id;
+    }
+
+    void BindingSet::unbind(Id id)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (id >= bindings_.size() || !bindings_[id].active)
+        {
+            return;
+        }
+        Binding &binding = bindings_[id];
+        auto it = bySource_.find(binding.source);
+        if (it != bySource_.end())
+        {
+            it->second.erase(std::remove(it->second.begin(), it->second.end(), id), it->second.end());
+            if (it->second.empty())
+            {
+                bySource_.erase(it);
+            }
+        }
+        // 仍在待同步列表中的项在 flush 时跳过
+        binding.active = false;
+        binding.convert = Converter();
+        freeIds_.push_back(id);
+        --bindingCount_;
+    }
+
+    void BindingSet::clear()
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        bindings_.clear();
+        freeIds_.clear();
+        bySource_.clear();
+        dirty_.clear();
+        bindingCount_ = 0;
+    }
+
+    void BindingSet::apply(Binding &binding) const
+    {
+        if (binding.convert)
+        {
+            binding.convert(binding.source, binding.target);
+        }
+        else if (binding.ops->trivial)
+        {
+            std::memcpy(binding.target, binding.source, binding.ops->size);
+        }
+        else
+        {
+            binding.ops->assign(binding.target, binding.source);
+        }
+    }
+
+    void BindingSet::fieldWritten(void *, const void *field)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        changed(field);
+    }
+
+    void BindingSet::markChanged(const void *field)
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        changed(field);
+    }
+
+    void BindingSet::markChanged(const std::string &className, const void *instance, const std::string &path)
+    {
+        const void *field = registry_.cachedPath(className, path)->address(instance);
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        changed(field);
+    }
+
+    void BindingSet::changed(const void *field)
+    {
+        if (mode_ == Mode::Batched)
+        {
+            markDirty(field);
+        }
+        else
+        {
+            propagateFrom(field);
+        }
+    }
+
+    std::size_t BindingSet::propagateFrom(const void *field)
+    {
+        auto it = bySource_.find(field);
+        if (it == bySource_.end())
+        {
+            return 0;
+        }
+        // 传播中可能增删绑定，先复制下标
+        const std::vector<Id> ids = it->second;
+        std::size_t applied = 0;
+        for (Id id : ids)
+        {
+            if (bindings_[id].active && !bindings_[id].running)
+            {
+                applied += propagate(id);
+            }
+        }
+        return applied;
+    }
+
+    std::size_t BindingSet::propagate(Id id)
+    {
+        // 正在传播路径上的绑定不再进入，环在一次传播中终止
+        bindings_[id].running = true;
+        // 已同步的值包含了之前排队时的变化，不必在 flush 中再执行
+        bindings_[id].dirty = false;
+        apply(bindings_[id]);
+        const std::size_t applied = 1 + propagateFrom(bindings_[id].target);
+        bindings_[id].running = false;
+        return applied;
+    }
+
+    void BindingSet::markDirty(const void *field)
+    {
+        auto it = bySource_.find(field);
+        if (it == bySource_.end())
+        {
+            return;
+        }
+        for (Id id : it->second)
+        {
+            Binding &binding = bindings_[id];
+            if (!binding.dirty)
+            {
+                binding.dirty = true;
+                dirty_.push_back(id);
+            }
+        }
+    }
+
+    std::size_t BindingSet::size() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        return bindingCount_;
+    }
+
+    std::size_t BindingSet::pending() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        return dirty_.size();
+    }
+
+    std::size_t BindingSet::flush()
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        // 按变化的先后逐个执行，并像 Eager 模式一样沿下游传播：
+        // 同一绑定的源在本次 flush 中再次变化时会再执行，结果与逐次立即传播一致
+        std::size_t applied = 0;
+        for (std::size_t i = 0; i < dirty_.size(); ++i)
+        {
+            const Id id = dirty_[i];
+            if (bindings_[id].active && bindings_[id].dirty)
+            {
+                applied += propagate(id);
+            }
+        }
+        for (Id id : dirty_)
+        {
+            bindings_[id].dirty = false;
+        }
+        dirty_.clear();
+        return applied;
+    }
+
+} // namespace Evently
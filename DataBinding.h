@@ -0,0 +1,138 @@
+#ifndef DATA_BINDING_H
+#define DATA_BINDING_H
+#pragma once
+
+#include "Reflection.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 把一个实例的字段同步到另一个实例的字段（如 model.age -> view.ageLabel）
+     *
+     * 绑定时两端按属性路径解析一次，得到字段在各自实例中的地址；之后同步只是一次
+     * 拷贝赋值（可平凡拷贝的类型为 memcpy）或一次转换函数调用，不再查表、不经过 Any。
+     * 绑定建立时立即同步一次。
+     *
+     * 经注册表的 setValue / setPathValue / setEnumName 写入源字段时自动得知变化；
+     * 绕过注册表直接修改时用 markChanged 标记。Eager 模式在写入时立即传播，
+     * Batched 模式只记下受影响的绑定，由 flush() 一次执行，代价与变化的绑定数成正比。
+     * 目标字段又是其他绑定的源时继续向下传播；正在传播路径上的绑定不再进入，环不会无限循环。
+     * flush() 按变化的先后逐个传播，结果与逐次写入时立即传播相同。
+     *
+     * 实例须在解除绑定前保持有效且不移动；经过容器下标的路径绑定的是绑定时的那个元素。
+     * 注册表在写入线程上通知所有监听者，其他线程经同一注册表写入无关字段时也会调用到这里，
+     * 因此内部状态由一把递归锁保护（转换函数中经注册表写入时会重入）；同步本身在持锁线程上执行，
+     * 被绑定的实例仍须由使用者保证不被并发读写。析构前须停止其他线程对被绑定字段的写入。
+     *
+     * @code
+     * BindingSet bindings(registry);
+     * bindings.bind("Model", &model, "age", "View", &view, "age");
+     * bindings.bind<int, std::string>("Model", &model, "age", "View", &view, "ageLabel",
+     *                                 [](const int &age) { return std::to_string(age) + " 岁"; });
+     * registry.setValue("Model", "age", &model, Any(30));
+     * bindings.flush(); // 每帧一次
+     * @endcode
+     */
+    class BindingSet : private FieldWriteListener
+    {
+    public:
+        typedef std::size_t Id;
+
+        enum class Mode
+        {
+            Eager,  ///< 写入源字段时立即同步
+            Batched ///< 记下变化，flush() 时同步
+        };
+
+        explicit BindingSet(ReflectionRegistry &registry, Mode mode = Mode::Batched);
+        ~BindingSet();
+
+        BindingSet(const BindingSet &) = delete;
+        BindingSet &operator=(const BindingSet &) = delete;
+
+        /**
+         * @brief 绑定类型相同的两个字段
+         * @throws std::runtime_error 路径上的字段不存在
+         * @throws std::invalid_argument 类型不同、目标不可写或类型不可拷贝赋值
+         */
+        Id bind(const std::string &sourceClass, const void *source, const std::string &sourcePath,
+                const std::string &targetClass, void *target, const std::string &targetPath);
+
+        /**
+         * @brief 经转换函数绑定：target = convert(source)，convert 形如 To(const From &)
+         * @throws std::invalid_argument From / To 与两端字段的类型不一致或目标不可写
+         */
+        template <typename From, typename To, typename Convert>
+        Id bind(const std::string &sourceClass, const void *source, const std::string &sourcePath,
+                const std::string &targetClass, void *target, const std::string &targetPath, Convert convert)
+        {
+            return bindImpl(sourceClass, source, sourcePath, targetClass, target, targetPath, typeid(From), typeid(To),
+                            [convert](const void *from, void *to)
+                            { *static_cast<To *>(to) = convert(*static_cast<const From *>(from)); });
+        }
+
+        void unbind(Id id);
+        void clear();
+
+        /// 有效绑定数
+        std::size_t size() const;
+
+        /// 标记绕过注册表修改过的字段（field 为字段地址）
+        void markChanged(const void *field);
+        void markChanged(const std::string &className, const void *instance, const std::string &path);
+
+        /// 执行全部待同步的绑定，返回执行的绑定数（Eager 模式下总为 0）
+        std::size_t flush();
+
+        /// 待同步的绑定数
+        std::size_t pending() const;
+
+    private:
+        typedef std::function<void(const void *, void *)> Converter;
+
+        struct Binding
+        {
+            const void *source;
+            void *target;
+            const TypeOps *ops; ///< 同类型拷贝时使用
+            Converter convert;  ///< 有转换函数时使用
+            bool active;
+            bool dirty;
+            bool running; ///< 在当前传播路径上，防止环
+        };
+
+        Id bindImpl(const std::string &sourceClass, const void *source, const std::string &sourcePath,
+                    const std::string &targetClass, void *target, const std::string &targetPath,
+                    const std::type_info &from, const std::type_info &to, Converter convert);
+
+        void fieldWritten(void *instance, const void *field) override;
+        void changed(const void *field);
+        void apply(Binding &binding) const;
+        /// 执行以 field 为源的绑定并继续向下游传播，返回执行的绑定数
+        std::size_t propagateFrom(const void *field);
+        std::size_t propagate(Id id);
+        void markDirty(const void *field);
+
+        ReflectionRegistry &registry_;
+        Mode mode_;
+        mutable std::recursive_mutex mutex_;
+        std::vector<Binding> bindings_;
+        std::vector<Id> freeIds_;
+        std::size_t bindingCount_;
+        /// 源字段地址 -> 以它为源的绑定
+        std::unordered_map<const void *, std::vector<Id>> bySource_;
+        std::vector<Id> dirty_;
+    };
+
+} // namespace Evently
+
+#endif // DATA_BINDING_H
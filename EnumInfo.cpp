@@ -0,0 +1,323 @@
+#include "EnumInfo.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    namespace
+    {
+        int popCount(unsigned long long bits)
+        {
+            int count = 0;
+            for (; bits != 0; bits &= bits - 1)
+            {
+                ++count;
+            }
+            return count;
+        }
+
+        void trim(const char *&begin, const char *&end)
+        {
+            while (begin < end && (*begin == ' ' || *begin == '\t'))
+            {
+                ++begin;
+            }
+            while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+            {
+                --end;
+            }
+        }
+    }
+
+    EnumInfo::EnumInfo(const std::string &name, const std::type_info &type, std::size_t size, bool isSigned,
+                       bool flags, const std::vector<Entry> &entries, std::atomic<const EnumInfo *> *slot)
+        : name_(name), type_(&type), valueSize_(size), signed_(isSigned), flags_(flags), entries_(entries),
+          denseMin_(0), slot_(slot)
+    {
+        if (entries_.empty())
+        {
+            throw std::invalid_argument("枚举没有枚举项: " + name_);
+        }
+
+        // 名字表：容量为不小于两倍项数的 2 的幂
+        std::size_t capacity = 8;
+        while (capacity < entries_.size() * 2)
+        {
+            capacity *= 2;
+        }
+        nameSlots_.assign(capacity, 0);
+        nameHashes_.reserve(entries_.size());
+        long long low = entries_[0].value;
+        long long high = entries_[0].value;
+        for (std::size_t i = 0; i < entries_.size(); ++i)
+        {
+            const Entry &entry = entries_[i];
+            if (entry.name.empty())
+            {
+                throw std::invalid_argument("枚举项名字不能为空: " + name_);
+            }
+            const std::uint64_t hash = nameHash(entry.name.data(), entry.name.size());
+            nameHashes_.push_back(hash);
+            std::size_t index = static_cast<std::size_t>(hash) & (capacity - 1);
+            while (nameSlots_[index] != 0)
+            {
+                if (entries_[nameSlots_[index] - 1].name == entry.name)
+                {
+                    throw std::invalid_argument("枚举项名字重复: " + name_ + "::" + entry.name);
+                }
+                index = (index + 1) & (capacity - 1);
+            }
+            nameSlots_[index] = static_cast<std::uint32_t>(i + 1);
+            low = std::min(low, entry.value);
+            high = std::max(high, entry.value);
+        }
+
+        // 值表：范围不超过 max(64, 4 × 项数) 时用数组，同值的别名以先注册的为准
+        const unsigned long long range = static_cast<unsigned long long>(high) - static_cast<unsigned long long>(low);
+        if (range < std::max<unsigned long long>(64, entries_.size() * 4))
+        {
+            denseMin_ = low;
+            dense_.assign(static_cast<std::size_t>(range) + 1, -1);
+            for (std::size_t i = 0; i < entries_.size(); ++i)
+            {
+                int &slotIndex = dense_[static_cast<std::size_t>(static_cast<unsigned long long>(entries_[i].value) -
+                                                                 static_cast<unsigned long long>(low))];
+                if (slotIndex < 0)
+                {
+                    slotIndex = static_cast<int>(i);
+                }
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < entries_.size(); ++i)
+            {
+                sparse_.insert(std::make_pair(entries_[i].value, i));
+            }
+        }
+
+        if (flags_)
+        {
+            for (std::size_t i = 0; i < entries_.size(); ++i)
+            {
+                if (entries_[i].value != 0 && nameOf(entries_[i].value) == &entries_[i].name)
+                {
+                    flagOrder_.push_back(i);
+                }
+            }
+            std::stable_sort(flagOrder_.begin(), flagOrder_.end(),
+                             [this](std::size_t a, std::size_t b)
+                             {
+                                 return popCount(static_cast<unsigned long long>(entries_[a].value)) >
+                                        popCount(static_cast<unsigned long long>(entries_[b].value));
+                             });
+        }
+    }
+
+    const std::string *EnumInfo::nameOf(long long value) const
+    {
+        if (!dense_.empty())
+        {
+            const unsigned long long offset =
+                static_cast<unsigned long long>(value) - static_cast<unsigned long long>(denseMin_);
+            if (offset >= dense_.size() || dense_[static_cast<std::size_t>(offset)] < 0)
+            {
+                return nullptr;
+            }
+            return &entries_[static_cast<std::size_t>(dense_[static_cast<std::size_t>(offset)])].name;
+        }
+        auto it = sparse_.find(value);
+        return it != sparse_.end() ? &entries_[it->second].name : nullptr;
+    }
+
+    bool EnumInfo::valueOf(const NameRef &name, long long &value) const
+    {
+        const std::size_t mask = nameSlots_.size() - 1;
+        for (std::size_t index = static_cast<std::size_t>(name.hash()) & mask; nameSlots_[index] != 0;
+             index = (index + 1) & mask)
+        {
+            const std::size_t entry = nameSlots_[index] - 1;
+            if (nameHashes_[entry] == name.hash() && name.equals(entries_[entry].name))
+            {
+                value = entries_[entry].value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void EnumInfo::appendTo(long long value, std::string &out) const
+    {
+        if (const std::string *name = nameOf(value))
+        {
+            out += *name;
+            return;
+        }
+        if (flags_ && value != 0)
+        {
+            unsigned long long remaining = static_cast<unsigned long long>(value);
+            bool first = true;
+            for (std::size_t index : flagOrder_)
+            {
+                const unsigned long long bits = static_cast<unsigned long long>(entries_[index].value);
+                if ((remaining & bits) == bits)
+                {
+                    if (!first)
+                    {
+                        out.push_back('|');
+                    }
+                    out += entries_[index].name;
+                    remaining &= ~bits;
+                    first = false;
+                    if (remaining == 0)
+                    {
+                        return;
+                    }
+                }
+            }
+            if (!first)
+            {
+                out.push_back('|');
+            }
+            out += std::to_string(remaining);
+            return;
+        }
+        out += signed_ ? std::to_string(value) : std::to_string(static_cast<unsigned long long>(value));
+    }
+
+    std::string EnumInfo::toString(long long value) const
+    {
+        std::string text;
+        appendTo(value, text);
+        return text;
+    }
+
+    bool EnumInfo::parseOne(const char *begin, const char *end, long long &value) const
+    {
+        trim(begin, end);
+        if (begin == end)
+        {
+            return false;
+        }
+        if (valueOf(NameRef(begin, static_cast<std::size_t>(end - begin)), value))
+        {
+            return true;
+        }
+
+        // 不是名字时按十进制数解析
+        const bool negative = *begin == '-';
+        const char *p = begin + (negative || *begin == '+');
+        if (p == end)
+        {
+            return false;
+        }
+        unsigned long long magnitude = 0;
+        for (; p < end; ++p)
+        {
+            if (*p < '0' || *p > '9')
+            {
+                return false;
+            }
+            const unsigned digit = static_cast<unsigned>(*p - '0');
+            if (magnitude > (~0ULL - digit) / 10)
+            {
+                return false;
+            }
+            magnitude = magnitude * 10 + digit;
+        }
+        value = negative ? static_cast<long long>(0ULL - magnitude) : static_cast<long long>(magnitude);
+        return true;
+    }
+
+    bool EnumInfo::parse(const char *begin, const char *end, long long &value) const
+    {
+        if (!flags_)
+        {
+            return parseOne(begin, end, value);
+        }
+        long long combined = 0;
+        for (;;)
+        {
+            const char *bar = static_cast<const char *>(std::memchr(begin, '|', static_cast<std::size_t>(end - begin)));
+            long long part;
+            if (!parseOne(begin, bar != nullptr ? bar : end, part))
+            {
+                return false;
+            }
+            combined |= part;
+            if (bar == nullptr)
+            {
+                break;
+            }
+            begin = bar + 1;
+        }
+        value = combined;
+        return true;
+    }
+
+    long long EnumInfo::fromString(const std::string &text) const
+    {
+        long long value;
+        if (!parse(text.data(), text.data() + text.size(), value))
+        {
+            throw std::invalid_argument("不是枚举 " + name_ + " 的值: " + text);
+        }
+        return value;
+    }
+
+    namespace
+    {
+        // 经 memcpy 读写，不违反别名规则，编译器会优化为一次加载或存储
+        template <typename Signed, typename Unsigned>
+        long long readAs(const void *object, bool isSigned)
+        {
+            Unsigned bits;
+            std::memcpy(&bits, object, sizeof(bits));
+            return isSigned ? static_cast<long long>(static_cast<Signed>(bits)) : static_cast<long long>(bits);
+        }
+
+        template <typename Unsigned>
+        void writeAs(void *object, long long value)
+        {
+            const Unsigned bits = static_cast<Unsigned>(value);
+            std::memcpy(object, &bits, sizeof(bits));
+        }
+    }
+
+    long long EnumInfo::read(const void *object) const
+    {
+        switch (valueSize_)
+        {
+        case 1:
+            return readAs<std::int8_t, std::uint8_t>(object, signed_);
+        case 2:
+            return readAs<std::int16_t, std::uint16_t>(object, signed_);
+        case 4:
+            return readAs<std::int32_t, std::uint32_t>(object, signed_);
+        default:
+            return readAs<std::int64_t, std::uint64_t>(object, signed_);
+        }
+    }
+
+    void EnumInfo::write(void *object, long long value) const
+    {
+        switch (valueSize_)
+        {
+        case 1:
+            writeAs<std::uint8_t>(object, value);
+            break;
+        case 2:
+            writeAs<std::uint16_t>(object, value);
+            break;
+        case 4:
+            writeAs<std::uint32_t>(object, value);
+            break;
+        default:
+            writeAs<std::uint64_t>(object, value);
+            break;
+        }
+    }
+
+} // namespace Evently
@@ -0,0 +1,121 @@
+#ifndef ENUM_INFO_H
+#define ENUM_INFO_H
+#pragma once
+
+#include "NameRef.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 注册枚举的名字与值的对应表
+     *
+     * 值到名字：取值范围紧凑时用按值下标的数组，否则用哈希表，都是 O(1)；
+     * 名字到值：按 NameRef 哈希的开放寻址表，命中后再比较名字确认，不分配内存。
+     * 位标志枚举的值可以是多个标志的组合，格式化为 "Read|Write"，解析时也接受这种写法。
+     * 值按 long long 处理，读写实例时按底层类型的大小和符号转换。
+     */
+    class EnumInfo
+    {
+    public:
+        struct Entry
+        {
+            std::string name;
+            long long value;
+        };
+
+        /**
+         * @param slot 该枚举类型的全局槽位（TypeOps::enumInfo 从这里读取），由注册表设置
+         * @throws std::invalid_argument 没有枚举项、名字为空或重复
+         */
+        EnumInfo(const std::string &name, const std::type_info &type, std::size_t size, bool isSigned, bool flags,
+                 const std::vector<Entry> &entries, std::atomic<const EnumInfo *> *slot);
+
+        EnumInfo(const EnumInfo &) = delete;
+        EnumInfo &operator=(const EnumInfo &) = delete;
+
+        const std::string &name() const { return name_; }
+        const std::type_info &type() const { return *type_; }
+        bool flags() const { return flags_; }
+
+        /// 按注册顺序的枚举项
+        std::size_t size() const { return entries_.size(); }
+        const Entry &entry(std::size_t index) const { return entries_[index]; }
+
+        /// 值对应的枚举项名字，没有时返回 nullptr（位标志的组合也返回 nullptr）
+        const std::string *nameOf(long long value) const;
+
+        /// 名字对应的值，没有该名字时返回 false
+        bool valueOf(const NameRef &name, long long &value) const;
+
+        /**
+         * @brief 值的文本形式
+         *
+         * 有对应枚举项时为其名字；位标志枚举按包含的标志以 | 连接，剩余的位以十进制附在最后；
+         * 其他未注册的值输出为十进制数。
+         */
+        std::string toString(long long value) const;
+        void appendTo(long long value, std::string &out) const;
+
+        /// 解析名字、十进制数，位标志枚举还接受以 | 连接的多个名字（两侧可有空格）
+        bool parse(const char *begin, const char *end, long long &value) const;
+
+        /// @throws std::invalid_argument 不是该枚举的名字或数值
+        long long fromString(const std::string &text) const;
+
+        /// 按底层类型读写实例中的枚举值
+        long long read(const void *object) const;
+        void write(void *object, long long value) const;
+
+        std::atomic<const EnumInfo *> *slot() const { return slot_; }
+
+    private:
+        bool parseOne(const char *begin, const char *end, long long &value) const;
+
+        std::string name_;
+        const std::type_info *type_;
+        std::size_t valueSize_;
+        bool signed_;
+        bool flags_;
+        std::vector<Entry> entries_;
+        std::vector<std::uint64_t> nameHashes_;
+
+        // 值 -> 枚举项下标：紧凑时为数组（-1 表示没有），否则为哈希表
+        long long denseMin_;
+        std::vector<int> dense_;
+        std::unordered_map<long long, std::size_t> sparse_;
+
+        // 名字哈希的开放寻址表：存枚举项下标 + 1，0 表示空位
+        std::vector<std::uint32_t> nameSlots_;
+
+        // 位标志格式化时依次尝试的非零枚举项（置位多的在前，组合名优先）
+        std::vector<std::size_t> flagOrder_;
+
+        std::atomic<const EnumInfo *> *slot_;
+    };
+
+    namespace detail
+    {
+        /// 每个枚举类型一个全局槽位，指向最近注册的 EnumInfo
+        template <typename E>
+        struct EnumSlot
+        {
+            static std::atomic<const EnumInfo *> slot;
+
+            static const EnumInfo *get() { return slot.load(std::memory_order_acquire); }
+        };
+
+        template <typename E>
+        std::atomic<const EnumInfo *> EnumSlot<E>::slot(nullptr);
+    }
+
+} // namespace Evently
+
+#endif // ENUM_INFO_H
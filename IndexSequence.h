@@ -2,7 +2,11 @@
 #define INDEX_SEQUENCE_H
 #pragma once
 
+#include "Config.h"
 #include <cstddef>
+#if EVENTLY_HAS_CXX14
+#include <utility>
+#endif
 
 namespace Evently
 {
@@ -12,8 +16,20 @@ namespace Evently
      *
      * 这个实现提供了与C++14 std::index_sequence相同的功能，
      * 用于在编译时生成整数序列，支持参数包展开。
+     * C++14 起 index_sequence 直接是 std::index_sequence 的别名，
+     * make_index_sequence 由标准库（编译器内建）生成，不再逐层递归实例化。
      */
 
+#if EVENTLY_HAS_CXX14
+    template <std::size_t... Ints>
+    using index_sequence = std::index_sequence<Ints...>;
+
+    template <std::size_t N>
+    struct make_index_sequence
+    {
+        typedef std::make_index_sequence<N> type;
+    };
+#else
     // index_sequence的基本定义
     template <std::size_t... Ints>
     struct index_sequence
@@ -44,6 +60,7 @@ namespace Evently
     {
         typedef typename make_index_sequence_impl<N>::type type;
     };
+#endif
 
     /**
      * @brief 根据类型包生成对应长度的index_sequence
@@ -0,0 +1,381 @@
+#include "MemberTable.h"
+
+namespace Evently
+{
+
+    const std::size_t MemberTable::npos;
+
+    std::size_t signatureHashOf(const std::vector<Any> &args)
+    {
+        std::size_t seed = args.size();
+        for (const auto &arg : args)
+        {
+            seed = combineSignatureHash(seed, arg.type().hash_code());
+        }
+        return seed;
+    }
+
+    void FieldThunk::readRaw(const void *instance, void *out) const
+    {
+        if (ops->assign == nullptr)
+        {
+            throw std::invalid_argument("PropertySetter: Field type is not copy assignable");
+        }
+        ops->assign(out, fieldAddress(instance));
+    }
+
+    void FieldThunk::writeRaw(void *instance, const void *in) const
+    {
+        if (!writable() || ops->assign == nullptr)
+        {
+            throw std::invalid_argument("PropertySetter: Cannot set value of const field");
+        }
+        ops->assign(const_cast<void *>(fieldAddress(instance)), in);
+    }
+
+    bool MethodThunk::accepts(const std::vector<Any> &args) const
+    {
+        if (args.size() != arity)
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            if (args[i].type() != argType(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool MethodThunk::sameSignature(const MethodThunk &other) const
+    {
+        if (arity != other.arity || hash != other.hash)
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < arity; ++i)
+        {
+            if (argType(i) != other.argType(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    namespace
+    {
+        /// 成员数达到该值时建立名字索引，更少时顺序比较哈希更快
+        const std::size_t kIndexThreshold = 16;
+
+        void insertSlot(std::vector<std::uint32_t> &slots, std::uint64_t hash, std::size_t index)
+        {
+            const std::size_t mask = slots.size() - 1;
+            std::size_t slot = static_cast<std::size_t>(hash) & mask;
+            while (slots[slot] != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = static_cast<std::uint32_t>(index + 1);
+        }
+
+        /// 按名字建立索引，同名的连续表项只登记第一个
+        void buildSlots(std::vector<std::uint32_t> &slots, const std::vector<std::uint64_t> &hashes,
+                        const std::vector<const std::string *> &names)
+        {
+            slots.clear();
+            if (names.size() < kIndexThreshold)
+            {
+                return;
+            }
+            std::size_t capacity = 1;
+            while (capacity < names.size() * 2)
+            {
+                capacity <<= 1;
+            }
+            slots.assign(capacity, 0);
+            for (std::size_t i = 0; i < names.size(); ++i)
+            {
+                if (i == 0 || names[i] != names[i - 1])
+                {
+                    insertSlot(slots, hashes[i], i);
+                }
+            }
+        }
+
+        /// 追加的表项登记到索引，装载率超过一半时按新的大小重建
+        void appendSlot(std::vector<std::uint32_t> &slots, const std::vector<std::uint64_t> &hashes,
+                        const std::vector<const std::string *> &names)
+        {
+            const std::size_t index = names.size() - 1;
+            if (slots.empty() || names.size() * 2 > slots.size())
+            {
+                buildSlots(slots, hashes, names);
+                return;
+            }
+            if (index == 0 || names[index] != names[index - 1])
+            {
+                insertSlot(slots, hashes[index], index);
+            }
+        }
+    } // namespace
+
+    std::size_t MemberTable::findIndexed(const std::vector<std::uint32_t> &slots,
+                                         const std::vector<std::uint64_t> &hashes,
+                                         const std::vector<const std::string *> &names, const NameRef &name) const
+    {
+        if (slots.empty())
+        {
+            for (std::size_t i = 0; i < hashes.size(); ++i)
+            {
+                if (hashes[i] == name.hash() && name.equals(*names[i]))
+                {
+                    return i;
+                }
+            }
+            return npos;
+        }
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t slot = static_cast<std::size_t>(name.hash()) & mask; slots[slot] != 0;
+             slot = (slot + 1) & mask)
+        {
+            const std::size_t index = slots[slot] - 1;
+            if (hashes[index] == name.hash() && name.equals(*names[index]))
+            {
+                return index;
+            }
+        }
+        return npos;
+    }
+
+    std::size_t MemberTable::findField(const NameRef &name) const
+    {
+        return findIndexed(fieldSlots_, fieldHashes_, fieldNames_, name);
+    }
+
+    std::size_t MemberTable::findMethod(const NameRef &name) const
+    {
+        return findIndexed(methodSlots_, methodHashes_, methodNames_, name);
+    }
+
+    std::size_t MemberTable::findMethod(const NameRef &name, std::size_t signatureHash) const
+    {
+        const std::size_t first = findMethod(name);
+        if (first == npos)
+        {
+            return npos;
+        }
+        const std::size_t end = overloadEnd(first);
+        for (std::size_t i = first; i < end; ++i)
+        {
+            if (methods_[i].hash == signatureHash)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    std::size_t MemberTable::findMethod(const NameRef &name,
+                                        const std::vector<const std::type_info *> &argTypes) const
+    {
+        const std::size_t first = findMethod(name);
+        if (first == npos)
+        {
+            return npos;
+        }
+        std::size_t hash = argTypes.size();
+        for (const auto *type : argTypes)
+        {
+            hash = combineSignatureHash(hash, type->hash_code());
+        }
+        const std::size_t end = overloadEnd(first);
+        for (std::size_t i = first; i < end; ++i)
+        {
+            const MethodThunk &method = methods_[i];
+            if (method.hash != hash || method.arity != argTypes.size())
+            {
+                continue;
+            }
+            bool match = true;
+            for (std::size_t a = 0; a < argTypes.size() && match; ++a)
+            {
+                match = method.argType(a) == *argTypes[a];
+            }
+            if (match)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    std::size_t MemberTable::selectMethod(const NameRef &name, const std::vector<Any> &args) const
+    {
+        const std::size_t first = findMethod(name);
+        if (first == npos)
+        {
+            return npos;
+        }
+        const std::size_t end = overloadEnd(first);
+        if (end - first == 1)
+        {
+            return first;
+        }
+        // 先比较预先计算的签名哈希，再逐一确认参数类型（哈希可能冲突）
+        const std::size_t hash = signatureHashOf(args);
+        for (std::size_t i = first; i < end; ++i)
+        {
+            if (methods_[i].hash == hash && methods_[i].accepts(args))
+            {
+                return i;
+            }
+        }
+        throw std::invalid_argument("没有与参数类型匹配的重载");
+    }
+
+    std::size_t MemberTable::overloadCount(std::size_t index) const
+    {
+        return overloadEnd(index) - index;
+    }
+
+    std::size_t MemberTable::overloadEnd(std::size_t index) const
+    {
+        // 同一张表的名字都来自同一个名字池，同名即同一地址
+        std::size_t end = index + 1;
+        while (end < methodNames_.size() && methodNames_[end] == methodNames_[index])
+        {
+            ++end;
+        }
+        return end;
+    }
+
+    bool MemberTable::putField(const std::string &name, std::uint64_t hash, const FieldThunk &thunk, Origin origin)
+    {
+        const std::size_t index = findField(NameRef(name.data(), name.size(), hash));
+        if (index == npos)
+        {
+            fields_.push_back(thunk);
+            fieldHashes_.push_back(hash);
+            fieldNames_.push_back(&name);
+            fieldOrigins_.push_back(origin);
+            appendSlot(fieldSlots_, fieldHashes_, fieldNames_);
+            return true;
+        }
+        const Origin existing = fieldOrigins_[index];
+        if (origin != 0 && (existing == 0 || existing < origin))
+        {
+            return false;
+        }
+        fields_[index] = thunk;
+        fieldOrigins_[index] = origin;
+        return true;
+    }
+
+    void MemberTable::addMethod(const std::string &name, std::uint64_t hash, const MethodThunk &thunk)
+    {
+        const std::size_t first = findMethod(NameRef(name.data(), name.size(), hash));
+        if (first == npos)
+        {
+            replaceMethods(methods_.size(), methods_.size(), name, hash, &thunk, 1, 0);
+            return;
+        }
+        const std::size_t end = overloadEnd(first);
+        if (methodOrigins_[first] != 0)
+        {
+            // 派生类自己注册的方法隐藏继承来的同名方法（与 C++ 名字查找一致）
+            replaceMethods(first, end, name, hash, &thunk, 1, 0);
+            return;
+        }
+        for (std::size_t i = first; i < end; ++i)
+        {
+            if (methods_[i].sameSignature(thunk))
+            {
+                methods_[i] = thunk;
+                return;
+            }
+        }
+        replaceMethods(end, end, name, hash, &thunk, 1, 0);
+    }
+
+    bool MemberTable::inheritMethods(const std::string &name, std::uint64_t hash,
+                                     const std::vector<MethodThunk> &thunks, Origin origin)
+    {
+        const std::size_t first = findMethod(NameRef(name.data(), name.size(), hash));
+        if (first == npos)
+        {
+            replaceMethods(methods_.size(), methods_.size(), name, hash, thunks.data(), thunks.size(), origin);
+            return true;
+        }
+        const Origin existing = methodOrigins_[first];
+        if (existing == 0 || existing < origin)
+        {
+            return false;
+        }
+        replaceMethods(first, overloadEnd(first), name, hash, thunks.data(), thunks.size(), origin);
+        return true;
+    }
+
+    void MemberTable::replaceMethods(std::size_t begin, std::size_t end, const std::string &name, std::uint64_t hash,
+                                     const MethodThunk *thunks, std::size_t count, Origin origin)
+    {
+        const bool append = begin == methods_.size() && count == 1;
+        methods_.erase(methods_.begin() + begin, methods_.begin() + end);
+        methodHashes_.erase(methodHashes_.begin() + begin, methodHashes_.begin() + end);
+        methodNames_.erase(methodNames_.begin() + begin, methodNames_.begin() + end);
+        methodOrigins_.erase(methodOrigins_.begin() + begin, methodOrigins_.begin() + end);
+        methods_.insert(methods_.begin() + begin, thunks, thunks + count);
+        methodHashes_.insert(methodHashes_.begin() + begin, count, hash);
+        methodNames_.insert(methodNames_.begin() + begin, count, &name);
+        methodOrigins_.insert(methodOrigins_.begin() + begin, count, origin);
+        if (append)
+        {
+            appendSlot(methodSlots_, methodHashes_, methodNames_);
+        }
+        else
+        {
+            reindexMethods();
+        }
+    }
+
+    void MemberTable::reindexFields()
+    {
+        buildSlots(fieldSlots_, fieldHashes_, fieldNames_);
+    }
+
+    void MemberTable::reindexMethods()
+    {
+        buildSlots(methodSlots_, methodHashes_, methodNames_);
+    }
+
+    void MemberTable::clear()
+    {
+        fields_.clear();
+        fieldHashes_.clear();
+        fieldNames_.clear();
+        fieldOrigins_.clear();
+        fieldSlots_.clear();
+        methods_.clear();
+        methodHashes_.clear();
+        methodNames_.clear();
+        methodOrigins_.clear();
+        methodSlots_.clear();
+    }
+
+    void MemberTable::shrink()
+    {
+        fields_.shrink_to_fit();
+        fieldHashes_.shrink_to_fit();
+        fieldNames_.shrink_to_fit();
+        fieldOrigins_.shrink_to_fit();
+        methods_.shrink_to_fit();
+        methodHashes_.shrink_to_fit();
+        methodNames_.shrink_to_fit();
+        methodOrigins_.shrink_to_fit();
+        reindexFields();
+        reindexMethods();
+    }
+
+} // namespace Evently
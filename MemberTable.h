@@ -0,0 +1,257 @@
+#ifndef MEMBER_TABLE_H
+#define MEMBER_TABLE_H
+#pragma once
+
+#include "Any.h"
+#include "NameRef.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace Evently
+{
+
+    class ReflectionRegistry;
+
+    /// 未定义的类：它的成员函数指针是各编译器上最宽的表示（MSVC 未知继承模型）
+    class UndefinedMemberOwner;
+
+    /**
+     * @brief 成员指针的原始字节（按值保存在表项中，不单独分配）
+     */
+    typedef std::aligned_storage<sizeof(void (UndefinedMemberOwner::*)()),
+                                 alignof(void (UndefinedMemberOwner::*)())>::type MemberPointerStorage;
+
+    template <typename Member>
+    void storeMemberPointer(MemberPointerStorage &storage, Member member)
+    {
+        static_assert(sizeof(Member) <= sizeof(MemberPointerStorage), "成员指针超出预留的存储大小");
+        std::memcpy(&storage, &member, sizeof(Member));
+    }
+
+    template <typename Member>
+    Member loadMemberPointer(const MemberPointerStorage &storage)
+    {
+        Member member;
+        std::memcpy(&member, &storage, sizeof(Member));
+        return member;
+    }
+
+    /**
+     * @brief 签名哈希组合函数（参数个数作为种子，依次混入各参数类型的哈希）
+     */
+    inline std::size_t combineSignatureHash(std::size_t seed, std::size_t typeHash)
+    {
+        return seed ^ (typeHash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    /**
+     * @brief 根据实参的运行时类型计算签名哈希，用于重载分派
+     */
+    std::size_t signatureHashOf(const std::vector<Any> &args);
+
+    /**
+     * @brief 字段访问器：函数指针 + 字段偏移，没有虚表，也不单独分配
+     *
+     * 函数指针是按字段类型实例化的模板函数；offset 是字段相对实例起始地址的偏移，
+     * 继承字段已含基类子对象的调整量，因此多层继承也只是一次地址运算。
+     */
+    struct FieldThunk
+    {
+        typedef Any (*Getter)(const FieldThunk &thunk, const void *instance);
+        typedef void (*Setter)(const FieldThunk &thunk, void *instance, const Any &value);
+
+        Getter getter;
+        Setter setter; ///< const 字段为 nullptr
+        const TypeOps *ops;
+        std::ptrdiff_t offset;
+
+        Any get(const void *instance) const { return getter(*this, instance); }
+
+        /// @throws std::invalid_argument const 字段或值类型不匹配
+        void set(void *instance, const Any &value) const
+        {
+            if (setter == nullptr)
+            {
+                throw std::invalid_argument("PropertySetter: Cannot set value of const field");
+            }
+            setter(*this, instance, value);
+        }
+
+        /// 字段类型（去掉 cv 限定）的操作表
+        const TypeOps &fieldOps() const { return *ops; }
+        const std::type_info &fieldType() const { return *ops->type; }
+
+        /// 字段在实例中的地址（不拷贝字段值）
+        const void *fieldAddress(const void *instance) const { return static_cast<const char *>(instance) + offset; }
+        /// 字段相对实例起始地址的字节偏移（继承字段包含基类子对象的调整量）
+        std::ptrdiff_t fieldOffset() const { return offset; }
+        /// 字段是否可写（const 字段不可写）
+        bool writable() const { return setter != nullptr; }
+
+        /// 不经过 Any 的读取：把字段值拷贝赋值到 out（类型为 fieldType()）
+        void readRaw(const void *instance, void *out) const;
+        /// 不经过 Any 的写入：把 in 拷贝赋值到字段，const 字段抛出 std::invalid_argument
+        void writeRaw(void *instance, const void *in) const;
+    };
+
+    /**
+     * @brief 方法调用器：函数指针 + 成员函数指针字节，没有虚表，也不单独分配
+     *
+     * 每个调用器是一个具体签名；重载方法的每个签名各占一项，名字相同。
+     */
+    struct MethodThunk
+    {
+        typedef Any (*Invoker)(const MethodThunk &thunk, void *instance, const std::vector<Any> &args);
+        typedef void (*RawInvoker)(const MethodThunk &thunk, void *instance, const void *const *args,
+                                   void *result);
+        typedef const TypeOps &(*ArgOps)(std::size_t index);
+
+        Invoker invoker;
+        RawInvoker rawInvoker;
+        ArgOps argOpsOf;
+        const TypeOps *resultOps;
+        std::uint32_t arity;
+        std::uint32_t outArgs; ///< 按非 const 左值引用传递的参数，第 i 位对应第 i 个参数
+        std::size_t hash;      ///< 签名哈希，与 signatureHashOf(args) 的计算方式一致
+        std::ptrdiff_t adjust; ///< 调用前施加到实例指针上的调整量（继承方法指向基类子对象）
+        MemberPointerStorage member;
+
+        /// @throws std::invalid_argument 参数个数不符；bad_any_cast 参数类型不符
+        Any invoke(void *instance, const std::vector<Any> &args) const { return invoker(*this, instance, args); }
+
+        /**
+         * @brief 不经过 Any 的类型化调用（批量调用、调用计划使用）
+         * @param args 依次指向各参数值（类型为 argType(i)）的指针数组
+         * @param result 指向已构造的返回类型对象，结果赋值到其中；为 nullptr 时丢弃返回值
+         *
+         * 调用方负责事先校验参数与返回类型，这里不再做任何检查。
+         */
+        void invokeRaw(void *instance, const void *const *args, void *result) const
+        {
+            rawInvoker(*this, instance, args, result);
+        }
+
+        std::size_t argCount() const { return arity; }
+        /// 第 index 个参数去掉引用和 cv 限定后的类型操作表
+        const TypeOps &argOps(std::size_t index) const { return argOpsOf(index); }
+        const std::type_info &argType(std::size_t index) const { return *argOps(index).type; }
+        std::size_t signatureHash() const { return hash; }
+        /// 第 index 个参数是否按非 const 左值引用传递（方法可能修改实参）
+        bool writesArg(std::size_t index) const { return (outArgs >> index & 1u) != 0; }
+        /// 去掉引用和 cv 限定后的返回类型操作表（void 方法为 TypeOps::of<void>()）
+        const TypeOps &returnOps() const { return *resultOps; }
+        const std::type_info &returnType() const { return *resultOps->type; }
+
+        /// 实参类型是否与签名逐一匹配
+        bool accepts(const std::vector<Any> &args) const;
+        /// 两个调用器的参数类型列表是否相同
+        bool sameSignature(const MethodThunk &other) const;
+    };
+
+    /**
+     * @brief 一个类的全部字段与方法，按注册顺序连续存放（注册表中成员的唯一存储）
+     *
+     * 由注册表在注册时维护（含继承来的成员），遍历或按下标访问时表项在内存中相邻，
+     * 调用只经过一次函数指针，不经过虚函数。重载方法的各签名连续存放。
+     * 按名查找比较名字哈希：成员较少时顺序比较，较多时经开放寻址的下标索引。
+     * 表项和名字引用在该类（或其基类）再次注册成员前有效。
+     *
+     * @code
+     * const MemberTable *table = registry.memberTable("Person");
+     * std::size_t age = table->findField("age"_name);
+     * Any value = table->field(age).get(&person);
+     * @endcode
+     */
+    class MemberTable
+    {
+    public:
+        static const std::size_t npos = static_cast<std::size_t>(-1);
+
+        std::size_t fieldCount() const { return fields_.size(); }
+        const FieldThunk &field(std::size_t index) const { return fields_[index]; }
+        const std::string &fieldName(std::size_t index) const { return *fieldNames_[index]; }
+
+        std::size_t methodCount() const { return methods_.size(); }
+        const MethodThunk &method(std::size_t index) const { return methods_[index]; }
+        const std::string &methodName(std::size_t index) const { return *methodNames_[index]; }
+
+        /// 按名查找字段下标，不存在时返回 npos
+        std::size_t findField(const NameRef &name) const;
+
+        /// 按名查找方法（重载时为第一个签名），不存在时返回 npos
+        std::size_t findMethod(const NameRef &name) const;
+
+        /// 按名和签名哈希查找方法的具体重载，不存在时返回 npos
+        std::size_t findMethod(const NameRef &name, std::size_t signatureHash) const;
+
+        /// 按名和参数类型列表查找方法的具体重载，不存在时返回 npos
+        std::size_t findMethod(const NameRef &name, const std::vector<const std::type_info *> &argTypes) const;
+
+        /**
+         * @brief 按实参类型选出要调用的重载
+         * @return 名字不存在时返回 npos；只有一个签名时直接返回它，由调用报告参数个数或类型错误
+         * @throws std::invalid_argument 有多个签名但没有与实参类型匹配的
+         */
+        std::size_t selectMethod(const NameRef &name, const std::vector<Any> &args) const;
+
+        /// 从 index 起与它同名的连续方法表项数（即重载个数）
+        std::size_t overloadCount(std::size_t index) const;
+
+    private:
+        friend class ReflectionRegistry;
+
+        /// 继承来的成员记录来源：0 为本类注册，i + 1 为第 i 个直接基类
+        typedef std::uint32_t Origin;
+
+        /**
+         * @brief 写入字段：同名字段不存在时追加，存在时按来源决定是否替换
+         *
+         * 本类注册的字段总是替换；继承来的字段不替换本类的字段和来自更靠前基类的字段。
+         * @return 表是否变化
+         */
+        bool putField(const std::string &name, std::uint64_t hash, const FieldThunk &thunk, Origin origin);
+
+        /// 本类注册方法：签名相同的替换，不同的作为重载加入；继承来的同名方法全部被隐藏
+        void addMethod(const std::string &name, std::uint64_t hash, const MethodThunk &thunk);
+
+        /// 继承同名方法的全部签名（整组替换，优先规则同 putField），返回表是否变化
+        bool inheritMethods(const std::string &name, std::uint64_t hash, const std::vector<MethodThunk> &thunks,
+                            Origin origin);
+
+        void clear();
+        void shrink();
+
+        /// 从 index 起的同名方法在 methods_ 中的范围 [index, 返回值)
+        std::size_t overloadEnd(std::size_t index) const;
+        void replaceMethods(std::size_t begin, std::size_t end, const std::string &name, std::uint64_t hash,
+                            const MethodThunk *thunks, std::size_t count, Origin origin);
+        std::size_t findIndexed(const std::vector<std::uint32_t> &slots, const std::vector<std::uint64_t> &hashes,
+                                const std::vector<const std::string *> &names, const NameRef &name) const;
+        void reindexFields();
+        void reindexMethods();
+
+        std::vector<FieldThunk> fields_;
+        std::vector<std::uint64_t> fieldHashes_;
+        std::vector<const std::string *> fieldNames_;
+        std::vector<Origin> fieldOrigins_;
+
+        std::vector<MethodThunk> methods_;
+        std::vector<std::uint64_t> methodHashes_;
+        std::vector<const std::string *> methodNames_;
+        std::vector<Origin> methodOrigins_;
+
+        // 按名字哈希的开放寻址索引（保存下标 + 1，0 为空位）；成员较少时为空，顺序比较
+        std::vector<std::uint32_t> fieldSlots_;
+        std::vector<std::uint32_t> methodSlots_;
+    };
+
+} // namespace Evently
+
+#endif // MEMBER_TABLE_H
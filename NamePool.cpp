@@ -0,0 +1,61 @@
+#include "NamePool.h"
+#include <stdexcept>
+
+namespace Evently
+{
+
+    const NamePool::Id NamePool::npos;
+
+    NamePool::Id NamePool::intern(const std::string &name)
+    {
+        Id existing = find(NameRef(name));
+        if (existing != npos)
+        {
+            return existing;
+        }
+        if (names_.size() >= static_cast<std::size_t>(npos))
+        {
+            throw std::runtime_error("名字池已满");
+        }
+        Id id = static_cast<Id>(names_.size());
+        std::uint64_t hash = nameHash(name.data(), name.size());
+        names_.push_back(name);
+        hashes_.push_back(hash);
+        index_.insert(std::make_pair(hash, id));
+        return id;
+    }
+
+    NamePool::Id NamePool::find(const NameRef &name) const
+    {
+        auto range = index_.equal_range(name.hash());
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (name.equals(names_[it->second]))
+            {
+                return it->second;
+            }
+        }
+        return npos;
+    }
+
+    std::size_t NamePool::memoryBytes() const
+    {
+        std::size_t bytes = names_.size() * sizeof(std::string) + hashes_.capacity() * sizeof(std::uint64_t);
+        for (const auto &name : names_)
+        {
+            bytes += stringHeapBytes(name);
+        }
+        // 多重映射的节点：值 + 下一节点指针；以及桶数组
+        bytes += index_.size() * (sizeof(std::pair<const std::uint64_t, Id>) + sizeof(void *));
+        bytes += index_.bucket_count() * sizeof(void *);
+        return bytes;
+    }
+
+    void NamePool::shrink()
+    {
+        names_.shrink_to_fit();
+        hashes_.shrink_to_fit();
+        index_.rehash(0);
+    }
+
+} // namespace Evently
@@ -0,0 +1,61 @@
+#ifndef NAME_POOL_H
+#define NAME_POOL_H
+#pragma once
+
+#include "NameRef.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 名字驻留池：每个不同的名字只保存一份，以 32 位整数编号引用
+     * 注册表用它保存类名和成员名，按类索引的表以编号为键，成员表只保存指向池中名字的指针，
+     * 注册表用它保存类名和成员名，成员键只存两个编号，
+     * 数千个类共用的成员名（如 "name"、"id"）也只占一份内存。
+     * 编号从 0 开始连续分配，名字的引用在池存续期间有效。
+     */
+    class NamePool
+    {
+    public:
+        typedef std::uint32_t Id;
+        static const Id npos = static_cast<Id>(-1);
+
+        /// 取得名字的编号，不存在时加入池中
+        Id intern(const std::string &name);
+
+        /// 查找名字的编号（不分配内存），不存在时返回 npos
+        Id find(const NameRef &name) const;
+
+        const std::string &name(Id id) const { return names_[id]; }
+        std::uint64_t hash(Id id) const { return hashes_[id]; }
+        std::size_t size() const { return names_.size(); }
+
+        /// 池本身占用的字节数（估算）
+        std::size_t memoryBytes() const;
+
+        /// 收紧内部容器的预留容量
+        void shrink();
+
+    private:
+        std::deque<std::string> names_;
+        std::vector<std::uint64_t> hashes_;
+        std::unordered_multimap<std::uint64_t, Id> index_;
+    };
+
+    /// std::string 的堆内存（短字符串内联时为 0）
+    inline std::size_t stringHeapBytes(const std::string &text)
+    {
+        const char *object = reinterpret_cast<const char *>(&text);
+        bool inlined = text.data() >= object && text.data() < object + sizeof(std::string);
+        return inlined ? 0 : text.capacity() + 1;
+    }
+
+} // namespace Evently
+
+#endif // NAME_POOL_H
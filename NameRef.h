@@ -0,0 +1,107 @@
+#ifndef NAME_REF_H
+#define NAME_REF_H
+#pragma once
+
+#include "Config.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#if EVENTLY_HAS_CXX17
+#include <string_view>
+#endif
+
+namespace Evently
+{
+
+    /**
+     * @brief 名字哈希（64 位 FNV-1a），constexpr，可在编译期计算
+     */
+    constexpr std::uint64_t nameHash(const char *data, std::size_t size,
+                                     std::uint64_t seed = 14695981039346656037ULL)
+    {
+        return size == 0 ? seed
+                         : nameHash(data + 1, size - 1,
+                                    (seed ^ static_cast<std::uint64_t>(static_cast<unsigned char>(*data))) *
+                                        1099511628211ULL);
+    }
+
+    /**
+     * @brief 把类名哈希和成员名哈希组合成成员键的哈希
+     */
+    constexpr std::uint64_t memberKeyHash(std::uint64_t classHash, std::uint64_t memberHash)
+    {
+        return classHash ^ (memberHash + 0x9e3779b97f4a7c15ULL + (classHash << 6) + (classHash >> 2));
+    }
+
+    /**
+     * @brief 不拥有内存的名字引用：指针 + 长度 + 预先计算的哈希
+     *
+     * 注册表用它做不分配内存的查找：直接用携带的哈希定位候选成员，再比较名字确认，
+     * 不再构造 std::string 键，也不重新计算哈希。引用的字符在查找期间必须有效。
+     *
+     * 从 std::string、C 字符串或（C++17 起）std::string_view 构造时在运行时计算哈希；字面量可以用 EVENTLY_NAME("age")
+     * 或 "age"_name 在编译期算好。
+     */
+    class NameRef
+    {
+    public:
+        constexpr NameRef(const char *data, std::size_t size, std::uint64_t hash)
+            : data_(data), size_(size), hash_(hash) {}
+
+        NameRef(const char *data, std::size_t size)
+            : data_(data), size_(size), hash_(nameHash(data, size)) {}
+
+        explicit NameRef(const char *name)
+            : data_(name), size_(std::strlen(name)), hash_(nameHash(name, size_)) {}
+
+        explicit NameRef(const std::string &name)
+            : data_(name.data()), size_(name.size()), hash_(nameHash(name.data(), name.size())) {}
+
+#if EVENTLY_HAS_CXX17
+        explicit NameRef(std::string_view name)
+            : data_(name.data()), size_(name.size()), hash_(nameHash(name.data(), name.size())) {}
+
+        constexpr std::string_view view() const { return std::string_view(data_, size_); }
+#endif
+
+        constexpr const char *data() const { return data_; }
+        constexpr std::size_t size() const { return size_; }
+        constexpr std::uint64_t hash() const { return hash_; }
+        constexpr bool empty() const { return size_ == 0; }
+
+        /// 只在需要拥有的字符串时（如延迟注册、错误信息）才拷贝
+        std::string str() const { return std::string(data_, size_); }
+
+        bool equals(const std::string &name) const
+        {
+            return name.size() == size_ && std::memcmp(name.data(), data_, size_) == 0;
+        }
+
+    private:
+        const char *data_;
+        std::size_t size_;
+        std::uint64_t hash_;
+    };
+
+    namespace literals
+    {
+        /// "age"_name：编译期计算哈希的名字引用
+        constexpr NameRef operator"" _name(const char *data, std::size_t size)
+        {
+            return NameRef(data, size, nameHash(data, size));
+        }
+    }
+
+} // namespace Evently
+
+/**
+ * @brief 字符串字面量的名字引用，哈希保证在编译期计算
+ */
+#define EVENTLY_NAME(literal)                                       \
+    ::Evently::NameRef(literal, sizeof(literal) - 1,                \
+                       std::integral_constant<std::uint64_t,        \
+                                              ::Evently::nameHash(literal, sizeof(literal) - 1)>::value)
+
+#endif // NAME_REF_H
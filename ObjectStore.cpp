@@ -0,0 +1,464 @@
+#include "ObjectStore.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    const ObjectStore::Id ObjectStore::npos;
+
+    ObjectStore::ObjectStore(const ReflectionRegistry &registry, const std::string &className)
+        : registry_(registry), className_(className), factory_(registry.factory(className)),
+          table_(registry.memberTable(className)), stride_(0), blockObjects_(0), size_(0)
+    {
+        if (factory_ == nullptr)
+        {
+            throw std::runtime_error("类没有注册工厂: " + className);
+        }
+        if (factory_->size() == 0)
+        {
+            throw std::runtime_error("工厂不支持就地构造: " + className);
+        }
+        if (table_ == nullptr)
+        {
+            throw std::runtime_error("类没有注册字段: " + className);
+        }
+        const std::size_t alignment = factory_->alignment();
+        stride_ = (factory_->size() + alignment - 1) / alignment * alignment;
+        // 每块约 64 KB，至少 16 个对象
+        blockObjects_ = std::max<std::size_t>(16, 65536 / stride_);
+    }
+
+    ObjectStore::~ObjectStore()
+    {
+        clear();
+    }
+
+    void *ObjectStore::slot(Id id) const
+    {
+        return alignedBlocks_[id / blockObjects_] + (id % blockObjects_) * stride_;
+    }
+
+    ObjectStore::Id ObjectStore::allocate()
+    {
+        if (!freeSlots_.empty())
+        {
+            Id id = freeSlots_.back();
+            freeSlots_.pop_back();
+            return id;
+        }
+        const Id id = live_.size();
+        if (id == alignedBlocks_.size() * blockObjects_)
+        {
+            const std::size_t alignment = factory_->alignment();
+            std::unique_ptr<char[]> block(new char[blockObjects_ * stride_ + alignment]);
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.get());
+            const std::uintptr_t aligned = (address + alignment - 1) / alignment * alignment;
+            alignedBlocks_.push_back(block.get() + (aligned - address));
+            blocks_.push_back(std::move(block));
+        }
+        live_.push_back(false);
+        return id;
+    }
+
+    void ObjectStore::release(Id id)
+    {
+        live_[id] = false;
+        freeSlots_.push_back(id);
+    }
+
+    ObjectStore::Id ObjectStore::insert()
+    {
+        const Id id = allocate();
+        try
+        {
+            factory_->construct(slot(id));
+        }
+        catch (...)
+        {
+            freeSlots_.push_back(id);
+            throw;
+        }
+        live_[id] = true;
+        ++size_;
+        for (auto &index : indexes_)
+        {
+            indexObject(index, id, slot(id));
+        }
+        return id;
+    }
+
+    ObjectStore::Id ObjectStore::insert(const void *source)
+    {
+        const Id id = allocate();
+        void *object = slot(id);
+        try
+        {
+            factory_->construct(object);
+        }
+        catch (...)
+        {
+            freeSlots_.push_back(id);
+            throw;
+        }
+        try
+        {
+            registry_.copyInto(className_, object, source);
+        }
+        catch (...)
+        {
+            factory_->destroy(object);
+            freeSlots_.push_back(id);
+            throw;
+        }
+        live_[id] = true;
+        ++size_;
+        for (auto &index : indexes_)
+        {
+            indexObject(index, id, object);
+        }
+        return id;
+    }
+
+    const void *ObjectStore::checked(Id id) const
+    {
+        if (!contains(id))
+        {
+            throw std::out_of_range("对象不存在: " + className_ + "#" + std::to_string(id));
+        }
+        return slot(id);
+    }
+
+    void ObjectStore::erase(Id id)
+    {
+        void *object = const_cast<void *>(checked(id));
+        for (auto &index : indexes_)
+        {
+            unindexObject(index, id, object);
+        }
+        factory_->destroy(object);
+        release(id);
+        --size_;
+    }
+
+    void ObjectStore::clear()
+    {
+        for (auto &index : indexes_)
+        {
+            if (index.hashed)
+            {
+                index.hashed->clear();
+            }
+            if (index.ordered)
+            {
+                index.ordered->clear();
+            }
+        }
+        for (Id id = 0; id < live_.size(); ++id)
+        {
+            if (live_[id])
+            {
+                factory_->destroy(slot(id));
+            }
+        }
+        live_.clear();
+        freeSlots_.clear();
+        alignedBlocks_.clear();
+        blocks_.clear();
+        size_ = 0;
+    }
+
+    const void *ObjectStore::get(Id id) const
+    {
+        return checked(id);
+    }
+
+    Any ObjectStore::get(Id id, const std::string &fieldName) const
+    {
+        const void *object = checked(id);
+        const std::size_t field = table_->findField(NameRef(fieldName));
+        if (field == MemberTable::npos)
+        {
+            throw std::invalid_argument("字段不存在: " + className_ + "::" + fieldName);
+        }
+        return table_->field(field).get(object);
+    }
+
+    void ObjectStore::set(Id id, const std::string &fieldName, const Any &value)
+    {
+        void *object = const_cast<void *>(checked(id));
+        const std::size_t found = table_->findField(NameRef(fieldName));
+        if (found == MemberTable::npos)
+        {
+            throw std::invalid_argument("字段不存在: " + className_ + "::" + fieldName);
+        }
+        const FieldThunk &field = table_->field(found);
+        if (!field.writable())
+        {
+            throw std::invalid_argument("PropertySetter: Cannot set value of const field");
+        }
+        if (value.type() != field.fieldType())
+        {
+            throw std::invalid_argument("PropertySetter: Invalid type for field");
+        }
+
+        // 只有建在同一成员上的索引受影响（同一成员可能以多个名字注册）
+        const void *address = field.fieldAddress(object);
+        std::vector<Index *> affected;
+        for (auto &index : indexes_)
+        {
+            if (index.field.fieldAddress(object) == address)
+            {
+                unindexObject(index, id, object);
+                affected.push_back(&index);
+            }
+        }
+        try
+        {
+            field.set(object, value);
+        }
+        catch (...)
+        {
+            for (Index *index : affected)
+            {
+                indexObject(*index, id, object);
+            }
+            throw;
+        }
+        for (Index *index : affected)
+        {
+            indexObject(*index, id, object);
+        }
+    }
+
+    void ObjectStore::modify(Id id, const std::function<void(void *)> &mutate)
+    {
+        void *object = const_cast<void *>(checked(id));
+        for (auto &index : indexes_)
+        {
+            unindexObject(index, id, object);
+        }
+        try
+        {
+            mutate(object);
+        }
+        catch (...)
+        {
+            for (auto &index : indexes_)
+            {
+                indexObject(index, id, object);
+            }
+            throw;
+        }
+        for (auto &index : indexes_)
+        {
+            indexObject(index, id, object);
+        }
+    }
+
+    void ObjectStore::indexObject(Index &index, Id id, void *object)
+    {
+        const void *key = index.field.fieldAddress(object);
+        if (index.hashed)
+        {
+            index.hashed->insert(std::make_pair(key, id));
+        }
+        else
+        {
+            index.ordered->insert(Entry(key, id));
+        }
+    }
+
+    void ObjectStore::unindexObject(Index &index, Id id, void *object)
+    {
+        // 键是对象自身字段的地址，同值的其他对象按 id 区分
+        const void *key = index.field.fieldAddress(object);
+        if (index.hashed)
+        {
+            auto range = index.hashed->equal_range(key);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == id)
+                {
+                    index.hashed->erase(it);
+                    return;
+                }
+            }
+        }
+        else
+        {
+            index.ordered->erase(Entry(key, id));
+        }
+    }
+
+    ObjectStore::Index &ObjectStore::addIndex(const std::string &fieldName)
+    {
+        if (hasIndex(fieldName))
+        {
+            throw std::invalid_argument("字段已有索引: " + className_ + "::" + fieldName);
+        }
+        const std::size_t field = table_->findField(NameRef(fieldName));
+        if (field == MemberTable::npos)
+        {
+            throw std::invalid_argument("字段不存在: " + className_ + "::" + fieldName);
+        }
+        Index index;
+        index.fieldName = fieldName;
+        index.field = table_->field(field);
+        indexes_.push_back(std::move(index));
+        return indexes_.back();
+    }
+
+    void ObjectStore::addHashIndex(const std::string &fieldName)
+    {
+        const std::size_t found = table_->findField(NameRef(fieldName));
+        if (found != MemberTable::npos)
+        {
+            const TypeOps &ops = *table_->field(found).ops;
+            if (!ops.bitwise && (ops.hash == nullptr || ops.equals == nullptr))
+            {
+                throw std::invalid_argument("字段不可哈希: " + className_ + "::" + fieldName);
+            }
+        }
+        Index &index = addIndex(fieldName);
+        const TypeOps *ops = index.field.ops;
+        index.hashed.reset(new std::unordered_multimap<const void *, Id, ValueHash, ValueEqual>(
+            size_ + 16, ValueHash{ops}, ValueEqual{ops}));
+        for (Id id = 0; id < live_.size(); ++id)
+        {
+            if (live_[id])
+            {
+                indexObject(index, id, slot(id));
+            }
+        }
+    }
+
+    void ObjectStore::addOrderedIndex(const std::string &fieldName)
+    {
+        const std::size_t found = table_->findField(NameRef(fieldName));
+        if (found != MemberTable::npos && table_->field(found).ops->compare == nullptr)
+        {
+            throw std::invalid_argument("字段不支持排序: " + className_ + "::" + fieldName);
+        }
+        Index &index = addIndex(fieldName);
+        index.ordered.reset(new std::set<Entry, EntryLess>(EntryLess{ValueLess{index.field.ops}}));
+        for (Id id = 0; id < live_.size(); ++id)
+        {
+            if (live_[id])
+            {
+                indexObject(index, id, slot(id));
+            }
+        }
+    }
+
+    bool ObjectStore::hasIndex(const std::string &fieldName) const
+    {
+        return indexFor(fieldName) != nullptr;
+    }
+
+    const ObjectStore::Index *ObjectStore::indexFor(const std::string &fieldName) const
+    {
+        for (const auto &index : indexes_)
+        {
+            if (index.fieldName == fieldName)
+            {
+                return &index;
+            }
+        }
+        return nullptr;
+    }
+
+    const void *ObjectStore::keyAddress(const Index &index, const Any &key) const
+    {
+        if (key.type() != index.field.fieldType())
+        {
+            throw std::invalid_argument("键类型与字段类型不一致: " + className_ + "::" + index.fieldName);
+        }
+        return key.data();
+    }
+
+    std::vector<ObjectStore::Id> ObjectStore::find(const std::string &fieldName, const Any &key) const
+    {
+        const Index *index = indexFor(fieldName);
+        if (index == nullptr)
+        {
+            throw std::invalid_argument("字段没有索引: " + className_ + "::" + fieldName);
+        }
+        const void *address = keyAddress(*index, key);
+        std::vector<Id> result;
+        if (index->hashed)
+        {
+            auto range = index->hashed->equal_range(address);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                result.push_back(it->second);
+            }
+        }
+        else
+        {
+            auto end = index->ordered->upper_bound(Entry(address, npos));
+            for (auto it = index->ordered->lower_bound(Entry(address, 0)); it != end; ++it)
+            {
+                result.push_back(it->second);
+            }
+        }
+        return result;
+    }
+
+    ObjectStore::Id ObjectStore::findOne(const std::string &fieldName, const Any &key) const
+    {
+        const Index *index = indexFor(fieldName);
+        if (index == nullptr)
+        {
+            throw std::invalid_argument("字段没有索引: " + className_ + "::" + fieldName);
+        }
+        const void *address = keyAddress(*index, key);
+        if (index->hashed)
+        {
+            auto it = index->hashed->find(address);
+            return it != index->hashed->end() ? it->second : npos;
+        }
+        auto it = index->ordered->lower_bound(Entry(address, 0));
+        if (it == index->ordered->end() || index->ordered->key_comp().less(address, it->first))
+        {
+            return npos;
+        }
+        return it->second;
+    }
+
+    std::vector<ObjectStore::Id> ObjectStore::range(const std::string &fieldName, const Any &low,
+                                                    const Any &high) const
+    {
+        const Index *index = indexFor(fieldName);
+        if (index == nullptr || !index->ordered)
+        {
+            throw std::invalid_argument("字段没有有序索引: " + className_ + "::" + fieldName);
+        }
+        const void *lowKey = keyAddress(*index, low);
+        const void *highKey = keyAddress(*index, high);
+        std::vector<Id> result;
+        if (index->field.ops->compare(lowKey, highKey) > 0)
+        {
+            return result;
+        }
+        auto end = index->ordered->upper_bound(Entry(highKey, npos));
+        for (auto it = index->ordered->lower_bound(Entry(lowKey, 0)); it != end; ++it)
+        {
+            result.push_back(it->second);
+        }
+        return result;
+    }
+
+    void ObjectStore::forEach(const std::function<void(Id, const void *)> &visit) const
+    {
+        for (Id id = 0; id < live_.size(); ++id)
+        {
+            if (live_[id])
+            {
+                visit(id, slot(id));
+            }
+        }
+    }
+
+} // namespace Evently
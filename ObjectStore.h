@@ -0,0 +1,173 @@
+#ifndef OBJECT_STORE_H
+#define OBJECT_STORE_H
+#pragma once
+
+#include "Any.h"
+#include "MemberTable.h"
+#include "Reflection.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 按类名管理一组对象的容器，支持在注册字段上建立哈希索引和有序索引
+     *
+     * 实例用类的工厂就地构造在按块分配的连续内存中（块内相邻，扩容不移动已有对象），
+     * 删除的槽位会被复用。索引以对象内字段的地址为键，不拷贝键值：
+     * 通过 set() 或 modify() 修改时只更新受影响的索引项；按键查找为 O(1)（哈希索引）
+     * 或 O(log n)（有序索引），范围查询只用于有序索引。哈希索引删除同值项时要在同值对象中查找，
+     * 适合取值分散的字段；重复值很多的字段应使用有序索引。
+     *
+     * 直接通过 get() 返回的指针修改已建索引的字段会使索引失效，应使用 set() 或 modify()。
+     *
+     * @code
+     * ObjectStore store(registry, "Person");
+     * store.addHashIndex("id");
+     * store.addOrderedIndex("age");
+     * ObjectStore::Id id = store.insert();
+     * store.set(id, "id", Any(42LL));
+     * std::vector<ObjectStore::Id> adults = store.range("age", Any(18), Any(65));
+     * @endcode
+     */
+    class ObjectStore
+    {
+    public:
+        typedef std::size_t Id;
+
+        /// @throws std::runtime_error 类没有注册工厂，或工厂不支持就地构造
+        ObjectStore(const ReflectionRegistry &registry, const std::string &className);
+        ~ObjectStore();
+
+        ObjectStore(const ObjectStore &) = delete;
+        ObjectStore &operator=(const ObjectStore &) = delete;
+
+        /// 用工厂构造一个新对象
+        Id insert();
+
+        /// 构造新对象并按字段元数据从 source 拷贝（见 ReflectionRegistry::copyInto）
+        Id insert(const void *source);
+
+        /// @throws std::out_of_range 对象不存在
+        void erase(Id id);
+        void clear();
+
+        bool contains(Id id) const { return id < live_.size() && live_[id]; }
+        std::size_t size() const { return size_; }
+
+        /// @throws std::out_of_range 对象不存在
+        const void *get(Id id) const;
+
+        template <typename T>
+        const T &get(Id id) const
+        {
+            return *static_cast<const T *>(get(id));
+        }
+
+        /// 读取字段值
+        /// @throws std::invalid_argument 字段不存在
+        Any get(Id id, const std::string &fieldName) const;
+
+        /**
+         * @brief 写入字段并更新该字段上的索引
+         * @throws std::invalid_argument 字段不存在、const 字段或值类型不匹配（此时索引保持不变）
+         */
+        void set(Id id, const std::string &fieldName, const Any &value);
+
+        /// 通过回调任意修改对象，之后重建该对象的全部索引项
+        void modify(Id id, const std::function<void(void *)> &mutate);
+
+        /// 在字段上建立哈希索引（已有对象立即加入）
+        /// @throws std::invalid_argument 字段不存在或不可哈希
+        void addHashIndex(const std::string &fieldName);
+
+        /// 在字段上建立有序索引（已有对象立即加入）
+        /// @throws std::invalid_argument 字段不存在或不支持 operator<
+        void addOrderedIndex(const std::string &fieldName);
+
+        bool hasIndex(const std::string &fieldName) const;
+
+        /**
+         * @brief 按字段值查找对象，使用该字段上的哈希索引或有序索引
+         * @throws std::invalid_argument 字段没有索引，或 key 的类型与字段类型不一致
+         */
+        std::vector<Id> find(const std::string &fieldName, const Any &key) const;
+
+        /// 第一个匹配的对象，没有时返回 npos
+        Id findOne(const std::string &fieldName, const Any &key) const;
+
+        /**
+         * @brief 字段值在 [low, high] 内的对象，按字段值升序
+         * @throws std::invalid_argument 字段没有有序索引，或键类型与字段类型不一致
+         */
+        std::vector<Id> range(const std::string &fieldName, const Any &low, const Any &high) const;
+
+        /// 按槽位顺序遍历全部对象
+        void forEach(const std::function<void(Id, const void *)> &visit) const;
+
+        static const Id npos = static_cast<Id>(-1);
+
+    private:
+        typedef std::pair<const void *, Id> Entry;
+
+        /// 有序索引按（字段值, id）排序，同值的对象也能按 id 以 O(log n) 删除
+        struct EntryLess
+        {
+            ValueLess less;
+
+            bool operator()(const Entry &a, const Entry &b) const
+            {
+                if (less(a.first, b.first))
+                {
+                    return true;
+                }
+                if (less(b.first, a.first))
+                {
+                    return false;
+                }
+                return a.second < b.second;
+            }
+        };
+
+        struct Index
+        {
+            std::string fieldName;
+            FieldThunk field;
+            std::unique_ptr<std::unordered_multimap<const void *, Id, ValueHash, ValueEqual>> hashed;
+            std::unique_ptr<std::set<Entry, EntryLess>> ordered;
+        };
+
+        void *slot(Id id) const;
+        Id allocate();
+        void release(Id id);
+        const void *checked(Id id) const;
+        const Index *indexFor(const std::string &fieldName) const;
+        Index &addIndex(const std::string &fieldName);
+        const void *keyAddress(const Index &index, const Any &key) const;
+        static void indexObject(Index &index, Id id, void *object);
+        static void unindexObject(Index &index, Id id, void *object);
+
+        const ReflectionRegistry &registry_;
+        std::string className_;
+        ObjectFactory *factory_;
+        const MemberTable *table_;
+        std::size_t stride_;
+        std::size_t blockObjects_;
+        std::vector<std::unique_ptr<char[]>> blocks_; ///< 原始分配（含对齐余量）
+        std::vector<char *> alignedBlocks_;
+        std::vector<bool> live_;
+        std::vector<Id> freeSlots_;
+        std::size_t size_;
+        std::vector<Index> indexes_;
+    };
+
+} // namespace Evently
+
+#endif // OBJECT_STORE_H
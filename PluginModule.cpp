@@ -0,0 +1,121 @@
+#include "PluginModule.h"
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace Evently
+{
+
+    namespace
+    {
+        struct TrackedInstance
+        {
+            void (*deleter)(void *);
+            PluginModule *module;
+        };
+
+        // 删除器只能是函数指针，实例所属的模块和原删除器记录在全局表中
+        std::mutex &trackedMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::unordered_map<void *, TrackedInstance> &trackedInstances()
+        {
+            static std::unordered_map<void *, TrackedInstance> instances;
+            return instances;
+        }
+    } // namespace
+
+    PluginModule::PluginModule(const std::string &path) : path_(path), handle_(nullptr), liveInstances_(0)
+    {
+    }
+
+    PluginHook PluginModule::open()
+    {
+        if (handle_ == nullptr)
+        {
+#if defined(_WIN32)
+            handle_ = reinterpret_cast<void *>(LoadLibraryA(path_.c_str()));
+            if (handle_ == nullptr)
+            {
+                throw std::runtime_error("无法加载插件模块: " + path_);
+            }
+#else
+            handle_ = dlopen(path_.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (handle_ == nullptr)
+            {
+                const char *error = dlerror();
+                throw std::runtime_error("无法加载插件模块: " + path_ + (error != nullptr ? ": " + std::string(error) : ""));
+            }
+#endif
+        }
+
+#if defined(_WIN32)
+        FARPROC symbol = GetProcAddress(reinterpret_cast<HMODULE>(handle_), "evently_register_module");
+#else
+        void *symbol = dlsym(handle_, "evently_register_module");
+#endif
+        if (symbol == nullptr)
+        {
+            close();
+            throw std::runtime_error("插件模块没有导出注册函数: " + path_);
+        }
+        PluginHook hook;
+        static_assert(sizeof(hook) == sizeof(symbol), "函数指针与符号地址大小不同");
+        std::memcpy(&hook, &symbol, sizeof(hook));
+        return hook;
+    }
+
+    void PluginModule::close()
+    {
+        if (handle_ == nullptr)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        FreeLibrary(reinterpret_cast<HMODULE>(handle_));
+#else
+        dlclose(handle_);
+#endif
+        handle_ = nullptr;
+    }
+
+    std::unique_ptr<void, void (*)(void *)> PluginModule::track(std::unique_ptr<void, void (*)(void *)> instance)
+    {
+        if (!instance)
+        {
+            return instance;
+        }
+        TrackedInstance tracked = {instance.get_deleter(), this};
+        {
+            std::lock_guard<std::mutex> lock(trackedMutex());
+            trackedInstances()[instance.get()] = tracked;
+        }
+        liveInstances_.fetch_add(1, std::memory_order_acq_rel);
+        return std::unique_ptr<void, void (*)(void *)>(instance.release(), &PluginModule::release);
+    }
+
+    void PluginModule::release(void *instance)
+    {
+        TrackedInstance tracked;
+        {
+            std::lock_guard<std::mutex> lock(trackedMutex());
+            auto it = trackedInstances().find(instance);
+            tracked = it->second;
+            trackedInstances().erase(it);
+        }
+        // 原删除器在模块内，先删除再减计数，计数归零后模块才可能被卸载
+        tracked.deleter(instance);
+        tracked.module->liveInstances_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+} // namespace Evently
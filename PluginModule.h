@@ -0,0 +1,85 @@
+#ifndef PLUGIN_MODULE_H
+#define PLUGIN_MODULE_H
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <string>
+
+#if defined(_WIN32)
+#define EVENTLY_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define EVENTLY_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/**
+ * @brief 定义插件模块的注册函数
+ *
+ * @code
+ * EVENTLY_PLUGIN(registry)
+ * {
+ *     registry.registerClass<Greeter>("Greeter");
+ *     registry.registerField<Greeter>("Greeter", "name", &Greeter::name_);
+ * }
+ * @endcode
+ */
+#define EVENTLY_PLUGIN(registry) \
+    extern "C" EVENTLY_PLUGIN_EXPORT void evently_register_module(::Evently::ReflectionRegistry &registry)
+
+namespace Evently
+{
+
+    class ReflectionRegistry;
+
+    /// 插件模块导出的注册函数
+    typedef void (*PluginHook)(ReflectionRegistry &registry);
+
+    /**
+     * @brief 按需加载的插件模块（共享库）
+     *
+     * 由注册表持有并在加载锁内打开、关闭；记录加载期间注册的类，
+     * 以及由 createInstance 创建、尚未释放的实例数。
+     * 析构时不关闭共享库（进程退出时其中的静态对象可能仍被引用）。
+     */
+    class PluginModule
+    {
+    public:
+        explicit PluginModule(const std::string &path);
+
+        const std::string &path() const { return path_; }
+        bool loaded() const { return handle_ != nullptr; }
+
+        /// 仍存活的实例数
+        std::size_t liveInstances() const { return liveInstances_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 接管模块中的类创建的实例：实例释放时计数减一
+         */
+        std::unique_ptr<void, void (*)(void *)> track(std::unique_ptr<void, void (*)(void *)> instance);
+
+    private:
+        friend class ReflectionRegistry;
+
+        PluginModule(const PluginModule &) = delete;
+        PluginModule &operator=(const PluginModule &) = delete;
+
+        /**
+         * @brief 打开共享库并取得注册函数
+         * @throws std::runtime_error 无法打开或没有导出注册函数
+         */
+        PluginHook open();
+        void close();
+
+        static void release(void *instance);
+
+        std::string path_;
+        void *handle_;
+        std::atomic<std::size_t> liveInstances_;
+        std::set<std::string> classes_; ///< 加载期间注册的类
+    };
+
+} // namespace Evently
+
+#endif // PLUGIN_MODULE_H
@@ -0,0 +1,147 @@
+#include "PropertyPath.h"
+#include <functional>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    PropertyPath::PropertyPath(const std::string &className, const std::string &path)
+        : className_(className), path_(path), valueOps_(&TypeOps::of<void>()), writable_(true) {}
+
+    const void *PropertyPath::address(const void *instance) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+
+        const char *current = static_cast<const char *>(instance);
+        for (const auto &step : steps_)
+        {
+            current += step.offset;
+            if (step.container != nullptr)
+            {
+                if (step.index >= step.container->size(current))
+                {
+                    throw std::out_of_range("属性路径下标越界: " + className_ + "::" + path_);
+                }
+                current = static_cast<const char *>(step.container->at(current, step.index));
+            }
+        }
+        return current;
+    }
+
+    Any PropertyPath::get(const void *instance) const
+    {
+        if (valueOps_->box == nullptr)
+        {
+            throw std::invalid_argument("属性路径的值类型不可拷贝: " + className_ + "::" + path_);
+        }
+        return valueOps_->box(address(instance));
+    }
+
+    void PropertyPath::set(void *instance, const Any &value) const
+    {
+        checkType(value.type());
+        checkWritable();
+        if (valueOps_->assign == nullptr)
+        {
+            throw std::invalid_argument("属性路径的值类型不可赋值: " + className_ + "::" + path_);
+        }
+        valueOps_->assign(address(instance), value.data());
+    }
+
+    void PropertyPath::checkType(const std::type_info &type) const
+    {
+        if (type != *valueOps_->type)
+        {
+            throw std::invalid_argument("属性路径的值类型不匹配: " + className_ + "::" + path_);
+        }
+    }
+
+    void PropertyPath::checkWritable() const
+    {
+        if (!writable_)
+        {
+            throw std::invalid_argument("属性路径经过 const 字段，不可写: " + className_ + "::" + path_);
+        }
+    }
+
+    std::size_t PropertyPathCache::KeyHash::operator()(const Key &key) const
+    {
+        std::size_t seed = std::hash<std::string>()(key.first);
+        return seed ^ (std::hash<std::string>()(key.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    PropertyPathCache::PropertyPathCache(std::size_t capacity) : capacity_(capacity) {}
+
+    std::shared_ptr<const PropertyPath> PropertyPathCache::find(const std::string &className,
+                                                                const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(std::make_pair(className, path));
+        if (it == index_.end())
+        {
+            return std::shared_ptr<const PropertyPath>();
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void PropertyPathCache::insert(std::shared_ptr<const PropertyPath> resolved)
+    {
+        Key key(resolved->className(), resolved->path());
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity_ == 0)
+        {
+            return;
+        }
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            // 其他线程已先插入同一路径
+            it->second->second = std::move(resolved);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.push_front(std::make_pair(key, std::move(resolved)));
+        index_[key] = entries_.begin();
+        trimLocked();
+    }
+
+    void PropertyPathCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        index_.clear();
+    }
+
+    void PropertyPathCache::setCapacity(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        trimLocked();
+    }
+
+    std::size_t PropertyPathCache::capacity() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capacity_;
+    }
+
+    std::size_t PropertyPathCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    void PropertyPathCache::trimLocked()
+    {
+        while (entries_.size() > capacity_)
+        {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+} // namespace Evently
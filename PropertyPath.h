@@ -0,0 +1,147 @@
+#ifndef PROPERTY_PATH_H
+#define PROPERTY_PATH_H
+#pragma once
+
+#include "Any.h"
+#include "ContainerView.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 解析后的嵌套属性路径（如 "customer.address.city"、"items[3].price"）
+     *
+     * 路径由 ReflectionRegistry::resolvePath 解析一次，连续的成员访问合并为一个字节偏移，
+     * 下标访问保存容器操作表和下标。之后每次访问只做指针运算，不拷贝中间对象，也不查表。
+     * 下标在每次访问时检查越界。
+     */
+    class PropertyPath
+    {
+    public:
+        const std::string &className() const { return className_; }
+        const std::string &path() const { return path_; }
+
+        /// 路径末端值的类型
+        const std::type_info &valueType() const { return *valueOps_->type; }
+        const TypeOps &valueOps() const { return *valueOps_; }
+
+        /// 路径上没有 const 字段时才可写
+        bool writable() const { return writable_; }
+
+        /**
+         * @brief 路径末端值在实例中的地址
+         * @throws std::out_of_range 下标越界
+         */
+        const void *address(const void *instance) const;
+        void *address(void *instance) const
+        {
+            return const_cast<void *>(address(static_cast<const void *>(instance)));
+        }
+
+        /// 类型化读取（返回实例内部的引用，不拷贝）
+        template <typename T>
+        const T &value(const void *instance) const
+        {
+            checkType(typeid(T));
+            return *static_cast<const T *>(address(instance));
+        }
+
+        /// 类型化写入
+        template <typename T>
+        void setValue(void *instance, const T &value) const
+        {
+            checkType(typeid(T));
+            checkWritable();
+            *static_cast<T *>(address(instance)) = value;
+        }
+
+        /// 末端为容器时返回其视图（经过 const 字段时为只读视图）
+        ContainerView container(void *instance) const
+        {
+            return ContainerView(*valueOps_, address(instance), writable_);
+        }
+
+        ContainerView container(const void *instance) const
+        {
+            return ContainerView(*valueOps_, address(instance), false);
+        }
+
+        /// 读取到 Any（只拷贝末端值）
+        Any get(const void *instance) const;
+        /// 从 Any 写入，类型必须与 valueType() 一致
+        void set(void *instance, const Any &value) const;
+
+    private:
+        friend class ReflectionRegistry;
+
+        /**
+         * @brief 一步访问：先加上字节偏移，再按需取容器元素
+         */
+        struct Step
+        {
+            std::ptrdiff_t offset;
+            const ContainerOps *container; ///< 为 nullptr 时只做偏移
+            std::size_t index;
+        };
+
+        PropertyPath(const std::string &className, const std::string &path);
+
+        void checkType(const std::type_info &type) const;
+        void checkWritable() const;
+
+        std::string className_;
+        std::string path_;
+        std::vector<Step> steps_;
+        const TypeOps *valueOps_;
+        bool writable_;
+    };
+
+    /**
+     * @brief 已解析路径的 LRU 缓存（线程安全）
+     *
+     * 以 (类名, 路径) 为键，容量满时淘汰最久未使用的路径。
+     * 缓存中的路径以 shared_ptr 持有，被淘汰后调用方手中的路径仍然有效。
+     */
+    class PropertyPathCache
+    {
+    public:
+        explicit PropertyPathCache(std::size_t capacity);
+
+        /// 命中时把路径移到最近使用的位置，未命中返回空指针
+        std::shared_ptr<const PropertyPath> find(const std::string &className, const std::string &path);
+        void insert(std::shared_ptr<const PropertyPath> resolved);
+        void clear();
+
+        void setCapacity(std::size_t capacity);
+        std::size_t capacity() const;
+        std::size_t size() const;
+
+    private:
+        typedef std::pair<std::string, std::string> Key;
+        typedef std::list<std::pair<Key, std::shared_ptr<const PropertyPath>>> Entries;
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key &key) const;
+        };
+
+        void trimLocked();
+
+        mutable std::mutex mutex_;
+        std::size_t capacity_;
+        Entries entries_; ///< 表头为最近使用
+        std::unordered_map<Key, Entries::iterator, KeyHash> index_;
+    };
+
+} // namespace Evently
+
+#endif // PROPERTY_PATH_H
@@ -0,0 +1,570 @@
+#include "Query.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Evently
+{
+
+    namespace
+    {
+        using detail::QueryConstant;
+        using detail::QueryMatcher;
+
+        struct EqualTo
+        {
+            template <typename T>
+            static bool apply(const T &a, const T &b) { return a == b; }
+        };
+
+        struct NotEqualTo
+        {
+            template <typename T>
+            static bool apply(const T &a, const T &b) { return !(a == b); }
+        };
+
+        struct Less
+        {
+            template <typename T>
+            static bool apply(const T &a, const T &b) { return a < b; }
+        };
+
+        struct LessEqual
+        {
+            template <typename T>
+            static bool apply(const T &a, const T &b) { return !(b < a); }
+        };
+
+        struct Greater
+        {
+            template <typename T>
+            static bool apply(const T &a, const T &b) { return b < a; }
+        };
+
+        struct GreaterEqual
+        {
+            template <typename T>
+            static bool apply(const T &a, const T &b) { return !(a < b); }
+        };
+
+        inline const long long &constantAs(const QueryConstant &constant, long long *) { return constant.integer; }
+        inline const unsigned long long &constantAs(const QueryConstant &constant, unsigned long long *)
+        {
+            return constant.unsignedInteger;
+        }
+        inline const double &constantAs(const QueryConstant &constant, double *) { return constant.floating; }
+        inline const std::string &constantAs(const QueryConstant &constant, std::string *) { return constant.text; }
+
+        /// 读取 Field 类型的字段，转换为比较类型 Canonical 后与常量比较
+        template <typename Field, typename Canonical, typename Compare>
+        bool match(const void *field, const QueryConstant &constant)
+        {
+            return Compare::apply(static_cast<Canonical>(*static_cast<const Field *>(field)),
+                                  constantAs(constant, static_cast<Canonical *>(nullptr)));
+        }
+
+        template <typename Compare>
+        bool matchString(const void *field, const QueryConstant &constant)
+        {
+            return Compare::apply(*static_cast<const std::string *>(field), constant.text);
+        }
+
+        template <typename Field, typename Canonical>
+        QueryMatcher matcherFor(Query::Op op)
+        {
+            switch (op)
+            {
+            case Query::Op::Equal:
+                return &match<Field, Canonical, EqualTo>;
+            case Query::Op::NotEqual:
+                return &match<Field, Canonical, NotEqualTo>;
+            case Query::Op::Less:
+                return &match<Field, Canonical, Less>;
+            case Query::Op::LessEqual:
+                return &match<Field, Canonical, LessEqual>;
+            case Query::Op::Greater:
+                return &match<Field, Canonical, Greater>;
+            case Query::Op::GreaterEqual:
+            default:
+                return &match<Field, Canonical, GreaterEqual>;
+            }
+        }
+
+        QueryMatcher stringMatcherFor(Query::Op op)
+        {
+            switch (op)
+            {
+            case Query::Op::Equal:
+                return &matchString<EqualTo>;
+            case Query::Op::NotEqual:
+                return &matchString<NotEqualTo>;
+            case Query::Op::Less:
+                return &matchString<Less>;
+            case Query::Op::LessEqual:
+                return &matchString<LessEqual>;
+            case Query::Op::Greater:
+                return &matchString<Greater>;
+            case Query::Op::GreaterEqual:
+            default:
+                return &matchString<GreaterEqual>;
+            }
+        }
+
+        /// 比较常量的数值形式
+        struct Number
+        {
+            bool integral;
+            bool negative;
+            bool fitsSigned; ///< 整数值在 long long 范围内
+            long long integer;
+            unsigned long long unsignedInteger;
+            double floating;
+        };
+
+        template <typename T>
+        void fillNumber(T value, Number &number, std::true_type /* 整数 */)
+        {
+            number.integral = true;
+            number.negative = value < static_cast<T>(0);
+            number.integer = static_cast<long long>(value);
+            number.unsignedInteger = static_cast<unsigned long long>(value);
+            number.floating = static_cast<double>(value);
+            number.fitsSigned =
+                number.negative || number.unsignedInteger <= static_cast<unsigned long long>(LLONG_MAX);
+        }
+
+        template <typename T>
+        void fillNumber(T value, Number &number, std::false_type /* 浮点 */)
+        {
+            number.integral = false;
+            number.negative = value < static_cast<T>(0);
+            number.fitsSigned = false;
+            number.integer = 0;
+            number.unsignedInteger = 0;
+            number.floating = static_cast<double>(value);
+        }
+
+        template <typename T>
+        bool tryNumber(const Any &value, Number &number)
+        {
+            const T *typed = any_cast<T>(&value);
+            if (typed == nullptr)
+            {
+                return false;
+            }
+            fillNumber(*typed, number, std::is_integral<T>());
+            return true;
+        }
+
+        bool readNumber(const Any &value, Number &number)
+        {
+            return tryNumber<int>(value, number) || tryNumber<long long>(value, number) ||
+                   tryNumber<double>(value, number) || tryNumber<unsigned int>(value, number) ||
+                   tryNumber<long>(value, number) || tryNumber<unsigned long>(value, number) ||
+                   tryNumber<unsigned long long>(value, number) || tryNumber<float>(value, number) ||
+                   tryNumber<short>(value, number) || tryNumber<unsigned short>(value, number) ||
+                   tryNumber<char>(value, number) || tryNumber<signed char>(value, number) ||
+                   tryNumber<unsigned char>(value, number) || tryNumber<bool>(value, number) ||
+                   tryNumber<long double>(value, number);
+        }
+
+        bool readText(const Any &value, std::string &text)
+        {
+            if (const std::string *typed = any_cast<std::string>(&value))
+            {
+                text = *typed;
+                return true;
+            }
+            if (const char *const *typed = any_cast<const char *>(&value))
+            {
+                text = *typed != nullptr ? *typed : "";
+                return true;
+            }
+            if (char *const *typed = any_cast<char *>(&value))
+            {
+                text = *typed != nullptr ? *typed : "";
+                return true;
+            }
+            return false;
+        }
+
+        /// 有符号整数字段：整数常量按 long long 比较，其余按 double
+        template <typename Field>
+        QueryMatcher signedMatcher(Query::Op op, const Number &number, QueryConstant &constant)
+        {
+            if (number.integral && number.fitsSigned)
+            {
+                constant.integer = number.integer;
+                return matcherFor<Field, long long>(op);
+            }
+            constant.floating = number.floating;
+            return matcherFor<Field, double>(op);
+        }
+
+        /// 无符号整数字段：非负整数常量按 unsigned long long 比较，其余按 double
+        template <typename Field>
+        QueryMatcher unsignedMatcher(Query::Op op, const Number &number, QueryConstant &constant)
+        {
+            if (number.integral && !number.negative)
+            {
+                constant.unsignedInteger = number.unsignedInteger;
+                return matcherFor<Field, unsigned long long>(op);
+            }
+            constant.floating = number.floating;
+            return matcherFor<Field, double>(op);
+        }
+
+        template <typename Field>
+        QueryMatcher floatingMatcher(Query::Op op, const Number &number, QueryConstant &constant)
+        {
+            constant.floating = number.floating;
+            return matcherFor<Field, double>(op);
+        }
+
+        /// 按字段的值类型选择匹配函数，并把常量写成对应的比较类型
+        QueryMatcher compileMatcher(ValueKind kind, Query::Op op, const Number &number, QueryConstant &constant)
+        {
+            switch (kind)
+            {
+            case ValueKind::Bool:
+                return signedMatcher<bool>(op, number, constant);
+            case ValueKind::Char:
+                return signedMatcher<char>(op, number, constant);
+            case ValueKind::SignedChar:
+                return signedMatcher<signed char>(op, number, constant);
+            case ValueKind::UnsignedChar:
+                return unsignedMatcher<unsigned char>(op, number, constant);
+            case ValueKind::Short:
+                return signedMatcher<short>(op, number, constant);
+            case ValueKind::UnsignedShort:
+                return unsignedMatcher<unsigned short>(op, number, constant);
+            case ValueKind::Int:
+                return signedMatcher<int>(op, number, constant);
+            case ValueKind::UnsignedInt:
+                return unsignedMatcher<unsigned int>(op, number, constant);
+            case ValueKind::Long:
+                return signedMatcher<long>(op, number, constant);
+            case ValueKind::UnsignedLong:
+                return unsignedMatcher<unsigned long>(op, number, constant);
+            case ValueKind::LongLong:
+                return signedMatcher<long long>(op, number, constant);
+            case ValueKind::UnsignedLongLong:
+                return unsignedMatcher<unsigned long long>(op, number, constant);
+            case ValueKind::Float:
+                return floatingMatcher<float>(op, number, constant);
+            case ValueKind::Double:
+                return floatingMatcher<double>(op, number, constant);
+            case ValueKind::LongDouble:
+                return floatingMatcher<long double>(op, number, constant);
+            default:
+                return nullptr;
+            }
+        }
+
+        Query::Op parseOp(const std::string &op)
+        {
+            if (op == "==" || op == "=")
+            {
+                return Query::Op::Equal;
+            }
+            if (op == "!=" || op == "<>")
+            {
+                return Query::Op::NotEqual;
+            }
+            if (op == "<")
+            {
+                return Query::Op::Less;
+            }
+            if (op == "<=")
+            {
+                return Query::Op::LessEqual;
+            }
+            if (op == ">")
+            {
+                return Query::Op::Greater;
+            }
+            if (op == ">=")
+            {
+                return Query::Op::GreaterEqual;
+            }
+            throw std::invalid_argument("无效的比较运算符: " + op);
+        }
+
+        std::size_t offsetOf(const FieldThunk &field, const char *object)
+        {
+            return static_cast<std::size_t>(static_cast<const char *>(field.fieldAddress(object)) - object);
+        }
+
+        /// 每个工作线程约分到 4 个分块
+        std::size_t grainFor(const ThreadPool &pool, std::size_t count)
+        {
+            std::size_t chunks = pool.workerCount() * 4;
+            std::size_t grain = (count + chunks - 1) / chunks;
+            return grain < 4096 ? 4096 : grain;
+        }
+    } // namespace
+
+    Query::Query(const ReflectionRegistry &registry, const std::string &className)
+        : registry_(registry), className_(className), table_(registry.memberTable(className)),
+          groupField_(), grouped_(false), parallel_(true)
+    {
+        if (table_ == nullptr || table_->fieldCount() == 0)
+        {
+            throw std::runtime_error("类没有注册字段: " + className);
+        }
+    }
+
+    const FieldThunk &Query::resolveField(const std::string &fieldName) const
+    {
+        std::size_t index = table_->findField(NameRef(fieldName));
+        if (index == MemberTable::npos)
+        {
+            throw std::invalid_argument("字段不存在: " + className_ + "::" + fieldName);
+        }
+        return table_->field(index);
+    }
+
+    Query &Query::where(const std::string &fieldName, const std::string &op, const Any &value)
+    {
+        return where(fieldName, parseOp(op), value);
+    }
+
+    Query &Query::where(const std::string &fieldName, Op op, const Any &value)
+    {
+        Condition condition;
+        condition.field = resolveField(fieldName);
+        condition.constant.integer = 0;
+        condition.constant.unsignedInteger = 0;
+        condition.constant.floating = 0;
+        condition.matcher = nullptr;
+
+        const ValueKind kind = condition.field.ops->kind;
+        if (kind == ValueKind::String)
+        {
+            if (readText(value, condition.constant.text))
+            {
+                condition.matcher = stringMatcherFor(op);
+            }
+        }
+        else
+        {
+            Number number;
+            if (readNumber(value, number))
+            {
+                condition.matcher = compileMatcher(kind, op, number, condition.constant);
+            }
+        }
+        if (condition.matcher == nullptr)
+        {
+            throw std::invalid_argument("常量不能与字段比较: " + className_ + "::" + fieldName);
+        }
+        conditions_.push_back(condition);
+        return *this;
+    }
+
+    Query &Query::orderBy(const std::string &fieldName, bool descending)
+    {
+        SortKey key = {resolveField(fieldName), descending};
+        if (key.field.ops->compare == nullptr)
+        {
+            throw std::invalid_argument("字段不支持排序: " + className_ + "::" + fieldName);
+        }
+        sortKeys_.push_back(key);
+        return *this;
+    }
+
+    Query &Query::groupBy(const std::string &fieldName)
+    {
+        const FieldThunk &field = resolveField(fieldName);
+        const TypeOps &ops = *field.ops;
+        if ((!ops.bitwise && (ops.hash == nullptr || ops.equals == nullptr)) || ops.box == nullptr)
+        {
+            throw std::invalid_argument("字段不能用于分组: " + className_ + "::" + fieldName);
+        }
+        groupField_ = field;
+        grouped_ = true;
+        return *this;
+    }
+
+    Query &Query::parallel(bool enabled)
+    {
+        parallel_ = enabled;
+        return *this;
+    }
+
+    std::vector<std::size_t> Query::filter(const char *base, std::size_t count, std::size_t stride,
+                                           bool parallel) const
+    {
+        std::vector<std::size_t> offsets;
+        for (const auto &condition : conditions_)
+        {
+            offsets.push_back(offsetOf(condition.field, base));
+        }
+        auto matches = [&](std::size_t index)
+        {
+            const char *object = base + index * stride;
+            for (std::size_t c = 0; c < conditions_.size(); ++c)
+            {
+                if (!conditions_[c].matcher(object + offsets[c], conditions_[c].constant))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        std::vector<std::size_t> result;
+        if (!parallel)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (matches(i))
+                {
+                    result.push_back(i);
+                }
+            }
+            return result;
+        }
+
+        // 每个分块写自己的结果，最后按分块顺序拼接，结果保持原顺序
+        const std::shared_ptr<ThreadPool> pool = registry_.asyncPool();
+        const std::size_t grain = grainFor(*pool, count);
+        std::vector<std::vector<std::size_t>> chunks((count + grain - 1) / grain);
+        pool->parallelFor(count, grain, [&](std::size_t begin, std::size_t end)
+                         {
+                             std::vector<std::size_t> &local = chunks[begin / grain];
+                             for (std::size_t i = begin; i < end; ++i)
+                             {
+                                 if (matches(i))
+                                 {
+                                     local.push_back(i);
+                                 }
+                             }
+                         });
+        std::size_t total = 0;
+        for (const auto &chunk : chunks)
+        {
+            total += chunk.size();
+        }
+        result.reserve(total);
+        for (const auto &chunk : chunks)
+        {
+            result.insert(result.end(), chunk.begin(), chunk.end());
+        }
+        return result;
+    }
+
+    void Query::sort(std::vector<std::size_t> &indices, const char *base, std::size_t stride, bool parallel) const
+    {
+        struct Key
+        {
+            int (*compare)(const void *, const void *);
+            std::size_t offset;
+            int sign;
+        };
+        std::vector<Key> keys;
+        for (const auto &sortKey : sortKeys_)
+        {
+            Key key = {sortKey.field.ops->compare, offsetOf(sortKey.field, base), sortKey.descending ? -1 : 1};
+            keys.push_back(key);
+        }
+        auto less = [&](std::size_t a, std::size_t b)
+        {
+            const char *left = base + a * stride;
+            const char *right = base + b * stride;
+            for (const auto &key : keys)
+            {
+                const int result = key.compare(left + key.offset, right + key.offset);
+                if (result != 0)
+                {
+                    return result * key.sign < 0;
+                }
+            }
+            return false;
+        };
+
+        const std::size_t count = indices.size();
+        if (!parallel)
+        {
+            std::stable_sort(indices.begin(), indices.end(), less);
+            return;
+        }
+
+        // 各分块并行排序，再逐轮两两归并；归并是稳定的，相等的对象保持原顺序
+        const std::shared_ptr<ThreadPool> pool = registry_.asyncPool();
+        const std::size_t grain = grainFor(*pool, count);
+        pool->parallelFor(count, grain, [&](std::size_t begin, std::size_t end)
+                          { std::stable_sort(indices.begin() + begin, indices.begin() + end, less); });
+        for (std::size_t width = grain; width < count; width *= 2)
+        {
+            const std::size_t pairs = (count + 2 * width - 1) / (2 * width);
+            pool->parallelFor(pairs, 1, [&](std::size_t begin, std::size_t end)
+                             {
+                                 for (std::size_t pair = begin; pair < end; ++pair)
+                                 {
+                                     const std::size_t low = pair * 2 * width;
+                                     const std::size_t middle = std::min(low + width, count);
+                                     const std::size_t high = std::min(low + 2 * width, count);
+                                     std::inplace_merge(indices.begin() + low, indices.begin() + middle,
+                                                        indices.begin() + high, less);
+                                 }
+                             });
+        }
+    }
+
+    std::vector<std::size_t> Query::select(const void *objects, std::size_t count, std::size_t stride) const
+    {
+        if (count == 0)
+        {
+            return std::vector<std::size_t>();
+        }
+        if (objects == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const char *base = static_cast<const char *>(objects);
+        std::vector<std::size_t> indices = filter(base, count, stride, parallel_ && count >= parallelThreshold);
+        if (!sortKeys_.empty())
+        {
+            sort(indices, base, stride, parallel_ && indices.size() >= parallelThreshold);
+        }
+        return indices;
+    }
+
+    std::vector<Query::Group> Query::group(const void *objects, std::size_t count, std::size_t stride) const
+    {
+        if (!grouped_)
+        {
+            throw std::runtime_error("没有设置分组字段");
+        }
+        std::vector<std::size_t> indices = select(objects, count, stride);
+        std::vector<Group> groups;
+        if (indices.empty())
+        {
+            return groups;
+        }
+
+        const char *base = static_cast<const char *>(objects);
+        const std::size_t offset = offsetOf(groupField_, base);
+        const TypeOps *ops = groupField_.ops;
+        // 键指向集合中第一个持有该值的对象的字段，不拷贝键值
+        std::unordered_map<const void *, std::size_t, ValueHash, ValueEqual> positions(16, ValueHash{ops},
+                                                                                      ValueEqual{ops});
+        for (std::size_t index : indices)
+        {
+            const void *key = base + index * stride + offset;
+            auto inserted = positions.insert(std::make_pair(key, groups.size()));
+            if (inserted.second)
+            {
+                groups.push_back(Group());
+                groups.back().key = ops->box(key);
+            }
+            groups[inserted.first->second].indices.push_back(index);
+        }
+        return groups;
+    }
+
+} // namespace Evently
@@ -0,0 +1,147 @@
+#ifndef QUERY_H
+#define QUERY_H
+#pragma once
+
+#include "Any.h"
+#include "MemberTable.h"
+#include "Reflection.h"
+#include "TypeOps.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Evently
+{
+
+    namespace detail
+    {
+        /// 查询条件的比较常量：按字段的比较类型保存
+        struct QueryConstant
+        {
+            long long integer;
+            unsigned long long unsignedInteger;
+            double floating;
+            std::string text;
+        };
+
+        typedef bool (*QueryMatcher)(const void *field, const QueryConstant &constant);
+    } // namespace detail
+
+    /**
+     * @brief 按字段名对对象集合做过滤、排序和分组
+     *
+     * 构建时把字段名解析为成员表项，比较常量转换为字段的比较类型，
+     * 每个条件编译为一个按字段类型实例化的匹配函数；执行时只按字段偏移读取，
+     * 不做字符串查找，也不构造 Any。集合足够大时过滤和排序在注册表的异步线程池上并行执行。
+     *
+     * 条件之间是“与”的关系；排序键按添加顺序比较，排序是稳定的。
+     *
+     * @code
+     * Query query(registry, "Person");
+     * query.where("money", ">", Any(100)).orderBy("age");
+     * std::vector<const Person *> rich = query.select(people);
+     * @endcode
+     */
+    class Query
+    {
+    public:
+        enum class Op
+        {
+            Equal,
+            NotEqual,
+            Less,
+            LessEqual,
+            Greater,
+            GreaterEqual
+        };
+
+        /// 一个分组：键值和组内对象的下标（按结果顺序）
+        struct Group
+        {
+            Any key;
+            std::vector<std::size_t> indices;
+        };
+
+        /// 不少于这么多对象时并行执行
+        static const std::size_t parallelThreshold = 16384;
+
+        Query(const ReflectionRegistry &registry, const std::string &className);
+
+        /**
+         * @brief 添加过滤条件，op 为 "=="、"!="、"<"、"<="、">"、">="
+         * @throws std::invalid_argument 字段不存在、运算符无效，或常量不能与字段比较
+         */
+        Query &where(const std::string &fieldName, const std::string &op, const Any &value);
+        Query &where(const std::string &fieldName, Op op, const Any &value);
+
+        /// @throws std::invalid_argument 字段不存在或不支持 operator<
+        Query &orderBy(const std::string &fieldName, bool descending = false);
+
+        /// @throws std::invalid_argument 字段不存在、不可哈希或不可拷贝
+        Query &groupBy(const std::string &fieldName);
+
+        /// 是否允许并行执行（默认允许）
+        Query &parallel(bool enabled);
+
+        /**
+         * @brief 过滤并排序，返回满足条件的对象下标
+         *
+         * objects 指向 count 个相隔 stride 字节的 className 实例。
+         */
+        std::vector<std::size_t> select(const void *objects, std::size_t count, std::size_t stride) const;
+
+        /// 过滤、排序后按 groupBy 字段分组，组按首次出现的顺序排列
+        /// @throws std::runtime_error 没有设置分组字段
+        std::vector<Group> group(const void *objects, std::size_t count, std::size_t stride) const;
+
+        template <typename T>
+        std::vector<const T *> select(const std::vector<T> &objects) const
+        {
+            std::vector<std::size_t> indices = select(objects.data(), objects.size(), sizeof(T));
+            std::vector<const T *> result;
+            result.reserve(indices.size());
+            for (std::size_t index : indices)
+            {
+                result.push_back(&objects[index]);
+            }
+            return result;
+        }
+
+        template <typename T>
+        std::vector<Group> group(const std::vector<T> &objects) const
+        {
+            return group(objects.data(), objects.size(), sizeof(T));
+        }
+
+    private:
+        struct Condition
+        {
+            FieldThunk field;
+            detail::QueryMatcher matcher;
+            detail::QueryConstant constant;
+        };
+
+        struct SortKey
+        {
+            FieldThunk field;
+            bool descending;
+        };
+
+        const FieldThunk &resolveField(const std::string &fieldName) const;
+        std::vector<std::size_t> filter(const char *base, std::size_t count, std::size_t stride,
+                                        bool parallel) const;
+        void sort(std::vector<std::size_t> &indices, const char *base, std::size_t stride, bool parallel) const;
+
+        const ReflectionRegistry &registry_;
+        std::string className_;
+        const MemberTable *table_;
+        std::vector<Condition> conditions_;
+        std::vector<SortKey> sortKeys_;
+        FieldThunk groupField_;
+        bool grouped_;
+        bool parallel_;
+    };
+
+} // namespace Evently
+
+#endif // QUERY_H
@@ -1,8 +1,15 @@
 #include "Reflection.h"
 #include "Any.h"
+#include "ComparePlan.h"
+#include "CopyPlan.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <stdexcept>
 #include <functional>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 namespace Evently
 {
@@ -29,131 +36,1816 @@ namespace Evently
         return instance;
     }
 
-    ReflectionRegistry::ReflectionRegistry()
+    ReflectionRegistry::ReflectionRegistry() : ReflectionRegistry(nullptr)
+    {
+    }
+
+    ReflectionRegistry::ReflectionRegistry(const ReflectionRegistry *parent)
+        : parent_(parent), loadingPlugin_(nullptr), pendingLazy_(0), activeLookups_(0), parkedLookups_(0),
+          writing_(false), loadingThread_(std::thread::id()), asyncWorkerCount_(0), writeListenerCount_(0),
+          pathCache_(256)
     {
         // 显式初始化所有成员容器（C++11兼容写法）
-        setters_ = std::unordered_map<std::pair<std::string, std::string>,
-                                      std::unique_ptr<PropertySetterBase>,
-                                      PairHash,
-                                      PairEqual>();
-        setterWritable_ = std::unordered_map<std::pair<std::string, std::string>, bool, PairHash, PairEqual>();
-        methods_ = std::unordered_map<std::pair<std::string, std::string>,
-                                      std::unique_ptr<MethodInvokerBase>,
-                                      PairHash,
-                                      PairEqual>();
-        methodNames_ = std::unordered_map<std::string, std::set<std::string>>();
-        classNames_ = std::unordered_map<std::string, std::string>();
-        factories_ = std::unordered_map<std::string, std::unique_ptr<ObjectFactory>>();
-    }
-
-    PropertySetterBase *ReflectionRegistry::getSetter(const std::string &className,
-                                                      const std::string &fieldName) const
+        classNames_ = std::unordered_map<NamePool::Id, NamePool::Id>();
+        factories_ = std::unordered_map<NamePool::Id, std::unique_ptr<ObjectFactory>>();
+        lazyRegistrars_ = std::unordered_map<NamePool::Id, ClassRegistrar>();
+    }
+
+    ReflectionRegistry::~ReflectionRegistry()
     {
-        // 参数验证
-        if (className.empty() || fieldName.empty())
+        // 类型槽位仍指向本层的枚举时改指向父注册表的同名枚举（没有则清空）
+        for (const auto &entry : enums_)
         {
-            return nullptr;
+            const EnumInfo *info = entry.second.get();
+            const EnumInfo *inherited = parent_ != nullptr ? parent_->enumInfo(entry.first) : nullptr;
+            if (inherited != nullptr && inherited->type() != info->type())
+            {
+                inherited = nullptr;
+            }
+            info->slot()->compare_exchange_strong(info, inherited, std::memory_order_acq_rel);
         }
-        // 构造查找键值并在设置器映射中查找
-        auto key = std::make_pair(className, fieldName);
-        auto it = setters_.find(key);
-        // const 字段不可写，返回 nullptr 表示无 setter
-        auto writableIt = setterWritable_.find(key);
-        if (writableIt != setterWritable_.end() && !writableIt->second)
+    }
+
+    void ReflectionRegistry::registerLazyClass(const std::string &className, ClassRegistrar registrar)
+    {
+        if (className.empty() || registrar == nullptr)
+        {
+            throw std::invalid_argument("延迟注册需要有效的类名和注册函数");
+        }
+        LoadLock load(*this);
+        WriteSection section(*this);
+        markOwned(className);
+        const NamePool::Id classId = names_.intern(className);
+        if (lazyRegistrars_.insert(std::make_pair(classId, registrar)).second)
+        {
+            pendingLazy_.fetch_add(1, std::memory_order_release);
+        }
+        else
+        {
+            lazyRegistrars_[classId] = registrar;
+        }
+        refreshLazyStateLocked(classId);
+    }
+
+    bool ReflectionRegistry::hasPendingRegistration(const std::string &className) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.hasPendingRegistration(className);
+        }
+        if (pendingLazy_.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+        LookupGuard guard(*this);
+        return lazyPending(NameRef(className));
+    }
+
+    const ReflectionRegistry &ReflectionRegistry::layerFor(const NameRef &className) const
+    {
+        // 最上层的注册表不记录归属，是所有类的最终归属
+        const ReflectionRegistry *layer = this;
+        while (layer->parent_ != nullptr && !layer->ownsClass(className))
+        {
+            layer = layer->parent_;
+        }
+        return *layer;
+    }
+
+    bool ReflectionRegistry::ownsClass(const NameRef &className) const
+    {
+        // 延迟加载期间注册函数可能正在修改名字池
+        LookupGuard guard;
+        if (pendingLazy_.load(std::memory_order_acquire) != 0)
+        {
+            guard = LookupGuard(*this);
+        }
+        NamePool::Id id = names_.find(className);
+        return id != NamePool::npos && ownedClasses_.count(id) != 0;
+    }
+
+    void ReflectionRegistry::markOwned(const std::string &className)
+    {
+        WriteSection section(*this);
+        if (parent_ != nullptr)
+        {
+            ownedClasses_.insert(names_.intern(className));
+        }
+        if (loadingPlugin_ != nullptr)
+        {
+            loadingPlugin_->classes_.insert(className);
+        }
+    }
+
+    void ReflectionRegistry::setClassName(const std::type_info &type, const std::string &className)
+    {
+        WriteSection section(*this);
+        classNames_[names_.intern(type.name())] = names_.intern(className);
+    }
+
+    std::string ReflectionRegistry::registeredClassName(const std::type_info &type) const
+    {
+        auto it = classNames_.find(names_.find(NameRef(type.name())));
+        return it != classNames_.end() ? names_.name(it->second) : std::string();
+    }
+
+    namespace
+    {
+        /// 本线程登记过查询的注册表：嵌套深度，以及是否计入了读者数
+        struct LookupSlot
+        {
+            const ReflectionRegistry *registry;
+            std::size_t depth;
+            bool counted;
+        };
+
+        thread_local std::vector<LookupSlot> lookupSlots;
+
+        LookupSlot *findLookupSlot(const ReflectionRegistry *registry)
         {
+            for (auto &slot : lookupSlots)
+            {
+                if (slot.registry == registry)
+                {
+                    return &slot;
+                }
+            }
             return nullptr;
         }
+    }
 
-        return it != setters_.end() ? it->second.get() : nullptr;
+    ReflectionRegistry::LookupGuard::LookupGuard(const ReflectionRegistry &registry) : registry_(&registry)
+    {
+        registry.beginLookup();
     }
 
-    std::unordered_map<std::string, Any> ReflectionRegistry::getAllValues(
-        const std::string &className, const void *instance) const
+    ReflectionRegistry::LookupGuard &ReflectionRegistry::LookupGuard::operator=(LookupGuard &&other) noexcept
     {
+        if (this != &other)
+        {
+            release();
+            registry_ = other.registry_;
+            other.registry_ = nullptr;
+        }
+        return *this;
+    }
 
-        std::unordered_map<std::string, Any> values;
+    ReflectionRegistry::LookupGuard::~LookupGuard()
+    {
+        release();
+    }
 
-        // 遍历所有已注册的属性设置器
-        for (const auto &pair : setters_)
+    void ReflectionRegistry::LookupGuard::release()
+    {
+        if (registry_ != nullptr)
         {
-            const auto &key = pair.first;     // (类名, 属性名)
-            const auto &setter = pair.second; // 属性设置器
+            registry_->endLookup();
+            registry_ = nullptr;
+        }
+    }
 
-            // 只处理指定类名的属性
-            if (key.first == className)
+    void ReflectionRegistry::beginLookup() const
+    {
+        LookupSlot *slot = findLookupSlot(this);
+        if (slot != nullptr)
+        {
+            ++slot->depth;
+            return;
+        }
+        // 加载线程自身（注册函数内部）的查询不计入读者，否则加载会等待自己
+        const bool loader = loadingThread_.load(std::memory_order_acquire) == std::this_thread::get_id();
+        if (!loader)
+        {
+            // 先计入读者再检查修改标志，与加载线程先置标志再检查读者数相对，两者至少一方能看到对方；
+            // 加载线程只在单次注册调用的修改期间置标志，这里的等待很短
+            while (true)
             {
-                values[key.second] = setter->get(instance);
+                activeLookups_.fetch_add(1, std::memory_order_seq_cst);
+                if (!writing_.load(std::memory_order_seq_cst))
+                {
+                    break;
+                }
+                activeLookups_.fetch_sub(1, std::memory_order_seq_cst);
+                while (writing_.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
             }
         }
-        return values;
+        LookupSlot entry = {this, 1, !loader};
+        lookupSlots.push_back(entry);
     }
 
-    Any ReflectionRegistry::getValues(const std::string &className,
-                                      const std::string &fieldName,
-                                      const void *instance) const
+    void ReflectionRegistry::endLookup() const
+    {
+        LookupSlot *slot = findLookupSlot(this);
+        if (slot == nullptr || --slot->depth != 0)
+        {
+            return;
+        }
+        if (slot->counted)
+        {
+            activeLookups_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+        *slot = lookupSlots.back();
+        lookupSlots.pop_back();
+    }
+
+    ReflectionRegistry::LoadLock::LoadLock(const ReflectionRegistry &registry) : registry_(registry), outermost_(false)
+    {
+        const LookupSlot *slot = findLookupSlot(&registry);
+        const bool reading = slot != nullptr && slot->counted;
+        if (reading)
+        {
+            registry.parkedLookups_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        registry.lazyMutex_.lock();
+        if (reading)
+        {
+            registry.parkedLookups_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        const std::thread::id self = std::this_thread::get_id();
+        if (registry.loadingThread_.load(std::memory_order_relaxed) == self)
+        {
+            return;
+        }
+        outermost_ = true;
+        registry.loadingThread_.store(self, std::memory_order_release);
+    }
+
+    ReflectionRegistry::LoadLock::~LoadLock()
+    {
+        if (outermost_)
+        {
+            registry_.loadingThread_.store(std::thread::id(), std::memory_order_release);
+        }
+        registry_.lazyMutex_.unlock();
+    }
+
+    ReflectionRegistry::WriteSection::WriteSection(const ReflectionRegistry &registry) : registry_(nullptr)
+    {
+        // 只有加载线程会置修改标志，标志已置时是本线程外层的区间
+        if (registry.loadingThread_.load(std::memory_order_acquire) != std::this_thread::get_id() ||
+            registry.writing_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        registry_ = &registry;
+        registry.writing_.store(true, std::memory_order_seq_cst);
+        // 等待其他线程的查询退出；本线程若已登记查询，自身也在读者数中
+        const LookupSlot *slot = findLookupSlot(&registry);
+        const std::size_t own = slot != nullptr && slot->counted ? 1 : 0;
+        while (registry.activeLookups_.load(std::memory_order_seq_cst) >
+               registry.parkedLookups_.load(std::memory_order_seq_cst) + own)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    ReflectionRegistry::WriteSection::~WriteSection()
+    {
+        if (registry_ != nullptr)
+        {
+            registry_->writing_.store(false, std::memory_order_seq_cst);
+        }
+    }
+
+    ReflectionRegistry::LookupGuard ReflectionRegistry::lockForLookup(const std::string &className) const
+    {
+        return lockForLookup(NameRef(className));
+    }
+
+    ReflectionRegistry::LookupGuard ReflectionRegistry::lockForLookup(const NameRef &className) const
+    {
+        // 所有延迟类加载完毕后，映射表不再变化，查询无需登记
+        if (pendingLazy_.load(std::memory_order_acquire) == 0)
+        {
+            return LookupGuard();
+        }
+        LookupGuard guard(*this);
+        loadIfPending(className);
+        return guard;
+    }
+
+    void ReflectionRegistry::loadIfPending(const NameRef &className) const
+    {
+        if (!lazyPending(className))
+        {
+            return;
+        }
+        // 只有该类仍待加载时才取得加载锁
+        LoadLock load(*this);
+        loadLazyClassLocked(names_.find(className));
+    }
+
+    bool ReflectionRegistry::lazyPending(const NameRef &className) const
+    {
+        NamePool::Id id = names_.find(className);
+        if (id == NamePool::npos)
+        {
+            return false;
+        }
+        auto state = lazyStates_.find(id);
+        return state != lazyStates_.end() && state->second.load(std::memory_order_acquire);
+    }
+
+    void ReflectionRegistry::refreshLazyStateLocked(NamePool::Id classId)
     {
-        // 遍历查找指定的属性
-        for (const auto &pair : setters_)
+        const bool pending = lazyRegistrars_.find(classId) != lazyRegistrars_.end() ||
+                             pendingPlugins_.find(classId) != pendingPlugins_.end();
+        if (pending)
+        {
+            lazyStates_[classId].store(true, std::memory_order_release);
+            return;
+        }
+        auto state = lazyStates_.find(classId);
+        if (state != lazyStates_.end())
         {
-            const auto &key = pair.first;     // (类名, 属性名)
-            const auto &setter = pair.second; // 属性设置器
+            state->second.store(false, std::memory_order_release);
+        }
+    }
 
-            // 找到匹配的类名和属性名
-            if (key.first == className && key.second == fieldName)
+    void ReflectionRegistry::loadLazyClassLocked(NamePool::Id classId) const
+    {
+        auto it = lazyRegistrars_.find(classId);
+        if (it == lazyRegistrars_.end())
+        {
+            auto plugin = pendingPlugins_.find(classId);
+            if (plugin != pendingPlugins_.end())
             {
-                return setter->get(instance);
+                loadPluginLocked(*plugin->second);
             }
+            return;
         }
+        ClassRegistrar registrar = it->second;
 
-        // 未找到则返回空Any对象
-        return Any();
+        // 先移除该注册函数登记的所有类名（含别名），保证只执行一次，
+        // 也避免注册函数内部的查询递归触发自身；待加载状态保留到注册函数执行完，
+        // 其他线程查询这些类时在 lazyMutex_ 上等待
+        auto *self = const_cast<ReflectionRegistry *>(this);
+        std::vector<NamePool::Id> loading;
+        for (auto entry = self->lazyRegistrars_.begin(); entry != self->lazyRegistrars_.end();)
+        {
+            if (entry->second == registrar)
+            {
+                loading.push_back(entry->first);
+                entry = self->lazyRegistrars_.erase(entry);
+            }
+            else
+            {
+                ++entry;
+            }
+        }
+
+        try
+        {
+            // 单例对象本身是非 const 的，延迟加载属于逻辑上的常量操作
+            registrar(*self);
+        }
+        catch (...)
+        {
+            finishLoadLocked(loading);
+            throw;
+        }
+        finishLoadLocked(loading);
     }
 
-    Any ReflectionRegistry::invokeMethod(const std::string &className,
-                                         const std::string &methodName,
-                                         void *instance,
-                                         const std::vector<Any> &args) const
+    void ReflectionRegistry::finishLoadLocked(const std::vector<NamePool::Id> &classIds) const
+    {
+        auto *self = const_cast<ReflectionRegistry *>(this);
+        for (NamePool::Id classId : classIds)
+        {
+            self->refreshLazyStateLocked(classId);
+        }
+        updatePendingLocked();
+    }
+
+    void ReflectionRegistry::updatePendingLocked() const
+    {
+        pendingLazy_.store(lazyRegistrars_.size() + pendingPlugins_.size(), std::memory_order_release);
+    }
+
+    std::unique_ptr<void, void (*)(void *)> ReflectionRegistry::createInstanceImpl(const std::string &className) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.createInstanceImpl(className);
+        }
+        auto lock = lockForLookup(className);
+        const NamePool::Id classId = findClassId(className);
+        auto it = factories_.find(classId);
+        if (it == factories_.end())
+        {
+            return {nullptr, [](void *) {}};
+        }
+        if (!classPlugins_.empty())
+        {
+            // 插件中的类：记录存活实例，实例全部释放后模块才能卸载
+            auto plugin = classPlugins_.find(classId);
+            if (plugin != classPlugins_.end())
+            {
+                return plugin->second->track(it->second->create());
+            }
+        }
+        return it->second->create();
+    }
+
+    ObjectFactory *ReflectionRegistry::factory(const std::string &className) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.factory(className);
+        }
+        auto lock = lockForLookup(className);
+        auto it = factories_.find(findClassId(className));
+        return it != factories_.end() ? it->second.get() : nullptr;
+    }
+
+    const EnumInfo &ReflectionRegistry::addEnum(std::unique_ptr<EnumInfo> info)
+    {
+        const EnumInfo &added = *info;
+        std::unique_ptr<EnumInfo> &stored = enums_[info->name()];
+        // 先让类型槽位指向新表，再释放被替换的旧表
+        std::unique_ptr<EnumInfo> replaced = std::move(stored);
+        stored = std::move(info);
+        added.slot()->store(&added, std::memory_order_release);
+        if (replaced && replaced->type() != added.type())
+        {
+            const EnumInfo *expected = replaced.get();
+            replaced->slot()->compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+        }
+        return added;
+    }
+
+    const EnumInfo *ReflectionRegistry::enumInfo(const std::string &enumName) const
+    {
+        auto it = enums_.find(enumName);
+        if (it != enums_.end())
+        {
+            return it->second.get();
+        }
+        return parent_ != nullptr ? parent_->enumInfo(enumName) : nullptr;
+    }
+
+    namespace
+    {
+        /// 字段类型注册的枚举名字表
+        const EnumInfo &fieldEnum(const PropertySetterBase &field, const std::string &className,
+                                  const std::string &fieldName)
+        {
+            const TypeOps &ops = field.fieldOps();
+            const EnumInfo *info = ops.enumInfo != nullptr ? ops.enumInfo() : nullptr;
+            if (info == nullptr)
+            {
+                throw std::invalid_argument("字段类型不是已注册的枚举: " + className + "::" + fieldName);
+            }
+            return *info;
+        }
+    }
+
+    std::string ReflectionRegistry::getEnumName(const std::string &className, const std::string &fieldName,
+                                                const void *instance) const
     {
-        // 参数验证
         if (instance == nullptr)
         {
             throw std::runtime_error("实例指针不能为空");
         }
+        const PropertySetterBase *field = findField(className, fieldName);
+        if (field == nullptr)
+        {
+            throw std::runtime_error("未找到字段: " + className + "::" + fieldName);
+        }
+        const EnumInfo &info = fieldEnum(*field, className, fieldName);
+        return info.toString(info.read(field->fieldAddress(instance)));
+    }
 
-        // 构造查找键值并在方法映射中查找
-        auto key = std::make_pair(className, methodName);
-        auto it = methods_.find(key);
+    void ReflectionRegistry::setEnumName(const std::string &className, const std::string &fieldName,
+                                         void *instance, const std::string &name) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const PropertySetterBase *field = findField(className, fieldName);
+        if (field == nullptr)
+        {
+            throw std::runtime_error("未找到字段: " + className + "::" + fieldName);
+        }
+        const EnumInfo &info = fieldEnum(*field, className, fieldName);
+        if (!field->writable())
+        {
+            throw std::invalid_argument("PropertySetter: Cannot set value of const field");
+        }
+        const long long value = info.fromString(name);
+        void *address = const_cast<void *>(field->fieldAddress(instance));
+        info.write(address, value);
+        notifyWrite(instance, address);
+    }
 
-        if (it != methods_.end())
+    void ReflectionRegistry::registerPlugin(const std::string &modulePath, const std::vector<std::string> &classNames)
+    {
+        if (modulePath.empty())
         {
-            try
+            throw std::invalid_argument("插件模块路径不能为空");
+        }
+        LoadLock load(*this);
+        WriteSection section(*this);
+        PluginModule *module = findPlugin(modulePath);
+        if (module == nullptr)
+        {
+            plugins_.push_back(std::unique_ptr<PluginModule>(new PluginModule(modulePath)));
+            module = plugins_.back().get();
+        }
+        for (const auto &className : classNames)
+        {
+            if (className.empty())
             {
-                // 调用找到的方法
-                Any result = it->second->invoke(instance, args);
-                return result;
+                throw std::invalid_argument("插件中的类名不能为空: " + modulePath);
             }
-            catch (const std::exception &e)
+            markOwned(className);
+            const NamePool::Id classId = names_.intern(className);
+            pluginClasses_[classId] = module;
+            if (!module->loaded())
             {
-                std::cerr << "方法调用失败: " << e.what() << '\n';
-                throw; // 重新抛出异常以便上层处理
+                pendingPlugins_[classId] = module;
+                refreshLazyStateLocked(classId);
             }
         }
+        updatePendingLocked();
+    }
 
-        // 未找到方法时抛出异常
-        throw std::runtime_error("未找到方法: " + className + "::" + methodName);
+    void ReflectionRegistry::loadPluginManifest(const std::string &manifestPath)
+    {
+        std::ifstream manifest(manifestPath);
+        if (!manifest)
+        {
+            throw std::runtime_error("无法读取插件清单: " + manifestPath);
+        }
+        std::size_t slash = manifestPath.find_last_of("/\\");
+        const std::string directory = slash == std::string::npos ? std::string() : manifestPath.substr(0, slash + 1);
+
+        // 同一模块的类合并后一起登记
+        std::vector<std::pair<std::string, std::vector<std::string>>> modules;
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(manifest, line))
+        {
+            ++lineNumber;
+            std::istringstream fields(line);
+            std::string className;
+            std::string modulePath;
+            if (!(fields >> className) || className[0] == '#')
+            {
+                continue;
+            }
+            std::string extra;
+            if (!(fields >> modulePath) || (fields >> extra))
+            {
+                throw std::runtime_error("插件清单格式错误: " + manifestPath + ":" + std::to_string(lineNumber));
+            }
+            bool absolute = modulePath[0] == '/' || modulePath[0] == '\\' ||
+                            (modulePath.size() > 1 && modulePath[1] == ':');
+            if (!absolute)
+            {
+                modulePath = directory + modulePath;
+            }
+            auto module = std::find_if(modules.begin(), modules.end(),
+                                       [&modulePath](const std::pair<std::string, std::vector<std::string>> &entry)
+                                       { return entry.first == modulePath; });
+            if (module == modules.end())
+            {
+                modules.push_back(std::make_pair(modulePath, std::vector<std::string>()));
+                module = modules.end() - 1;
+            }
+            module->second.push_back(className);
+        }
+        for (const auto &module : modules)
+        {
+            registerPlugin(module.first, module.second);
+        }
     }
 
-    std::set<std::string> ReflectionRegistry::getMethodNames(const std::string &className) const
+    bool ReflectionRegistry::isPluginLoaded(const std::string &modulePath) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(lazyMutex_);
+        PluginModule *module = findPlugin(modulePath);
+        return module != nullptr && module->loaded();
+    }
+
+    PluginModule *ReflectionRegistry::findPlugin(const std::string &modulePath) const
+    {
+        for (const auto &module : plugins_)
+        {
+            if (module->path() == modulePath)
+            {
+                return module.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void ReflectionRegistry::loadPluginLocked(PluginModule &module) const
     {
-        // 在方法名映射中查找指定类的所有方法
-        auto it = methodNames_.find(className);
-        if (it != methodNames_.end())
+        // 打开失败时类仍留在待加载表中，之后的查询会重试
+        PluginHook hook = module.open();
+
+        auto *self = const_cast<ReflectionRegistry *>(this);
+        std::vector<NamePool::Id> loading;
+        for (auto entry = self->pendingPlugins_.begin(); entry != self->pendingPlugins_.end();)
         {
-            return it->second;
+            if (entry->second == &module)
+            {
+                loading.push_back(entry->first);
+                entry = self->pendingPlugins_.erase(entry);
+            }
+            else
+            {
+                ++entry;
+            }
         }
 
-        // 未找到则返回空集合
-        return std::set<std::string>();
+        // 注册函数执行完之前仍保持待加载状态和计数，其他线程查询这些类时会等待加载完成
+        PluginModule *previous = self->loadingPlugin_;
+        self->loadingPlugin_ = &module;
+        try
+        {
+            hook(*self);
+        }
+        catch (...)
+        {
+            self->loadingPlugin_ = previous;
+            finishLoadLocked(loading);
+            throw;
+        }
+        self->loadingPlugin_ = previous;
+        {
+            WriteSection section(*this);
+            for (const auto &className : module.classes_)
+            {
+                self->classPlugins_[self->names_.intern(className)] = &module;
+            }
+        }
+        finishLoadLocked(loading);
+    }
+
+    bool ReflectionRegistry::unloadPlugin(const std::string &modulePath)
+    {
+        LoadLock load(*this);
+        WriteSection section(*this);
+        PluginModule *module = findPlugin(modulePath);
+        if (module == nullptr || !module->loaded() || module->liveInstances() != 0)
+        {
+            return false;
+        }
+        for (const auto &className : module->classes_)
+        {
+            auto derived = derived_.find(findClassId(className));
+            if (derived == derived_.end())
+            {
+                continue;
+            }
+            for (NamePool::Id derivedId : derived->second)
+            {
+                if (module->classes_.count(names_.name(derivedId)) == 0)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // 先析构模块中的访问器和工厂，再关闭共享库
+        invalidatePaths();
+        for (const auto &className : module->classes_)
+        {
+            removeClassLocked(className);
+        }
+        module->classes_.clear();
+        module->close();
+
+        for (const auto &entry : pluginClasses_)
+        {
+            if (entry.second == module)
+            {
+                pendingPlugins_.insert(entry);
+                refreshLazyStateLocked(entry.first);
+            }
+        }
+        updatePendingLocked();
+        return true;
+    }
+
+    void ReflectionRegistry::removeClassLocked(const std::string &className)
+    {
+        const NamePool::Id classId = findClassId(className);
+        if (classId == NamePool::npos)
+        {
+            return;
+        }
+        memberTables_.erase(classId);
+        factories_.erase(classId);
+        classPlugins_.erase(classId);
+        for (auto it = classNames_.begin(); it != classNames_.end();)
+        {
+            if (it->second == classId)
+            {
+                it = classNames_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        auto bases = bases_.find(classId);
+        if (bases != bases_.end())
+        {
+            for (const auto &base : bases->second)
+            {
+                auto &siblings = derived_[base.classId];
+                siblings.erase(std::remove(siblings.begin(), siblings.end(), classId), siblings.end());
+            }
+            bases_.erase(bases);
+        }
+        ancestors_.erase(classId);
+        derived_.erase(classId);
+
+        // 清单中的类仍归本层，之后的查询在本层重新加载
+        if (pluginClasses_.find(classId) == pluginClasses_.end())
+        {
+            ownedClasses_.erase(classId);
+        }
+    }
+
+    const PropertySetterBase *ReflectionRegistry::getSetter(const std::string &className,
+                                                            const std::string &fieldName) const
+    {
+        return getSetter(NameRef(className), NameRef(fieldName));
+    }
+
+    const PropertySetterBase *ReflectionRegistry::getSetter(const NameRef &className, const NameRef &fieldName) const
+    {
+        // 参数验证
+        if (className.empty() || fieldName.empty())
+        {
+            return nullptr;
+        }
+        const ReflectionRegistry &layer = layerFor(className);
+        if (&layer != this)
+        {
+            return layer.getSetter(className, fieldName);
+        }
+        auto lock = lockForLookup(className);
+        const PropertySetterBase *field = findFieldLocked(className, fieldName);
+        // const 字段不可写，返回 nullptr 表示无 setter
+        return field != nullptr && field->writable() ? field : nullptr;
+    }
+
+    std::string ReflectionRegistry::classNameOf(const std::type_info &type) const
+    {
+        LookupGuard guard;
+        if (pendingLazy_.load(std::memory_order_acquire) != 0)
+        {
+            guard = LookupGuard(*this);
+        }
+        auto it = classNames_.find(names_.find(NameRef(type.name())));
+        if (it == classNames_.end())
+        {
+            return parent_ != nullptr ? parent_->classNameOf(type) : "unregistered";
+        }
+        std::string className = names_.name(it->second);
+        if (guard.active())
+        {
+            // 注册函数可能向名字池和 classNames_ 插入条目，先复制类名
+            loadIfPending(NameRef(className));
+        }
+        return className;
+    }
+
+    const PropertySetterBase *ReflectionRegistry::findField(const std::string &className,
+                                                            const std::string &fieldName) const
+    {
+        return findField(NameRef(className), NameRef(fieldName));
+    }
+
+    const PropertySetterBase *ReflectionRegistry::findField(const NameRef &className,
+                                                            const NameRef &fieldName) const
+    {
+        const ReflectionRegistry &layer = layerFor(className);
+        if (&layer != this)
+        {
+            return layer.findField(className, fieldName);
+        }
+        auto lock = lockForLookup(className);
+        return findFieldLocked(className, fieldName);
+    }
+
+    const MemberTable *ReflectionRegistry::findTable(const NameRef &className) const
+    {
+        const NamePool::Id classId = names_.find(className);
+        if (classId == NamePool::npos)
+        {
+            return nullptr;
+        }
+        auto it = memberTables_.find(classId);
+        return it != memberTables_.end() ? &it->second : nullptr;
+    }
+
+    const PropertySetterBase *ReflectionRegistry::findFieldLocked(const NameRef &className,
+                                                                  const NameRef &fieldName) const
+    {
+        const MemberTable *table = findTable(className);
+        if (table == nullptr)
+        {
+            return nullptr;
+        }
+        std::size_t index = table->findField(fieldName);
+        return index != MemberTable::npos ? &table->field(index) : nullptr;
+    }
+
+    ContainerView ReflectionRegistry::containerField(const std::string &className, const std::string &fieldName,
+                                                     void *instance) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const PropertySetterBase *field = findField(className, fieldName);
+        if (field == nullptr)
+        {
+            throw std::runtime_error("未找到字段: " + className + "::" + fieldName);
+        }
+        return ContainerView(field->fieldOps(), field->fieldAddress(instance), field->writable());
+    }
+
+    ContainerView ReflectionRegistry::containerField(const std::string &className, const std::string &fieldName,
+                                                     const void *instance) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const PropertySetterBase *field = findField(className, fieldName);
+        if (field == nullptr)
+        {
+            throw std::runtime_error("未找到字段: " + className + "::" + fieldName);
+        }
+        return ContainerView(field->fieldOps(), field->fieldAddress(instance), false);
+    }
+
+    std::unordered_map<std::string, Any> ReflectionRegistry::getAllValues(
+        const std::string &className, const void *instance) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.getAllValues(className, instance);
+        }
+        auto lock = lockForLookup(className);
+        std::unordered_map<std::string, Any> values;
+
+        // 按类的成员表取值，不必遍历所有类的字段
+        const MemberTable *table = findTable(NameRef(className));
+        if (table != nullptr)
+        {
+            for (std::size_t i = 0; i < table->fieldCount(); ++i)
+            {
+                values[table->fieldName(i)] = table->field(i).get(instance);
+            }
+        }
+        return values;
+    }
+
+    Any ReflectionRegistry::getValues(const std::string &className,
+                                      const std::string &fieldName,
+                                      const void *instance) const
+    {
+        return getValues(NameRef(className), NameRef(fieldName), instance);
+    }
+
+    Any ReflectionRegistry::getValues(const NameRef &className, const NameRef &fieldName,
+                                      const void *instance) const
+    {
+        const ReflectionRegistry &layer = layerFor(className);
+        if (&layer != this)
+        {
+            return layer.getValues(className, fieldName, instance);
+        }
+        auto lock = lockForLookup(className);
+        const PropertySetterBase *field = findFieldLocked(className, fieldName);
+        // 未找到则返回空Any对象
+        return field != nullptr ? field->get(instance) : Any();
+    }
+
+    Any ReflectionRegistry::invokeMethod(const std::string &className,
+                                         const std::string &methodName,
+                                         void *instance,
+                                         const std::vector<Any> &args) const
+    {
+        return invokeMethod(NameRef(className), NameRef(methodName), instance, args);
+    }
+
+    Any ReflectionRegistry::invokeMethod(const NameRef &className, const NameRef &methodName,
+                                         void *instance, const std::vector<Any> &args) const
+    {
+        // 参数验证
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const ReflectionRegistry &layer = layerFor(className);
+        if (&layer != this)
+        {
+            return layer.invokeMethod(className, methodName, instance, args);
+        }
+
+        auto lock = lockForLookup(className);
+        const MemberTable *table = findTable(className);
+        std::size_t index = table != nullptr ? table->findMethod(methodName) : MemberTable::npos;
+
+        if (index != MemberTable::npos)
+        {
+            // 方法执行期间可能注册成员使成员表重新分配，先复制调用器并结束查询登记
+            MethodThunk method;
+            try
+            {
+                method = table->method(table->selectMethod(methodName, args));
+                lock.release();
+                // 调用找到的方法
+                Any result = method.invoke(instance, args);
+                return result;
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "方法调用失败: " << e.what() << '\n';
+                throw; // 重新抛出异常以便上层处理
+            }
+        }
+
+        // 未找到方法时抛出异常
+        throw std::runtime_error("未找到方法: " + className.str() + "::" + methodName.str());
+    }
+
+    std::set<std::string> ReflectionRegistry::getMethodNames(const std::string &className) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.getMethodNames(className);
+        }
+        auto lock = lockForLookup(className);
+        std::set<std::string> names;
+        const MemberTable *table = findTable(NameRef(className));
+        if (table != nullptr)
+        {
+            for (std::size_t i = 0; i < table->methodCount(); ++i)
+            {
+                names.insert(table->methodName(i));
+            }
+        }
+        return names;
+    }
+
+    void ReflectionRegistry::registerBaseImpl(const std::string &derivedName,
+                                              const std::string &baseName,
+                                              std::ptrdiff_t offset)
+    {
+        if (derivedName.empty() || baseName.empty() || derivedName == baseName)
+        {
+            throw std::invalid_argument("继承关系需要两个不同的有效类名");
+        }
+        // 基类可能是延迟注册的，先确保其已加载
+        auto lock = lockForLookup(baseName);
+        WriteSection section(*this);
+        invalidatePaths();
+        if (isDerivedFrom(baseName, derivedName))
+        {
+            throw std::invalid_argument("继承关系出现循环: " + derivedName + " <-> " + baseName);
+        }
+
+        const NamePool::Id derivedId = names_.intern(derivedName);
+        const NamePool::Id baseId = names_.intern(baseName);
+        auto &bases = bases_[derivedId];
+        for (const auto &base : bases)
+        {
+            if (base.classId == baseId)
+            {
+                return;
+            }
+        }
+        BaseClassInfo info;
+        info.classId = baseId;
+        info.offset = offset;
+        bases.push_back(info);
+        const std::size_t baseIndex = bases.size() - 1;
+        derived_[baseId].push_back(derivedId);
+        markOwned(derivedName);
+
+        // 基类可能属于父注册表：从那一层复制其祖先和扁平成员表
+        const ReflectionRegistry &baseLayer = layerFor(NameRef(baseName));
+        LookupGuard baseLock;
+        if (&baseLayer != this)
+        {
+            baseLock = baseLayer.lockForLookup(baseName);
+        }
+
+        // 扁平化祖先表：基类本身及其所有祖先（基类那一层的编号换算为本层的编号）
+        addAncestor(derivedId, baseId, offset);
+        const NamePool::Id layerBaseId = baseLayer.findClassId(baseName);
+        auto baseAncestors = baseLayer.ancestors_.find(layerBaseId);
+        if (baseAncestors != baseLayer.ancestors_.end())
+        {
+            std::vector<std::pair<NamePool::Id, std::ptrdiff_t>> inherited;
+            for (const auto &ancestor : baseAncestors->second)
+            {
+                NamePool::Id ancestorId = &baseLayer == this ? ancestor.first
+                                                             : names_.intern(baseLayer.names_.name(ancestor.first));
+                inherited.push_back(std::make_pair(ancestorId, ancestor.second));
+            }
+            for (const auto &ancestor : inherited)
+            {
+                addAncestor(derivedId, ancestor.first, offset + ancestor.second);
+            }
+        }
+
+        // 扁平化成员表：基类的成员表已包含其祖先的成员
+        // 继承只写入派生类及其派生类的表，基类的表保持不变（映射中的元素地址在插入时也不变）
+        auto baseTable = baseLayer.memberTables_.find(layerBaseId);
+        if (baseTable == baseLayer.memberTables_.end())
+        {
+            return;
+        }
+        const MemberTable &base = baseTable->second;
+        for (std::size_t i = 0; i < base.fieldCount(); ++i)
+        {
+            inheritField(derivedId, base.fieldName(i), base.field(i), offset, baseIndex);
+        }
+        for (std::size_t i = 0; i < base.methodCount(); i += base.overloadCount(i))
+        {
+            std::vector<MethodThunk> methods(&base.method(i), &base.method(i) + base.overloadCount(i));
+            inheritMethods(derivedId, base.methodName(i), methods, offset, baseIndex);
+        }
+    }
+
+    void ReflectionRegistry::addAncestor(NamePool::Id classId, NamePool::Id ancestorId, std::ptrdiff_t offset)
+    {
+        // 菱形继承时同一祖先可能有多条路径，保留先登记的那条
+        if (!ancestors_[classId].insert(std::make_pair(ancestorId, offset)).second)
+        {
+            return;
+        }
+        auto derivedIt = derived_.find(classId);
+        if (derivedIt == derived_.end())
+        {
+            return;
+        }
+        std::vector<NamePool::Id> derivedIds = derivedIt->second;
+        for (NamePool::Id derivedId : derivedIds)
+        {
+            for (const auto &base : bases_[derivedId])
+            {
+                if (base.classId == classId)
+                {
+                    addAncestor(derivedId, ancestorId, base.offset + offset);
+                    break;
+                }
+            }
+        }
+    }
+
+    void ReflectionRegistry::addField(const std::string &className, const std::string &fieldName,
+                                      const FieldThunk &field)
+    {
+        WriteSection section(*this);
+        markOwned(className);
+        // 每次字段注册都会经过这里，已缓存的路径可能引用了被替换的字段
+        invalidatePaths();
+        const NamePool::Id classId = names_.intern(className);
+        const NamePool::Id fieldId = names_.intern(fieldName);
+        memberTables_[classId].putField(names_.name(fieldId), names_.hash(fieldId), field, 0);
+        propagateField(classId, fieldName);
+    }
+
+    void ReflectionRegistry::addMethod(const std::string &className, const std::string &methodName,
+                                       const MethodThunk &method)
+    {
+        WriteSection section(*this);
+        markOwned(className);
+        const NamePool::Id classId = names_.intern(className);
+        const NamePool::Id methodId = names_.intern(methodName);
+        memberTables_[classId].addMethod(names_.name(methodId), names_.hash(methodId), method);
+        propagateMethods(classId, methodName);
+    }
+
+    void ReflectionRegistry::inheritField(NamePool::Id derivedId, const std::string &fieldName, FieldThunk field,
+                                          std::ptrdiff_t offset, std::size_t baseIndex)
+    {
+        // 表项中的偏移累计各层基类子对象的调整量，访问时只需一次地址运算
+        field.offset += offset;
+        const NamePool::Id fieldId = names_.intern(fieldName);
+        if (memberTables_[derivedId].putField(names_.name(fieldId), names_.hash(fieldId), field,
+                                              static_cast<MemberTable::Origin>(baseIndex + 1)))
+        {
+            propagateField(derivedId, fieldName);
+        }
+    }
+
+    void ReflectionRegistry::inheritMethods(NamePool::Id derivedId, const std::string &methodName,
+                                            std::vector<MethodThunk> methods, std::ptrdiff_t offset,
+                                            std::size_t baseIndex)
+    {
+        for (auto &method : methods)
+        {
+            method.adjust += offset;
+        }
+        const NamePool::Id methodId = names_.intern(methodName);
+        if (memberTables_[derivedId].inheritMethods(names_.name(methodId), names_.hash(methodId), methods,
+                                                    static_cast<MemberTable::Origin>(baseIndex + 1)))
+        {
+            propagateMethods(derivedId, methodName);
+        }
+    }
+
+    const MemberTable *ReflectionRegistry::memberTable(const std::string &className) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.memberTable(className);
+        }
+        auto lock = lockForLookup(className);
+        return findTable(NameRef(className));
+    }
+
+    void ReflectionRegistry::propagateField(NamePool::Id classId, const std::string &fieldName)
+    {
+        auto derivedIt = derived_.find(classId);
+        if (derivedIt == derived_.end())
+        {
+            return;
+        }
+        const MemberTable &table = memberTables_[classId];
+        const FieldThunk field = table.field(table.findField(NameRef(fieldName)));
+        std::vector<NamePool::Id> derivedIds = derivedIt->second;
+        for (NamePool::Id derivedId : derivedIds)
+        {
+            const auto &bases = bases_[derivedId];
+            for (std::size_t i = 0; i < bases.size(); ++i)
+            {
+                if (bases[i].classId == classId)
+                {
+                    inheritField(derivedId, fieldName, field, bases[i].offset, i);
+                    break;
+                }
+            }
+        }
+    }
+
+    void ReflectionRegistry::propagateMethods(NamePool::Id classId, const std::string &methodName)
+    {
+        auto derivedIt = derived_.find(classId);
+        if (derivedIt == derived_.end())
+        {
+            return;
+        }
+        const MemberTable &table = memberTables_[classId];
+        const std::size_t first = table.findMethod(NameRef(methodName));
+        const std::vector<MethodThunk> methods(&table.method(first), &table.method(first) + table.overloadCount(first));
+        std::vector<NamePool::Id> derivedIds = derivedIt->second;
+        for (NamePool::Id derivedId : derivedIds)
+        {
+            const auto &bases = bases_[derivedId];
+            for (std::size_t i = 0; i < bases.size(); ++i)
+            {
+                if (bases[i].classId == classId)
+                {
+                    inheritMethods(derivedId, methodName, methods, bases[i].offset, i);
+                    break;
+                }
+            }
+        }
+    }
+
+    bool ReflectionRegistry::isDerivedFrom(const std::string &derivedClass,
+                                           const std::string &baseClass) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(derivedClass));
+        if (&layer != this)
+        {
+            return layer.isDerivedFrom(derivedClass, baseClass);
+        }
+        auto lock = lockForLookup(derivedClass);
+        auto it = ancestors_.find(findClassId(derivedClass));
+        return it != ancestors_.end() && it->second.count(findClassId(baseClass)) != 0;
+    }
+
+    void *ReflectionRegistry::castInstance(const std::string &fromClass, const std::string &toClass,
+                                           void *instance) const
+    {
+        if (instance == nullptr || fromClass == toClass)
+        {
+            return instance;
+        }
+        // 子注册表的类的祖先表包含父注册表中的祖先，两个类都不在本层时才转到父注册表
+        if (parent_ != nullptr && !ownsClass(NameRef(fromClass)) && !ownsClass(NameRef(toClass)))
+        {
+            return parent_->castInstance(fromClass, toClass, instance);
+        }
+        auto lock = lockForLookup(fromClass);
+        if (lock.active())
+        {
+            loadIfPending(NameRef(toClass));
+        }
+
+        // 向上转换：from 的祖先表中直接查到偏移
+        const NamePool::Id fromId = findClassId(fromClass);
+        const NamePool::Id toId = findClassId(toClass);
+        auto fromIt = ancestors_.find(fromId);
+        if (fromIt != ancestors_.end())
+        {
+            auto it = fromIt->second.find(toId);
+            if (it != fromIt->second.end())
+            {
+                return static_cast<char *>(instance) + it->second;
+            }
+        }
+
+        // 向下转换：反向应用 to 到 from 的偏移
+        auto toIt = ancestors_.find(toId);
+        if (toIt != ancestors_.end())
+        {
+            auto it = toIt->second.find(fromId);
+            if (it != toIt->second.end())
+            {
+                return static_cast<char *>(instance) - it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    struct ReflectionRegistry::AsyncRuntime
+    {
+        explicit AsyncRuntime(std::size_t workerCount) : pool(new ThreadPool(workerCount)), strands(*pool) {}
+
+        // 线程池析构时执行完已提交的任务，其中的串行任务还会用到分发器
+        ~AsyncRuntime() { pool.reset(); }
+
+        std::unique_ptr<ThreadPool> pool;
+        InstanceStrands strands;
+    };
+
+    void ReflectionRegistry::ensureAsyncPoolLocked() const
+    {
+        if (!asyncRuntime_)
+        {
+            asyncRuntime_ = std::make_shared<AsyncRuntime>(asyncWorkerCount_);
+        }
+    }
+
+    std::shared_ptr<ThreadPool> ReflectionRegistry::asyncPool() const
+    {
+        std::lock_guard<std::mutex> lock(asyncMutex_);
+        ensureAsyncPoolLocked();
+        // 与运行时共享所有权，使用者持有期间线程池和分发器都不会析构
+        return std::shared_ptr<ThreadPool>(asyncRuntime_, asyncRuntime_->pool.get());
+    }
+
+    void ReflectionRegistry::setAsyncWorkerCount(std::size_t workerCount)
+    {
+        std::shared_ptr<AsyncRuntime> retired;
+        {
+            std::lock_guard<std::mutex> lock(asyncMutex_);
+            asyncWorkerCount_ = workerCount;
+            if (asyncRuntime_ &&
+                asyncRuntime_->pool->workerCount() != ThreadPool::resolveWorkerCount(workerCount))
+            {
+                retired = std::move(asyncRuntime_);
+            }
+        }
+        // 没有其他使用者时，旧线程池在锁外执行完已提交的任务再析构
+    }
+
+    std::future<Any> ReflectionRegistry::invokeAsync(const std::string &className,
+                                                     const std::string &methodName,
+                                                     void *instance,
+                                                     const std::vector<Any> &args) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+
+        std::shared_ptr<std::packaged_task<Any()>> task(new std::packaged_task<Any()>(
+            [this, className, methodName, instance, args]()
+            { return invokeMethod(className, methodName, instance, args); }));
+        std::future<Any> result = task->get_future();
+
+        std::lock_guard<std::mutex> lock(asyncMutex_);
+        ensureAsyncPoolLocked();
+        asyncRuntime_->strands.post(instance, [task]()
+                            { (*task)(); });
+        return result;
+    }
+
+    ResolvedMethod ReflectionRegistry::resolveMethod(const std::string &className,
+                                                     const std::string &methodName,
+                                                     const std::vector<const std::type_info *> &argTypes) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            return layer.resolveMethod(className, methodName, argTypes);
+        }
+        auto lock = lockForLookup(className);
+        const MemberTable *table = findTable(NameRef(className));
+        const NameRef name(methodName);
+        if (table == nullptr || table->findMethod(name) == MemberTable::npos)
+        {
+            throw std::runtime_error("未找到方法: " + className + "::" + methodName);
+        }
+
+        // 表项已展开重载和继承，直接按参数类型选出具体签名
+        const std::size_t index = table->findMethod(name, argTypes);
+        if (index == MemberTable::npos)
+        {
+            throw std::runtime_error("没有与参数类型匹配的签名: " + className + "::" + methodName);
+        }
+        return ResolvedMethod(table->method(index));
+    }
+
+    void ReflectionRegistry::invokeBatchImpl(const ResolvedMethod &method, void *const *instances,
+                                             std::size_t count, const std::vector<BatchColumn> &columns,
+                                             void *results, std::size_t resultStride,
+                                             const std::type_info &resultType) const
+    {
+        if (!method)
+        {
+            throw std::invalid_argument("批量调用需要已解析的方法");
+        }
+        const MethodThunk &invoker = method.invoker;
+        if (columns.size() != invoker.argCount())
+        {
+            throw std::invalid_argument("参数数量不匹配");
+        }
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            if (columns[i].data == nullptr || *columns[i].type != invoker.argType(i))
+            {
+                throw std::invalid_argument("批量调用的第 " + std::to_string(i) + " 列参数类型不匹配");
+            }
+            if (columns[i].stride == 0 && invoker.writesArg(i))
+            {
+                // 方法会修改这个参数，共享值会被所有工作线程同时写入
+                throw std::invalid_argument("批量调用的第 " + std::to_string(i) +
+                                            " 列参数按非 const 引用传递，不能使用共享列");
+            }
+        }
+        if (results != nullptr && resultType != invoker.returnType())
+        {
+            throw std::invalid_argument("结果缓冲区类型与方法返回类型不匹配");
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+        const std::size_t argCount = columns.size();
+        auto runRange = [&](std::size_t begin, std::size_t end)
+        {
+            // 每个分块只分配一次参数指针数组，循环内逐列前移
+            std::vector<const void *> args(argCount == 0 ? 1 : argCount);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                for (std::size_t a = 0; a < argCount; ++a)
+                {
+                    args[a] = static_cast<const char *>(columns[a].data) + i * columns[a].stride;
+                }
+                void *result = results != nullptr ? static_cast<char *>(results) + i * resultStride : nullptr;
+                method.invokeRaw(instances[i], args.data(), result);
+            }
+        };
+
+        const std::shared_ptr<ThreadPool> pool = asyncPool();
+        // 每个工作线程约分到 4 个分块，兼顾负载均衡与调度开销
+        std::size_t chunks = pool->workerCount() * 4;
+        std::size_t grain = (count + chunks - 1) / chunks;
+        if (grain < 1024)
+        {
+            grain = 1024;
+        }
+        pool->parallelFor(count, grain, runRange);
+    }
+
+    PropertyPath ReflectionRegistry::resolvePath(const std::string &className, const std::string &path) const
+    {
+        if (className.empty() || path.empty())
+        {
+            throw std::invalid_argument("属性路径需要有效的类名和路径");
+        }
+
+        PropertyPath resolved(className, path);
+        std::string currentClass = className;
+        const TypeOps *current = nullptr;
+        std::ptrdiff_t offset = 0; // 尚未落入访问步骤的累计偏移
+        std::size_t pos = 0;
+
+        for (;;)
+        {
+            std::size_t end = path.find_first_of(".[", pos);
+            if (end == std::string::npos)
+            {
+                end = path.size();
+            }
+            if (end == pos)
+            {
+                throw std::invalid_argument("属性路径格式错误: " + path);
+            }
+            std::string fieldName = path.substr(pos, end - pos);
+
+            // 从第二段开始，按上一段的值类型找到所属的类
+            if (current != nullptr)
+            {
+                currentClass = classNameOf(*current->type);
+                if (currentClass == "unregistered")
+                {
+                    throw std::runtime_error("属性路径经过未登记类名的类型: " + path.substr(0, pos - 1));
+                }
+            }
+            const PropertySetterBase *field = findField(currentClass, fieldName);
+            if (field == nullptr)
+            {
+                throw std::runtime_error("未找到字段: " + currentClass + "::" + fieldName);
+            }
+            offset += field->fieldOffset();
+            resolved.writable_ = resolved.writable_ && field->writable();
+            current = &field->fieldOps();
+            pos = end;
+
+            // 下标：a[1][2]
+            while (pos < path.size() && path[pos] == '[')
+            {
+                std::size_t close = path.find(']', pos);
+                if (close == std::string::npos || close == pos + 1 ||
+                    path.find_first_not_of("0123456789", pos + 1) != close)
+                {
+                    throw std::invalid_argument("属性路径下标格式错误: " + path);
+                }
+                if (current->container == nullptr || current->container->at == nullptr)
+                {
+                    throw std::invalid_argument("字段不支持下标访问: " + path.substr(0, pos));
+                }
+                PropertyPath::Step step = {offset, current->container,
+                                           static_cast<std::size_t>(std::stoull(path.substr(pos + 1, close - pos - 1)))};
+                resolved.steps_.push_back(step);
+                offset = 0;
+                current = &current->container->elementOps();
+                pos = close + 1;
+            }
+
+            if (pos == path.size())
+            {
+                break;
+            }
+            if (path[pos] != '.')
+            {
+                throw std::invalid_argument("属性路径格式错误: " + path);
+            }
+            ++pos;
+        }
+
+        if (offset != 0 || resolved.steps_.empty())
+        {
+            PropertyPath::Step step = {offset, nullptr, 0};
+            resolved.steps_.push_back(step);
+        }
+        resolved.valueOps_ = current;
+        return resolved;
+    }
+
+    std::shared_ptr<const PropertyPath> ReflectionRegistry::cachedPath(const std::string &className,
+                                                                       const std::string &path) const
+    {
+        std::shared_ptr<const PropertyPath> resolved = pathCache_.find(className, path);
+        if (!resolved)
+        {
+            // 解析期间不持有缓存锁（解析可能触发延迟注册）
+            resolved = std::make_shared<const PropertyPath>(resolvePath(className, path));
+            pathCache_.insert(resolved);
+        }
+        return resolved;
+    }
+
+    Any ReflectionRegistry::getPathValue(const std::string &className, const std::string &path,
+                                         const void *instance) const
+    {
+        return cachedPath(className, path)->get(instance);
+    }
+
+    void ReflectionRegistry::setPathValue(const std::string &className, const std::string &path,
+                                          void *instance, const Any &value) const
+    {
+        std::shared_ptr<const PropertyPath> resolved = cachedPath(className, path);
+        resolved->set(instance, value);
+        notifyWrite(instance, resolved->address(static_cast<const void *>(instance)));
+    }
+
+    void ReflectionRegistry::setValue(const std::string &className, const std::string &fieldName, void *instance,
+                                      const Any &value) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const PropertySetterBase *setter = getSetter(className, fieldName);
+        if (setter == nullptr)
+        {
+            if (findField(className, fieldName) != nullptr)
+            {
+                throw std::invalid_argument("PropertySetter: Cannot set value of const field");
+            }
+            throw std::runtime_error("未找到字段: " + className + "::" + fieldName);
+        }
+        setter->set(instance, value);
+        notifyWrite(instance, setter->fieldAddress(instance));
+    }
+
+    void ReflectionRegistry::replaceListenersLocked(const std::shared_ptr<const ListenerList> &listeners)
+    {
+        retiredListeners_.erase(std::remove_if(retiredListeners_.begin(), retiredListeners_.end(),
+                                               [](const std::weak_ptr<const ListenerList> &retired)
+                                               { return retired.expired(); }),
+                                retiredListeners_.end());
+        if (writeListeners_)
+        {
+            retiredListeners_.push_back(writeListeners_);
+        }
+        writeListeners_ = listeners;
+        writeListenerCount_.store(listeners ? listeners->size() : 0, std::memory_order_release);
+    }
+
+    void ReflectionRegistry::addWriteListener(FieldWriteListener *listener)
+    {
+        if (listener == nullptr)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(writeListenerMutex_);
+        if (writeListeners_ &&
+            std::find(writeListeners_->begin(), writeListeners_->end(), listener) != writeListeners_->end())
+        {
+            return;
+        }
+        std::shared_ptr<ListenerList> listeners =
+            writeListeners_ ? std::make_shared<ListenerList>(*writeListeners_) : std::make_shared<ListenerList>();
+        listeners->push_back(listener);
+        replaceListenersLocked(listeners);
+    }
+
+    void ReflectionRegistry::removeWriteListener(FieldWriteListener *listener)
+    {
+        std::vector<std::weak_ptr<const ListenerList>> retired;
+        {
+            std::lock_guard<std::mutex> lock(writeListenerMutex_);
+            if (writeListeners_ &&
+                std::find(writeListeners_->begin(), writeListeners_->end(), listener) != writeListeners_->end())
+            {
+                std::shared_ptr<ListenerList> listeners = std::make_shared<ListenerList>(*writeListeners_);
+                listeners->erase(std::remove(listeners->begin(), listeners->end(), listener), listeners->end());
+                replaceListenersLocked(listeners->empty() ? nullptr : listeners);
+            }
+            retired = retiredListeners_;
+        }
+
+        // 新的写入只会取得不含该监听者的快照；等待仍持有旧快照的通知结束
+        for (const auto &weak : retired)
+        {
+            {
+                std::shared_ptr<const ListenerList> snapshot = weak.lock();
+                if (!snapshot || std::find(snapshot->begin(), snapshot->end(), listener) == snapshot->end())
+                {
+                    continue;
+                }
+            }
+            while (!weak.expired())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void ReflectionRegistry::setPathCacheCapacity(std::size_t capacity)
+    {
+        pathCache_.setCapacity(capacity);
+    }
+
+    void ReflectionRegistry::invalidatePaths()
+    {
+        pathCache_.clear();
+        std::lock_guard<std::mutex> lock(planCacheMutex_);
+        copyPlans_.clear();
+        comparePlans_.clear();
+    }
+
+    std::shared_ptr<const CopyPlan> ReflectionRegistry::copyPlan(const std::string &className,
+                                                                 const void *sample) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(planCacheMutex_);
+            auto it = copyPlans_.find(className);
+            if (it != copyPlans_.end())
+            {
+                return it->second;
+            }
+        }
+        // 构建期间不持有缓存锁（查询成员表可能触发延迟注册）
+        std::shared_ptr<const CopyPlan> plan = std::make_shared<const CopyPlan>(*this, className, sample);
+        std::lock_guard<std::mutex> lock(planCacheMutex_);
+        return copyPlans_.insert(std::make_pair(className, plan)).first->second;
+    }
+
+    void ReflectionRegistry::copyInto(const std::string &className, void *dst, const void *src) const
+    {
+        if (dst == nullptr || src == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        copyPlan(className, src)->copy(dst, src);
+    }
+
+    std::unique_ptr<void, void (*)(void *)> ReflectionRegistry::clone(const std::string &className,
+                                                                       const void *src) const
+    {
+        if (src == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        std::shared_ptr<const CopyPlan> plan = copyPlan(className, src);
+        std::unique_ptr<void, void (*)(void *)> copy = createInstance(className);
+        if (!copy)
+        {
+            throw std::runtime_error("类没有注册工厂: " + className);
+        }
+        plan->copy(copy.get(), src);
+        return copy;
+    }
+
+    std::shared_ptr<const ComparePlan> ReflectionRegistry::comparePlan(const std::string &className,
+                                                                       const void *sample) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(planCacheMutex_);
+            auto it = comparePlans_.find(className);
+            if (it != comparePlans_.end())
+            {
+                return it->second;
+            }
+        }
+        std::shared_ptr<const ComparePlan> plan = std::make_shared<const ComparePlan>(*this, className, sample);
+        std::lock_guard<std::mutex> lock(planCacheMutex_);
+        return comparePlans_.insert(std::make_pair(className, plan)).first->second;
+    }
+
+    bool ReflectionRegistry::equals(const std::string &className, const void *a, const void *b) const
+    {
+        if (a == nullptr || b == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        return comparePlan(className, a)->equals(a, b);
+    }
+
+    int ReflectionRegistry::compare(const std::string &className, const void *a, const void *b) const
+    {
+        if (a == nullptr || b == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        return comparePlan(className, a)->compare(a, b);
+    }
+
+    std::uint64_t ReflectionRegistry::hash(const std::string &className, const void *object) const
+    {
+        if (object == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        return comparePlan(className, object)->hash(object);
+    }
+
+    namespace
+    {
+        /// 基于节点的哈希表：每个节点保存值和下一节点指针，另有桶数组
+        template <typename Map>
+        std::size_t hashNodeBytes(const Map &map)
+        {
+            return map.size() * (sizeof(typename Map::value_type) + sizeof(void *)) +
+                   map.bucket_count() * sizeof(void *);
+        }
+
+        template <typename Vector>
+        std::size_t vectorBytes(const Vector &vector)
+        {
+            return vector.capacity() * sizeof(typename Vector::value_type);
+        }
+
+        /// 节点内的值、下一节点指针和值之外的堆内存
+        template <typename Entry>
+        std::size_t nodeBytes(const Entry &, std::size_t heapBytes)
+        {
+            return sizeof(Entry) + sizeof(void *) + heapBytes;
+        }
+    } // namespace
+
+    RegistryMemoryStats ReflectionRegistry::memoryStats() const
+    {
+        RegistryMemoryStats stats;
+        auto add = [&stats](const char *name, std::size_t entries, std::size_t bytes)
+        {
+            RegistryMemoryStats::Structure structure;
+            structure.name = name;
+            structure.entries = entries;
+            structure.bytes = bytes;
+            stats.structures.push_back(structure);
+            stats.totalBytes += bytes;
+        };
+
+        std::size_t bytes = hashNodeBytes(memberTables_);
+        for (const auto &entry : memberTables_)
+        {
+            const MemberTable &table = entry.second;
+            std::size_t heap = vectorBytes(table.fields_) + vectorBytes(table.fieldHashes_) +
+                               vectorBytes(table.fieldNames_) + vectorBytes(table.fieldOrigins_) +
+                               vectorBytes(table.fieldSlots_) + vectorBytes(table.methods_) +
+                               vectorBytes(table.methodHashes_) + vectorBytes(table.methodNames_) +
+                               vectorBytes(table.methodOrigins_) + vectorBytes(table.methodSlots_);
+            bytes += heap;
+            stats.classes[names_.name(entry.first)] += nodeBytes(entry, heap);
+        }
+        add("memberTables", memberTables_.size(), bytes);
+
+        add("names", names_.size(), names_.memoryBytes());
+        add("ownedClasses", ownedClasses_.size(), hashNodeBytes(ownedClasses_));
+
+        add("classNames", classNames_.size(), hashNodeBytes(classNames_));
+
+        bytes = hashNodeBytes(factories_);
+        for (const auto &entry : factories_)
+        {
+            // 工厂对象只有虚表指针
+            std::size_t heap = sizeof(void *);
+            bytes += heap;
+            stats.classes[names_.name(entry.first)] += nodeBytes(entry, heap);
+        }
+        add("factories", factories_.size(), bytes);
+
+        bytes = hashNodeBytes(bases_) + hashNodeBytes(derived_) + hashNodeBytes(ancestors_);
+        for (const auto &entry : bases_)
+        {
+            bytes += vectorBytes(entry.second);
+        }
+        for (const auto &entry : derived_)
+        {
+            bytes += vectorBytes(entry.second);
+        }
+        for (const auto &entry : ancestors_)
+        {
+            bytes += hashNodeBytes(entry.second);
+        }
+        add("inheritance", bases_.size() + derived_.size() + ancestors_.size(), bytes);
+
+        add("lazyRegistrars", lazyRegistrars_.size(), hashNodeBytes(lazyRegistrars_));
+        add("lazyStates", lazyStates_.size(), hashNodeBytes(lazyStates_));
+
+        return stats;
+    }
+
+    void ReflectionRegistry::compact()
+    {
+        for (auto &entry : memberTables_)
+        {
+            entry.second.shrink();
+        }
+        memberTables_.rehash(0);
+        names_.shrink();
+        ownedClasses_.rehash(0);
+        classNames_.rehash(0);
+        factories_.rehash(0);
+        for (auto &entry : bases_)
+        {
+            entry.second.shrink_to_fit();
+        }
+        for (auto &entry : derived_)
+        {
+            entry.second.shrink_to_fit();
+        }
+        bases_.rehash(0);
+        derived_.rehash(0);
+        ancestors_.rehash(0);
+        lazyRegistrars_.rehash(0);
+        lazyStates_.rehash(0);
     }
 
 } // namespace Evently
@@ -2,141 +2,329 @@
 #define REFLECTION_H
 #pragma once
 
+#include "Config.h"
 #include "Any.h"
+#include "EnumInfo.h"
 #include "IndexSequence.h"
+#include "MemberTable.h"
+#include "NamePool.h"
+#include "PluginModule.h"
+#include "NameRef.h"
+#include "PropertyPath.h"
+#include "TypeOps.h"
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
 #include <iostream>
 #include <cxxabi.h>
 #include <type_traits>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <new>
+#include <stdexcept>
+#include <thread>
 
 namespace Evently
 {
 
     /**
-     * @brief 属性设置器基类
+     * @brief 字段访问器与方法调用器就是类的扁平成员表中的表项（见 MemberTable.h）
+     *
+     * 查找返回的指针指向表项，在该类（或其基类）再次注册成员前有效；
+     * 需要长期保存时按值拷贝表项（只有几个指针大小）。
      */
-    class PropertySetterBase
-    {
-    public:
-        virtual ~PropertySetterBase() = default;
-        virtual void set(void *instance, const Any &value) = 0;
-        virtual Any get(const void *instance) const = 0;
-    };
+    typedef FieldThunk PropertySetterBase;
+    typedef MethodThunk MethodInvokerBase;
 
     /**
-     * @brief 方法调用器基类
+     * @brief 编译期参数列表的类型信息与签名哈希
      */
-    class MethodInvokerBase
+    template <typename... Args>
+    struct MethodSignature
     {
-    public:
-        virtual ~MethodInvokerBase() = default;
-        virtual Any invoke(void *instance, const std::vector<Any> &args) const = 0;
+        static const TypeOps &argOps(std::size_t index)
+        {
+            // 末尾的 void 占位保证空参数列表时数组非空
+            static const TypeOps *const ops[] = {
+                &TypeOps::of<typename std::decay<Args>::type>()..., &TypeOps::of<void>()};
+            return *ops[index];
+        }
+
+        static std::size_t hash()
+        {
+            static const std::size_t value = computeHash();
+            return value;
+        }
+
+        /// 按非 const 左值引用传递的参数位掩码（第 i 位对应第 i 个参数）
+        static std::uint32_t outArgs()
+        {
+            static_assert(sizeof...(Args) <= 32, "参数个数超过 32 个");
+            // 末尾的 false 占位保证空参数列表时数组非空
+            static const bool writable[] = {
+                (std::is_lvalue_reference<Args>::value &&
+                 !std::is_const<typename std::remove_reference<Args>::type>::value)...,
+                false};
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < sizeof...(Args); ++i)
+            {
+                mask |= writable[i] ? 1u << i : 0u;
+            }
+            return mask;
+        }
+
+    private:
+        static std::size_t computeHash()
+        {
+            std::size_t seed = sizeof...(Args);
+#if EVENTLY_HAS_CXX17
+            ((seed = combineSignatureHash(seed, typeid(typename std::decay<Args>::type).hash_code())), ...);
+#else
+            for (std::size_t i = 0; i < sizeof...(Args); ++i)
+            {
+                seed = combineSignatureHash(seed, argOps(i).type->hash_code());
+            }
+#endif
+            return seed;
+        }
     };
 
     /**
-     * @brief 对象工厂基类
+     * @brief 解析后的具体方法：可直接用于类型化调用
+     *
+     * 按值保存具体签名的调用器（已展开重载和继承，实例指针的调整量也在其中），
+     * 之后该类再注册成员也不影响已解析的方法。
      */
-    class ObjectFactory
+    struct ResolvedMethod
     {
-    public:
-        virtual ~ObjectFactory() = default;
-        virtual std::unique_ptr<void, void (*)(void *)> create() = 0;
+        MethodThunk invoker;
+
+        ResolvedMethod() : invoker() {}
+        explicit ResolvedMethod(const MethodThunk &method) : invoker(method) {}
+
+        explicit operator bool() const { return invoker.invoker != nullptr; }
+
+        /// 类型化调用（参见 MethodThunk::invokeRaw）
+        void invokeRaw(void *instance, const void *const *args, void *result) const
+        {
+            invoker.invokeRaw(instance, args, result);
+        }
     };
 
     /**
-     * @brief 字符串对哈希函数
+     * @brief 批量调用的一列参数
+     *
+     * 第 i 个实例使用 data + i * stride 处的值；stride 为 0 表示所有实例共享同一个值。
+     * 只保存指针，调用期间参数数据必须保持有效。按非 const 引用传递的参数会被方法修改，
+     * 只能使用逐实例的列，共享列会被拒绝（各工作线程会同时修改同一个对象）。
      */
-    struct PairHash
+    struct BatchColumn
     {
-        std::size_t operator()(const std::pair<std::string, std::string> &pair) const;
+        const void *data;
+        std::size_t stride;
+        const std::type_info *type;
+
+        /// 所有实例共享同一个参数值
+        template <typename T>
+        static BatchColumn shared(const T &value)
+        {
+            BatchColumn column = {&value, 0, &typeid(T)};
+            return column;
+        }
+
+        /// 每个实例各自的参数值（与实例数组一一对应）
+        template <typename T>
+        static BatchColumn perInstance(const T *values)
+        {
+            BatchColumn column = {values, sizeof(T), &typeid(T)};
+            return column;
+        }
+
+        template <typename T>
+        static BatchColumn perInstance(const std::vector<T> &values)
+        {
+            return perInstance(values.data());
+        }
     };
 
     /**
-     * @brief 字符串对相等比较函数
+     * @brief 计算派生类指针到基类子对象的调整量
+     *
+     * 只支持非虚继承（虚基类的偏移在运行时才能确定，下面的向下转换会编译失败）。
      */
-    struct PairEqual
+    template <typename Derived, typename Base>
+    std::ptrdiff_t baseClassOffset()
     {
-        bool operator()(const std::pair<std::string, std::string> &lhs,
-                        const std::pair<std::string, std::string> &rhs) const;
-    };
+        static_assert(std::is_base_of<Base, Derived>::value, "Base 必须是 Derived 的基类");
+        // 只做指针运算，不会构造或访问对象
+        static typename std::aligned_storage<sizeof(Derived), alignof(Derived)>::type storage;
+        Derived *derived = reinterpret_cast<Derived *>(&storage);
+        Base *base = static_cast<Base *>(derived);
+        (void)static_cast<Derived *>(base); // 虚继承时此处无法编译
+        return reinterpret_cast<char *>(base) - reinterpret_cast<char *>(derived);
+    }
 
     /**
-     * @brief 成员变量属性设置器模板类
+     * @brief 枚举字段时交给访问者的类型擦除引用（不拷贝字段值）
      */
-    template <typename T, typename FieldType>
-    class PropertySetter : public PropertySetterBase
+    struct ValueRef
     {
-    public:
-        PropertySetter(FieldType T::*field);
-        void set(void *instance, const Any &value) override;
-        Any get(const void *instance) const override;
+        const TypeOps *ops;
+        const void *address;
 
-    private:
-        FieldType T::*field_;
+        const std::type_info &type() const { return *ops->type; }
+
+        /// 类型匹配时返回指向原值的指针，否则返回 nullptr
+        template <typename T>
+        const T *as() const
+        {
+            return *ops->type == typeid(T) ? static_cast<const T *>(address) : nullptr;
+        }
+
+        /// 拷贝到 Any（类型不可拷贝时返回空 Any）
+        Any toAny() const { return ops->box != nullptr ? ops->box(address) : Any(); }
     };
 
     /**
-     * @brief 成员函数调用器模板类（非void返回类型）
+     * @brief 按值类型分类把字段交给访问者
+     *
+     * 常用的算术类型和 std::string 以 visitor(name, const T &value) 调用，
+     * 其他类型以 visitor(name, ValueRef) 调用。分派是对 ValueKind 的 switch，
+     * 不构造 Any，也不分配内存。
      */
-    template <typename T, typename ReturnType, typename... Args>
-    class MethodInvoker : public MethodInvokerBase
+    template <typename Visitor>
+    void visitValue(const std::string &name, const TypeOps &ops, const void *value, Visitor &visitor)
+    {
+        switch (ops.kind)
+        {
+        case ValueKind::Bool:
+            visitor(name, *static_cast<const bool *>(value));
+            break;
+        case ValueKind::Char:
+            visitor(name, *static_cast<const char *>(value));
+            break;
+        case ValueKind::SignedChar:
+            visitor(name, *static_cast<const signed char *>(value));
+            break;
+        case ValueKind::UnsignedChar:
+            visitor(name, *static_cast<const unsigned char *>(value));
+            break;
+        case ValueKind::Short:
+            visitor(name, *static_cast<const short *>(value));
+            break;
+        case ValueKind::UnsignedShort:
+            visitor(name, *static_cast<const unsigned short *>(value));
+            break;
+        case ValueKind::Int:
+            visitor(name, *static_cast<const int *>(value));
+            break;
+        case ValueKind::UnsignedInt:
+            visitor(name, *static_cast<const unsigned int *>(value));
+            break;
+        case ValueKind::Long:
+            visitor(name, *static_cast<const long *>(value));
+            break;
+        case ValueKind::UnsignedLong:
+            visitor(name, *static_cast<const unsigned long *>(value));
+            break;
+        case ValueKind::LongLong:
+            visitor(name, *static_cast<const long long *>(value));
+            break;
+        case ValueKind::UnsignedLongLong:
+            visitor(name, *static_cast<const unsigned long long *>(value));
+            break;
+        case ValueKind::Float:
+            visitor(name, *static_cast<const float *>(value));
+            break;
+        case ValueKind::Double:
+            visitor(name, *static_cast<const double *>(value));
+            break;
+        case ValueKind::LongDouble:
+            visitor(name, *static_cast<const long double *>(value));
+            break;
+        case ValueKind::String:
+            visitor(name, *static_cast<const std::string *>(value));
+            break;
+        case ValueKind::Other:
+        default:
+            ValueRef ref = {&ops, value};
+            visitor(name, ref);
+            break;
+        }
+    }
+
+    /**
+     * @brief 对象工厂基类
+     */
+    class ObjectFactory
     {
     public:
-        using MethodType = ReturnType (T::*)(Args...);
+        virtual ~ObjectFactory() = default;
+        virtual std::unique_ptr<void, void (*)(void *)> create() = 0;
 
-        MethodInvoker(MethodType method);
-        Any invoke(void *instance, const std::vector<Any> &args) const override;
+        /// 实例的大小和对齐，供容器在自己的连续内存中就地构造；不支持时 size 为 0
+        virtual std::size_t size() const { return 0; }
+        virtual std::size_t alignment() const { return 1; }
 
-    private:
-        MethodType method_;
+        /// 在 memory（至少 size() 字节、按 alignment() 对齐）处构造实例
+        virtual void construct(void *memory)
+        {
+            (void)memory;
+            throw std::runtime_error("工厂不支持就地构造");
+        }
 
-        template <std::size_t... Indexes>
-        Any invokeImpl(T *obj, const std::vector<Any> &args,
-                       index_sequence<Indexes...>) const;
+        /// 析构 construct 构造的实例，不释放内存
+        virtual void destroy(void *object) const { (void)object; }
     };
 
+    class ReflectionRegistry;
+    class ThreadPool;
+    class InstanceStrands;
+    class CopyPlan;
+    class ComparePlan;
+
     /**
-     * @brief void返回类型的方法调用器特化
+     * @brief 经注册表写入字段后的通知（setValue、setPathValue、setEnumName）
+     *
+     * 在执行写入的线程上同步调用：任何线程经同一注册表写入时都会调用到，
+     * 实现须能与自身的其他操作并发执行。
      */
-    template <typename T, typename... Args>
-    class MethodInvoker<T, void, Args...> : public MethodInvokerBase
+    class FieldWriteListener
     {
     public:
-        using MethodType = void (T::*)(Args...);
+        virtual ~FieldWriteListener() = default;
 
-        MethodInvoker(MethodType method);
-        Any invoke(void *instance, const std::vector<Any> &args) const override;
+        /// field 是被写入的值在 instance 中的地址
+        virtual void fieldWritten(void *instance, const void *field) = 0;
+    };
 
-    private:
-        MethodType method_;
+    /**
+     * @brief 类注册函数类型（用于延迟注册）
+     *
+     * 注册函数在该类第一次被查询时才会执行，负责注册字段、方法和工厂。
+     */
+    typedef void (*ClassRegistrar)(ReflectionRegistry &registry);
 
-    template <std::size_t... Indexes>
-    Any invokeImpl(T *obj, const std::vector<Any> &args,
-               index_sequence<Indexes...>) const;
+    /**
+     * @brief 字符串对哈希函数
+     */
+    struct PairHash
+    {
+        std::size_t operator()(const std::pair<std::string, std::string> &pair) const;
     };
 
     /**
-     * @brief const成员函数调用器模板类
+     * @brief 字符串对相等比较函数
      */
-    template <typename T, typename ReturnType, typename... Args>
-    class ConstMethodInvoker : public MethodInvokerBase
+    struct PairEqual
     {
-    public:
-        using MethodType = ReturnType (T::*)(Args...) const;
-
-        ConstMethodInvoker(MethodType method);
-        Any invoke(void *instance, const std::vector<Any> &args) const override;
-
-    private:
-        MethodType method_;
-
-    template <std::size_t... Indexes>
-    Any invokeImpl(const T *obj, const std::vector<Any> &args,
-               index_sequence<Indexes...>) const;
+        bool operator()(const std::pair<std::string, std::string> &lhs,
+                        const std::pair<std::string, std::string> &rhs) const;
     };
 
     /**
@@ -153,6 +341,11 @@ namespace Evently
                 [](void *p)
                 { delete static_cast<T *>(p); });
         }
+
+        std::size_t size() const override { return sizeof(T); }
+        std::size_t alignment() const override { return alignof(T); }
+        void construct(void *memory) override { new (memory) T(); }
+        void destroy(void *object) const override { static_cast<T *>(object)->~T(); }
     };
 
     /**
@@ -170,7 +363,21 @@ namespace Evently
             return createImpl(typename index_sequence_for<Args...>::type{});
         }
 
+        std::size_t size() const override { return sizeof(T); }
+        std::size_t alignment() const override { return alignof(T); }
+        void construct(void *memory) override
+        {
+            constructImpl(memory, typename index_sequence_for<Args...>::type{});
+        }
+        void destroy(void *object) const override { static_cast<T *>(object)->~T(); }
+
     private:
+        template <std::size_t... Is>
+        void constructImpl(void *memory, index_sequence<Is...>)
+        {
+            new (memory) T(std::get<Is>(args_)...);
+        }
+
         template <std::size_t... Is>
         std::unique_ptr<void, void (*)(void *)> createImpl(index_sequence<Is...>)
         {
@@ -185,16 +392,103 @@ namespace Evently
     };
 
     /**
-     * @brief 反射注册表类（单例模式）
+     * @brief 注册表内存占用统计
+     */
+    struct RegistryMemoryStats
+    {
+        struct Structure
+        {
+            std::string name;    ///< 结构名（如 "memberTables"、"names"）
+            std::size_t entries; ///< 元素个数
+            std::size_t bytes;   ///< 估算字节数
+        };
+
+        std::vector<Structure> structures;          ///< 按结构
+        std::map<std::string, std::size_t> classes; ///< 按类：成员、索引、成员表等归属于该类的部分
+        std::size_t totalBytes;
+
+        RegistryMemoryStats() : totalBytes(0) {}
+    };
+
+    /**
+     * @brief 反射注册表类
+     *
+     * getInstance() 返回进程内默认的单例；也可以构造互不影响的独立实例，
+     * 或在共享的父注册表上叠加子注册表（每个线程或分片一份，注册与查询不触及父注册表的可变状态）。
      */
     class ReflectionRegistry
     {
     public:
         static ReflectionRegistry &getInstance();
 
+        /// 构造空的独立注册表（与单例互不影响）
+        ReflectionRegistry();
+
+        /**
+         * @brief 构造叠加在父注册表之上的子注册表
+         *
+         * 父注册表只被读取：查询的类未在子注册表中注册时转到父注册表（可逐级叠加）；
+         * 在子注册表中注册过成员、工厂、基类或延迟注册的类整体遮蔽父注册表中的同名类。
+         * 子注册表中的类可以继承父注册表中的类，继承时复制基类当时的扁平成员表。
+         * 父注册表须比子注册表存续更久，派生子注册表后不应再向父注册表注册。
+         *
+         * @code
+         * ReflectionRegistry shard(&ReflectionRegistry::getInstance());
+         * shard.registerField("Order", "total", &Order::total);  // 只在分片内可见
+         * shard.getValues("Person", "age", &person);              // 来自父注册表
+         * @endcode
+         */
+        explicit ReflectionRegistry(const ReflectionRegistry *parent);
+
+        ~ReflectionRegistry();
+
+        /// 父注册表，独立注册表和单例为 nullptr
+        const ReflectionRegistry *parent() const { return parent_; }
+
         template <typename T>
         void registerClassName(const std::string &className);
 
+        /**
+         * @brief 延迟注册类：只记录类名到注册函数的映射
+         *
+         * 注册函数在第一次按类名查询（字段、方法、工厂）或调用
+         * getClassName<T>() 时执行，且只执行一次（线程安全）。
+         * 同一注册函数可以登记多个类名（如工厂别名），任一名称触发后全部完成。
+         */
+        template <typename T>
+        void registerLazyClass(const std::string &className, ClassRegistrar registrar);
+
+        void registerLazyClass(const std::string &className, ClassRegistrar registrar);
+
+        /// 类是否仍有尚未执行的延迟注册
+        bool hasPendingRegistration(const std::string &className) const;
+
+        /**
+         * @brief 登记插件模块：其中的类第一次被查询（字段、方法、工厂）时打开模块并执行注册函数
+         *
+         * 模块用 EVENTLY_PLUGIN 定义注册函数。与延迟注册一样只加载一次且线程安全；
+         * 注册函数中注册的所有类都归属该模块。
+         */
+        void registerPlugin(const std::string &modulePath, const std::vector<std::string> &classNames);
+
+        /**
+         * @brief 读取插件清单并登记其中的模块
+         *
+         * 每行为“类名 模块路径”，空行和 # 开头的行被忽略；相对路径相对于清单所在目录。
+         * @throws std::runtime_error 无法读取清单或某行格式错误
+         */
+        void loadPluginManifest(const std::string &manifestPath);
+
+        bool isPluginLoaded(const std::string &modulePath) const;
+
+        /**
+         * @brief 卸载插件模块：移除它注册的类并关闭共享库，之后再次查询这些类会重新加载
+         * @return 模块未加载、仍有 createInstance 创建的实例未释放、或有模块外的类继承其中的类时返回 false
+         *
+         * 与注册一样不应与查询并发执行。卸载前须释放模块类型的值（Any、成员表、已解析方法、调用计划等）。
+         */
+        bool unloadPlugin(const std::string &modulePath);
+
         template <typename T, typename ReturnType, typename... Args>
         void registerMethod(const std::string &className, const std::string &methodName,
                             ReturnType (T::*method)(Args...));
@@ -217,13 +511,15 @@ namespace Evently
         template <typename T, typename... Args>
         void registerClass(const std::string &className, Args... args)
         {
+            WriteSection section(*this);
+            markOwned(className);
             if (sizeof...(args) == 0)
             {
-                factories_[className] = std::unique_ptr<ObjectFactory>(new ObjectFactoryImpl<T>());
+                factories_[names_.intern(className)] = std::unique_ptr<ObjectFactory>(new ObjectFactoryImpl<T>());
             }
             else
             {
-                factories_[className] = std::unique_ptr<ObjectFactory>(
+                factories_[names_.intern(className)] = std::unique_ptr<ObjectFactory>(
                     new ObjectFactoryWithParamImpl<T, typename std::decay<Args>::type...>(
                         std::forward<Args>(args)...));
             }
@@ -232,19 +528,44 @@ namespace Evently
         template <typename... Args>
         std::unique_ptr<void, void (*)(void *)> createInstance(const std::string &className) const
         {
-            auto it = factories_.find(className);
-            if (it != factories_.end())
-            {
-                return it->second->create();
-            }
-            return {nullptr, [](void *) {}};
+            return createInstanceImpl(className);
         }
 
+        /**
+         * @brief 类的工厂，没有注册工厂时返回 nullptr
+         *
+         * 供需要自行管理实例内存的容器使用（size / construct / destroy）。
+         * 就地构造的实例不计入插件的存活实例，容器须在卸载插件前释放它们。
+         */
+        ObjectFactory *factory(const std::string &className) const;
+
         template <typename T>
         std::string getClassName() const;
 
-        PropertySetterBase *getSetter(const std::string &className,
-                                      const std::string &fieldName) const;
+        /// 按类型信息查询注册的类名，未注册时返回 "unregistered"
+        std::string classNameOf(const std::type_info &type) const;
+
+        /// 查找可写字段的访问器，字段不存在或为 const 时返回 nullptr
+        const PropertySetterBase *getSetter(const std::string &className,
+                                            const std::string &fieldName) const;
+
+        /**
+         * @brief 查找字段访问器（包括 const 字段，只用于读取或类型化访问）
+         * @return 未注册时返回 nullptr
+         */
+        const PropertySetterBase *findField(const std::string &className,
+                                            const std::string &fieldName) const;
+
+        /**
+         * @brief 取得容器字段的视图，直接引用实例中的容器而不拷贝
+         * @throws std::runtime_error 字段不存在；std::invalid_argument 字段不是支持的容器类型
+         *
+         * const 字段或 const 实例得到只读视图。
+         */
+        ContainerView containerField(const std::string &className, const std::string &fieldName,
+                                     void *instance) const;
+        ContainerView containerField(const std::string &className, const std::string &fieldName,
+                                     const void *instance) const;
 
         std::unordered_map<std::string, Any> getAllValues(const std::string &className,
                                                           const void *instance) const;
@@ -255,178 +576,821 @@ namespace Evently
         Any invokeMethod(const std::string &className, const std::string &methodName,
                          void *instance, const std::vector<Any> &args) const;
 
+        /**
+         * @name 不分配内存的查找
+         *
+         * 以 NameRef（指针 + 长度 + 哈希）为键：用携带的哈希直接定位成员，再比较名字确认，
+         * 不构造 std::string 键，也不重新计算哈希。以 std::string 为参数的同名接口也经由这里查找。
+         * @code
+         * using namespace Evently::literals;
+         * registry.findField("Person"_name, "age"_name);
+         * registry.invokeMethod(EVENTLY_NAME("Person"), NameRef(token, tokenLength), &person, args);
+         * @endcode
+         * @{
+         */
+        const PropertySetterBase *findField(const NameRef &className, const NameRef &fieldName) const;
+        const PropertySetterBase *getSetter(const NameRef &className, const NameRef &fieldName) const;
+        Any getValues(const NameRef &className, const NameRef &fieldName, const void *instance) const;
+        Any invokeMethod(const NameRef &className, const NameRef &methodName,
+                         void *instance, const std::vector<Any> &args) const;
+        /** @} */
+
         std::set<std::string> getMethodNames(const std::string &className) const;
 
+        /**
+         * @brief 注册表内存占用（按结构和按类）
+         *
+         * 按各容器的元素、节点、桶数组和字符串堆内存估算，不含内存分配器自身的开销；
+         * 属性路径缓存不计入。
+         */
+        RegistryMemoryStats memoryStats() const;
+
+        /**
+         * @brief 注册完成后收紧内存：释放各容器多余的预留容量，哈希表按元素数重新分桶
+         *
+         * 之后仍可继续注册，容器会按需重新增长。与注册一样，不应与查询并发执行。
+         */
+        void compact();
+
+        /**
+         * @brief 类的扁平成员表：字段和方法表项按注册顺序连续存放，调用不经过虚函数
+         * @return 类没有注册任何成员时返回 nullptr；表在该类再次注册成员前有效
+         */
+        const MemberTable *memberTable(const std::string &className) const;
+
+        /**
+         * @brief 按字段元数据把 src 拷贝到 dst（两者都是 className 的实例）
+         *
+         * 相邻的平凡可拷贝字段合并为一次 memcpy，其余字段用自身的拷贝赋值；
+         * const 字段和未注册的成员不拷贝。拷贝计划按类缓存，字段或继承关系变化后重建。
+         * @throws std::runtime_error 实例为空或类没有注册字段
+         */
+        void copyInto(const std::string &className, void *dst, const void *src) const;
+
+        /**
+         * @brief 用注册的工厂创建实例，再从 src 拷贝字段
+         * @throws std::runtime_error 类没有注册工厂或字段
+         */
+        std::unique_ptr<void, void (*)(void *)> clone(const std::string &className, const void *src) const;
+
+        /// 类的拷贝计划（缓存），sample 是该类的任一实例，用于求字段偏移
+        std::shared_ptr<const CopyPlan> copyPlan(const std::string &className, const void *sample) const;
+
+        /**
+         * @brief 按字段元数据比较两个 className 的实例
+         *
+         * 相邻的按字节可比字段合并为一次 memcmp，其余字段用自身的 operator==。
+         * @throws std::invalid_argument 某个字段不支持相等比较
+         */
+        bool equals(const std::string &className, const void *a, const void *b) const;
+
+        /**
+         * @brief 按注册顺序逐字段三路比较，返回负数、0 或正数
+         * @throws std::invalid_argument 某个字段不支持 operator<
+         */
+        int compare(const std::string &className, const void *a, const void *b) const;
+
+        /**
+         * @brief 由全部注册字段计算的非加密哈希（同一进程内相等的对象哈希相同）
+         * @throws std::invalid_argument 某个字段不可哈希
+         */
+        std::uint64_t hash(const std::string &className, const void *object) const;
+
+        /// 类的比较计划（缓存），sample 的含义同 copyPlan
+        std::shared_ptr<const ComparePlan> comparePlan(const std::string &className, const void *sample) const;
+
+        /**
+         * @brief 注册枚举的名字和值
+         *
+         * 之后类型为 E 的字段可以经 TypeOps::enumInfo 直接取得名字表，不再按名字查找；
+         * CsvReader / CsvWriter 按名字读写这些字段。同一枚举类型以最近一次注册为准。
+         * @param flags 位标志枚举：组合值格式化为 "Read|Write"
+         * @throws std::invalid_argument 没有枚举项、名字为空或重复
+         *
+         * @code
+         * registry.registerEnum<Color>("Color", {{"Red", Color::Red}, {"Green", Color::Green}});
+         * registry.enumToString(Color::Green);        // "Green"
+         * registry.getEnumName("Car", "color", &car); // 字段值的名字
+         * @endcode
+         */
+        template <typename E>
+        const EnumInfo &registerEnum(const std::string &enumName, const std::vector<std::pair<std::string, E>> &values,
+                                     bool flags = false);
+
+        /// 按名字查询注册的枚举（本层没有时查父注册表），没有时返回 nullptr
+        const EnumInfo *enumInfo(const std::string &enumName) const;
+
+        /// 枚举类型的名字表，未注册时返回 nullptr
+        template <typename E>
+        const EnumInfo *enumInfo() const
+        {
+            static_assert(std::is_enum<E>::value, "enumInfo<E> 需要枚举类型");
+            return detail::EnumSlot<E>::get();
+        }
+
+        /// @throws std::invalid_argument 枚举未注册
+        template <typename E>
+        std::string enumToString(E value) const;
+
+        /// @throws std::invalid_argument 枚举未注册，或文本不是它的名字或数值
+        template <typename E>
+        E enumFromString(const std::string &text) const;
+
+        /**
+         * @brief 读取枚举字段值的名字（位标志为组合写法）
+         * @throws std::runtime_error 字段不存在；std::invalid_argument 字段类型不是已注册的枚举
+         */
+        std::string getEnumName(const std::string &className, const std::string &fieldName,
+                                const void *instance) const;
+
+        /**
+         * @brief 按名字写入枚举字段
+         * @throws std::runtime_error 字段不存在；std::invalid_argument 字段不是已注册的枚举、const 字段或名字无效
+         */
+        void setEnumName(const std::string &className, const std::string &fieldName, void *instance,
+                         const std::string &name) const;
+
+        /**
+         * @brief 按注册顺序枚举类的字段（含继承字段），不拷贝名字和字段值
+         *
+         * 访问者需要为常用类型提供 operator()(const std::string &name, const T &value)，
+         * 并为其他类型提供 operator()(const std::string &name, ValueRef value)（参见 visitValue）。
+         * 名字引用注册表内部保存的字符串，在注册表存续期间有效。
+         * 仍有待加载的类时先拷贝表项并结束查询登记，再调用访问者，访问者期间不阻塞延迟加载。
+         */
+        template <typename Visitor>
+        void forEachField(const std::string &className, const void *instance, Visitor &&visitor) const;
+
+        /**
+         * @brief 按注册顺序枚举类的方法，以 visitor(const std::string &name, const MethodInvokerBase &method) 调用
+         *
+         * 重载方法的每个签名各调用一次，同名的多次调用名字相同。
+         * method 是类的成员表中的调用器，继承来的方法已包含实例指针的调整量，可以直接调用。
+         * 仍有待加载的类时 method 是表项的拷贝，只在该次访问者调用期间有效。
+         */
+        template <typename Visitor>
+        void forEachMethod(const std::string &className, Visitor &&visitor) const;
+
+        /**
+         * @brief 解析嵌套属性路径，如 "customer.address.city"、"items[3].price"
+         *
+         * 路径中间经过的字段类型需要用 registerClassName<T>（或 registerLazyClass<T>）登记类名；
+         * 下标只能用于 std::vector、std::deque、std::array 字段。
+         * @throws std::invalid_argument 路径格式错误或对不支持下标的字段使用下标
+         * @throws std::runtime_error 字段不存在或中间类型未登记
+         */
+        PropertyPath resolvePath(const std::string &className, const std::string &path) const;
+
+        /// 从 LRU 缓存取得已解析的路径，未命中时解析并加入缓存
+        std::shared_ptr<const PropertyPath> cachedPath(const std::string &className,
+                                                       const std::string &path) const;
+
+        /// 按路径读取值（只拷贝末端值）
+        Any getPathValue(const std::string &className, const std::string &path,
+                         const void *instance) const;
+
+        /// 按路径写入值，类型必须与末端字段一致
+        void setPathValue(const std::string &className, const std::string &path,
+                          void *instance, const Any &value) const;
+
+        /**
+         * @brief 写入字段并通知写入监听者
+         * @throws std::runtime_error 字段不存在；std::invalid_argument const 字段或值类型不匹配
+         */
+        void setValue(const std::string &className, const std::string &fieldName, void *instance,
+                      const Any &value) const;
+
+        /**
+         * @brief 登记写入监听者：经 setValue、setPathValue、setEnumName 的写入都会通知它
+         *
+         * 没有监听者时写入只多读一个原子计数。可与其他线程的写入并发登记或移除：
+         * 写入时通知的是当时的监听者列表快照；removeWriteListener 等到其他线程对该监听者
+         * 正在进行的通知结束才返回，之后即可销毁监听者。不能在监听者的回调中移除它自身。
+         */
+        void addWriteListener(FieldWriteListener *listener);
+        void removeWriteListener(FieldWriteListener *listener);
+
+        /// 设置路径缓存容量（默认 256，0 表示不缓存）
+        void setPathCacheCapacity(std::size_t capacity);
+
+        /**
+         * @brief 在内置的工作窃取线程池上异步调用方法
+         * @return 完成后可取得返回值的 future；查找或调用失败的异常也通过 future 抛出
+         *
+         * 同一实例上的异步调用按提交顺序串行执行，不同实例之间并行执行。
+         * 参数在提交时复制，调用方需保证实例在调用完成前有效。
+         */
+        std::future<Any> invokeAsync(const std::string &className, const std::string &methodName,
+                                     void *instance, const std::vector<Any> &args) const;
+
+        /**
+         * @brief 设置异步调用线程池的工作线程数（0 表示硬件并发数）
+         *
+         * 与现有线程池的实际线程数不同时，之后的调用改用按新线程数创建的线程池；
+         * 旧线程池在最后一个使用者释放后执行完已提交的任务再析构。
+         * 不要在线程池的任务中调整线程数。
+         */
+        void setAsyncWorkerCount(std::size_t workerCount);
+
+        /**
+         * @brief 异步调用线程池（首次使用时创建）
+         *
+         * 返回的共享指针让线程池在使用期间保持有效，即使其间调整了线程数；
+         * 需要在一次操作中多次使用时持有同一个指针。
+         */
+        std::shared_ptr<ThreadPool> asyncPool() const;
+
+        /**
+         * @brief 按参数类型解析出具体的方法，供批量调用、调用计划等重复使用
+         * @throws std::runtime_error 方法不存在，或没有与参数类型匹配的签名
+         */
+        ResolvedMethod resolveMethod(const std::string &className, const std::string &methodName,
+                                     const std::vector<const std::type_info *> &argTypes) const;
+
+        /**
+         * @brief 在多个实例上并行调用同一个已解析的方法
+         * @param instances 实例指针数组
+         * @param count 实例个数
+         * @param columns 每个参数一列，共享值或逐实例的值
+         * @param results 类型化的结果缓冲区（至少 count 个元素），R 必须与方法返回类型一致
+         * @throws std::invalid_argument 参数列与签名不符，或按非 const 引用传递的参数使用了共享列
+         *
+         * 调用在异步线程池上分块执行，每个分块复用同一个参数指针数组，
+         * 参数和返回值都不经过 Any。实例数组中不应出现重复的实例。
+         */
+        template <typename R>
+        void invokeBatch(const ResolvedMethod &method, void *const *instances, std::size_t count,
+                         const std::vector<BatchColumn> &columns, R *results) const
+        {
+            invokeBatchImpl(method, instances, count, columns, results, sizeof(R), typeid(R));
+        }
+
+        /// 丢弃返回值的批量调用
+        void invokeBatch(const ResolvedMethod &method, void *const *instances, std::size_t count,
+                         const std::vector<BatchColumn> &columns) const
+        {
+            invokeBatchImpl(method, instances, count, columns, nullptr, 0, typeid(void));
+        }
+
+        /**
+         * @brief 声明继承关系，并把基类（含其祖先）的字段和方法扁平化到派生类
+         *
+         * 派生类自己注册的同名成员优先；多继承出现同名成员时先声明的基类优先。
+         * 之后再向基类注册的成员会自动同步到所有派生类。
+         */
+        template <typename Derived, typename Base>
+        void registerBase(const std::string &derivedName, const std::string &baseName);
+
+        /// derivedClass 是否（直接或间接）继承自 baseClass
+        bool isDerivedFrom(const std::string &derivedClass, const std::string &baseClass) const;
+
+        /**
+         * @brief 在已注册的继承体系内转换实例指针（向上或向下）
+         * @return 调整后的指针；两个类之间没有继承关系时返回 nullptr
+         *
+         * 向下转换与 static_cast 一样不做运行时类型检查。
+         */
+        void *castInstance(const std::string &fromClass, const std::string &toClass,
+                           void *instance) const;
+
     private:
-        ReflectionRegistry();
         ReflectionRegistry(const ReflectionRegistry &) = delete;
         ReflectionRegistry &operator=(const ReflectionRegistry &) = delete;
 
-        std::unordered_map<std::pair<std::string, std::string>,
-                           std::unique_ptr<PropertySetterBase>,
-                           PairHash, PairEqual>
-            setters_;
+        /**
+         * @brief 查询期间的读者登记
+         *
+         * 仍有待加载的类时，查询登记为读者（一次原子计数，不加锁），加载线程修改映射表时
+         * （WriteSection）等待其他线程的读者退出。同一线程的嵌套查询只登记一次，加载线程自身的查询不登记。
+         */
+        class LookupGuard
+        {
+        public:
+            LookupGuard() : registry_(nullptr) {}
+            explicit LookupGuard(const ReflectionRegistry &registry);
+            LookupGuard(LookupGuard &&other) noexcept : registry_(other.registry_) { other.registry_ = nullptr; }
+            LookupGuard &operator=(LookupGuard &&other) noexcept;
+            ~LookupGuard();
+
+            LookupGuard(const LookupGuard &) = delete;
+            LookupGuard &operator=(const LookupGuard &) = delete;
+
+            /// 是否已登记（登记时仍有待加载的类）
+            bool active() const { return registry_ != nullptr; }
+            /// 提前结束登记
+            void release();
+
+        private:
+            const ReflectionRegistry *registry_;
+        };
+
+        /**
+         * @brief 串行的延迟加载：持有 lazyMutex_ 并记录加载线程（可重入）
+         *
+         * 不等待读者：注册函数执行期间，其他类的查询照常进行，只有查询正在加载的类
+         * （仍处于待加载状态）的线程在 lazyMutex_ 上等待加载完成。已登记查询的线程
+         * 等待 lazyMutex_ 时暂不计入读者，加载线程的 WriteSection 不会等待它。
+         */
+        class LoadLock
+        {
+        public:
+            explicit LoadLock(const ReflectionRegistry &registry);
+            ~LoadLock();
+
+            LoadLock(const LoadLock &) = delete;
+            LoadLock &operator=(const LoadLock &) = delete;
+
+        private:
+            const ReflectionRegistry &registry_;
+            bool outermost_;
+        };
+
+        /**
+         * @brief 加载线程修改映射表的区间：等待其他线程登记的查询退出，期间新的查询等待（可嵌套）
+         *
+         * 只在持有 LoadLock 的线程上生效，每次注册调用独占一次，查询只等待单次修改而不是整个注册函数；
+         * 其他时候的注册按注册表的并发约定不与查询并发，什么也不做。
+         */
+        class WriteSection
+        {
+        public:
+            explicit WriteSection(const ReflectionRegistry &registry);
+            ~WriteSection();
+
+            WriteSection(const WriteSection &) = delete;
+            WriteSection &operator=(const WriteSection &) = delete;
+
+        private:
+            const ReflectionRegistry *registry_; ///< 本区间负责独占时非空
+        };
+
+        /**
+         * @brief 查询前的登记与延迟加载
+         *
+         * 没有待加载的类时什么也不做；否则登记为读者，按类的待加载状态判断是否需要加载，
+         * 只有该类仍待加载时才取得 lazyMutex_ 执行其注册函数。
+         */
+        LookupGuard lockForLookup(const std::string &className) const;
+        LookupGuard lockForLookup(const NameRef &className) const;
+
+        /// 该类仍待加载时执行其注册函数（调用方需已登记查询）
+        void loadIfPending(const NameRef &className) const;
+        /// 类是否仍待加载（调用方需已登记查询或持有 lazyMutex_，不分配内存）
+        bool lazyPending(const NameRef &className) const;
+        /// 按延迟注册表和待加载插件表刷新该类的待加载状态（调用方持有 LoadLock）
+        void refreshLazyStateLocked(NamePool::Id classId);
+
+        void beginLookup() const;
+        void endLookup() const;
+
+        /**
+         * @brief 负责该类的注册表层：本层注册过该类时为自身，否则沿父注册表向上查找
+         *
+         * 都没有注册过时返回自身，由本层给出“未找到”的结果。没有父注册表时不做任何查找。
+         */
+        const ReflectionRegistry &layerFor(const NameRef &className) const;
+
+        /// 本层是否注册过该类（只在有父注册表时记录）
+        bool ownsClass(const NameRef &className) const;
+
+        /// 直接注册类时调用：记录本层归属，加载插件期间还记录到该模块
+        void markOwned(const std::string &className);
+
+        std::unique_ptr<void, void (*)(void *)> createInstanceImpl(const std::string &className) const;
+
+        /// 打开插件模块并执行注册函数（调用方持有 LoadLock）
+        void loadPluginLocked(PluginModule &module) const;
+        PluginModule *findPlugin(const std::string &modulePath) const;
+
+        /// 移除类的全部注册信息（卸载插件时使用）
+        void removeClassLocked(const std::string &className);
+
+        /// 待加载数 = 未执行的延迟注册函数 + 未加载模块中的类
+        void updatePendingLocked() const;
+
+        /// 类的成员表，没有注册成员时返回 nullptr（不分配内存，调用方需已经过 lockForLookup）
+        const MemberTable *findTable(const NameRef &className) const;
+        const PropertySetterBase *findFieldLocked(const NameRef &className, const NameRef &fieldName) const;
+
+        /// 执行类的延迟注册（调用方需持有 LoadLock）
+        void loadLazyClassLocked(NamePool::Id classId) const;
+        /// 注册函数执行完（或抛出异常）后清除这些类的待加载状态并更新待加载数（调用方需持有 LoadLock）
+        void finishLoadLocked(const std::vector<NamePool::Id> &classIds) const;
+
+        /// 类名在本层名字池中的编号（不分配内存）；未出现过时为 npos，在任何按类索引的表中都查不到
+        NamePool::Id findClassId(const std::string &className) const { return names_.find(NameRef(className)); }
+
+        /// 登记类型对应的类名 / 取得登记的类名（未登记时为空串，不转到父注册表）
+        void setClassName(const std::type_info &type, const std::string &className);
+        std::string registeredClassName(const std::type_info &type) const;
+
+        /**
+         * @brief 直接基类信息
+         */
+        struct BaseClassInfo
+        {
+            NamePool::Id classId;  ///< 基类名在本层名字池中的编号
+            std::ptrdiff_t offset; ///< 派生类指针到该基类子对象的调整量
+        };
+
+        void registerBaseImpl(const std::string &derivedName, const std::string &baseName,
+                              std::ptrdiff_t offset);
+        void addAncestor(NamePool::Id classId, NamePool::Id ancestorId, std::ptrdiff_t offset);
+        /// 本类注册字段 / 方法（方法同名不同签名时作为重载加入，签名相同时替换）
+        void addField(const std::string &className, const std::string &fieldName, const FieldThunk &field);
+        void addMethod(const std::string &className, const std::string &methodName, const MethodThunk &method);
+        /// 把基类成员表中的同名成员按第 baseIndex 个直接基类的来源写入派生类，表变化时继续同步到其派生类
+        void inheritField(NamePool::Id derivedId, const std::string &fieldName, FieldThunk field,
+                          std::ptrdiff_t offset, std::size_t baseIndex);
+        void inheritMethods(NamePool::Id derivedId, const std::string &methodName, std::vector<MethodThunk> methods,
+                            std::ptrdiff_t offset, std::size_t baseIndex);
+        /// 把类的某个成员（当前的表项）同步到其直接派生类
+        void propagateField(NamePool::Id classId, const std::string &fieldName);
+        void propagateMethods(NamePool::Id classId, const std::string &methodName);
+
+        /// 注册信息变化后丢弃已缓存的路径和拷贝计划
+        void invalidatePaths();
+
+        /// 按需创建异步调用线程池（调用方需持有 asyncMutex_）
+        /// 线程池与按实例串行的分发器（析构时先排空线程池，分发器在此期间仍然有效）
+        struct AsyncRuntime;
+        void ensureAsyncPoolLocked() const;
+
+        void invokeBatchImpl(const ResolvedMethod &method, void *const *instances, std::size_t count,
+                             const std::vector<BatchColumn> &columns, void *results,
+                             std::size_t resultStride, const std::type_info &resultType) const;
+
+        // 按类的扁平成员表：字段和方法（含继承来的）的唯一存储
+        std::unordered_map<NamePool::Id, MemberTable> memberTables_;
+
+        // 类名和成员名的驻留池（成员表中的名字都引用这里）
+        NamePool names_;
+
+        // 叠加的父注册表，以及本层注册过的类（名字编号）
+        const ReflectionRegistry *parent_;
+        std::unordered_set<NamePool::Id> ownedClasses_;
+
+        // 以下按类名（类型名）在 names_ 中的编号索引，查询时经 names_.find 取得编号，不构造字符串
+        std::unordered_map<NamePool::Id, NamePool::Id> classNames_; ///< typeid 名字 -> 类名
+        std::unordered_map<NamePool::Id, std::unique_ptr<ObjectFactory>> factories_;
+
+        // 延迟注册：类名 -> 注册函数（加载后移除）
+        std::unordered_map<NamePool::Id, ClassRegistrar> lazyRegistrars_;
+
+        // 插件模块：清单中的类、尚未加载的类，以及已加载的类所属的模块
+        std::vector<std::unique_ptr<PluginModule>> plugins_;
+        std::unordered_map<NamePool::Id, PluginModule *> pluginClasses_;
+        std::unordered_map<NamePool::Id, PluginModule *> pendingPlugins_;
+        std::unordered_map<NamePool::Id, PluginModule *> classPlugins_;
+        PluginModule *loadingPlugin_;
+        mutable std::atomic<std::size_t> pendingLazy_;
+        mutable std::recursive_mutex lazyMutex_;
+
+        // 每个延迟类（名字编号）的待加载状态：加载完成前为 true，注册函数执行完后清除
+        std::unordered_map<NamePool::Id, std::atomic<bool>> lazyStates_;
+        // 登记中的查询数、其中等待 lazyMutex_ 的数目、加载线程是否在 WriteSection 中，以及持有 LoadLock 的线程
+        mutable std::atomic<std::size_t> activeLookups_;
+        mutable std::atomic<std::size_t> parkedLookups_;
+        mutable std::atomic<bool> writing_;
+        mutable std::atomic<std::thread::id> loadingThread_;
+
+        // 继承关系：直接基类、直接派生类，以及扁平化后的全部祖先及其偏移
+        std::unordered_map<NamePool::Id, std::vector<BaseClassInfo>> bases_;
+        std::unordered_map<NamePool::Id, std::vector<NamePool::Id>> derived_;
+        std::unordered_map<NamePool::Id, std::unordered_map<NamePool::Id, std::ptrdiff_t>> ancestors_;
+
+        // 异步调用：asyncPool() 交出的指针与这里共享同一个运行时
+        mutable std::mutex asyncMutex_;
+        std::size_t asyncWorkerCount_;
+        mutable std::shared_ptr<AsyncRuntime> asyncRuntime_;
+
+        // 字段写入监听者（见 addWriteListener）：登记和移除时整体替换为新的不可变列表，
+        // 写入方在锁内只取得列表快照，遍历和回调都在锁外；被替换的快照记为弱引用，
+        // 移除监听者时等待仍含有它的快照全部释放
+        typedef std::vector<FieldWriteListener *> ListenerList;
+        std::shared_ptr<const ListenerList> writeListeners_;
+        std::vector<std::weak_ptr<const ListenerList>> retiredListeners_;
+        std::atomic<std::size_t> writeListenerCount_;
+        mutable std::mutex writeListenerMutex_;
+
+        /// 替换当前监听者列表（调用方持有 writeListenerMutex_）
+        void replaceListenersLocked(const std::shared_ptr<const ListenerList> &listeners);
+
+        void notifyWrite(void *instance, const void *field) const
+        {
+            if (writeListenerCount_.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+            std::shared_ptr<const ListenerList> listeners;
+            {
+                std::lock_guard<std::mutex> lock(writeListenerMutex_);
+                listeners = writeListeners_;
+            }
+            if (listeners)
+            {
+                for (FieldWriteListener *listener : *listeners)
+                {
+                    listener->fieldWritten(instance, field);
+                }
+            }
+        }
+
+        // 注册的枚举：按名字，析构时清除仍指向这里的类型槽位
+        std::unordered_map<std::string, std::unique_ptr<EnumInfo>> enums_;
 
-        std::unordered_map<std::pair<std::string, std::string>,
-                           std::unique_ptr<MethodInvokerBase>,
-                           PairHash, PairEqual>
-            methods_;
+        /// 保存枚举并设置类型槽位，替换同名的旧表
+        const EnumInfo &addEnum(std::unique_ptr<EnumInfo> info);
 
-        // 标记字段是否可写（const 字段不可写，但仍可通过 get 读取）
-        std::unordered_map<std::pair<std::string, std::string>, bool, PairHash, PairEqual>
-            setterWritable_;
+        // 已解析的属性路径
+        mutable PropertyPathCache pathCache_;
 
-        std::unordered_map<std::string, std::set<std::string>> methodNames_;
-        std::unordered_map<std::string, std::string> classNames_;
-        std::unordered_map<std::string, std::unique_ptr<ObjectFactory>> factories_;
+        // 按类缓存的拷贝计划和比较计划
+        mutable std::mutex planCacheMutex_;
+        mutable std::unordered_map<std::string, std::shared_ptr<const CopyPlan>> copyPlans_;
+        mutable std::unordered_map<std::string, std::shared_ptr<const ComparePlan>> comparePlans_;
     };
 
     // ReflectionRegistry 模板方法实现
-    // 参数获取辅助函数 - 处理引用类型
-    template <typename ParamType>
-    static ParamType getParam(const Any &arg)
+    template <typename E>
+    const EnumInfo &ReflectionRegistry::registerEnum(const std::string &enumName,
+                                                     const std::vector<std::pair<std::string, E>> &values, bool flags)
     {
-        return any_cast<ParamType>(arg);
+        static_assert(std::is_enum<E>::value, "registerEnum 需要枚举类型");
+        typedef typename std::underlying_type<E>::type Underlying;
+        std::vector<EnumInfo::Entry> entries;
+        entries.reserve(values.size());
+        for (const auto &value : values)
+        {
+            EnumInfo::Entry entry = {value.first, static_cast<long long>(static_cast<Underlying>(value.second))};
+            entries.push_back(entry);
+        }
+        return addEnum(std::unique_ptr<EnumInfo>(new EnumInfo(enumName, typeid(E), sizeof(E),
+                                                              std::is_signed<Underlying>::value, flags, entries,
+                                                              &detail::EnumSlot<E>::slot)));
     }
 
-    // 非void返回类型的实现
-    template <typename T, typename ReturnType, typename... Args>
-    inline MethodInvoker<T, ReturnType, Args...>::MethodInvoker(MethodType method)
-        : method_(method) {}
-
-    template <typename T, typename ReturnType, typename... Args>
-    Any MethodInvoker<T, ReturnType, Args...>::invoke(void *instance,
-                                                      const std::vector<Any> &args) const
+    template <typename E>
+    std::string ReflectionRegistry::enumToString(E value) const
     {
-        if (args.size() != sizeof...(Args))
+        const EnumInfo *info = enumInfo<E>();
+        if (info == nullptr)
         {
-            throw std::invalid_argument("参数数量不匹配");
+            throw std::invalid_argument(std::string("枚举未注册: ") + typeid(E).name());
         }
-        T *obj = static_cast<T *>(instance);
-        return invokeImpl(obj, args, typename index_sequence_for<Args...>::type{});
+        typedef typename std::underlying_type<E>::type Underlying;
+        return info->toString(static_cast<long long>(static_cast<Underlying>(value)));
     }
 
-    template <typename T, typename ReturnType, typename... Args>
-    template <std::size_t... Indexes>
-    inline Any MethodInvoker<T, ReturnType, Args...>::invokeImpl(
-        T *obj, const std::vector<Any> &args, index_sequence<Indexes...>) const
+    template <typename E>
+    E ReflectionRegistry::enumFromString(const std::string &text) const
     {
-
-        try
+        const EnumInfo *info = enumInfo<E>();
+        if (info == nullptr)
         {
-            return Any((obj->*method_)(getParam<Args>(args[Indexes])...));
+            throw std::invalid_argument(std::string("枚举未注册: ") + typeid(E).name());
         }
-        catch (const bad_any_cast &e)
+        typedef typename std::underlying_type<E>::type Underlying;
+        return static_cast<E>(static_cast<Underlying>(info->fromString(text)));
+    }
+
+    // 参数获取辅助函数 - 处理引用类型
+    // 按去掉引用和 cv 的类型取出存储值，引用参数直接绑定到实参 Any 中的对象
+    template <typename ValueType>
+    static const ValueType &checkedParam(const Any &arg)
+    {
+        const ValueType *value = any_cast<ValueType>(&arg);
+        if (value == nullptr)
         {
-            std::cerr << "参数类型转换失败: " << e.what() << "\n";
-            throw;
+            throw bad_any_cast("bad any cast from " + std::string(arg.type().name()) +
+                               " to " + std::string(typeid(ValueType).name()));
         }
+        return *value;
     }
 
-    // void返回类型的特化实现
-    template <typename T, typename... Args>
-    inline MethodInvoker<T, void, Args...>::MethodInvoker(MethodType method)
-        : method_(method) {}
+    /// 非 const 左值引用参数需要调用期副本时的存放处（由 getParam 的默认实参创建，调用结束时销毁）
+    template <typename ParamType>
+    struct ParamCopy
+    {
+        std::unique_ptr<typename std::decay<ParamType>::type> value;
+    };
 
-    template <typename T, typename... Args>
-    Any MethodInvoker<T, void, Args...>::invoke(void *instance,
-                                                const std::vector<Any> &args) const
+    template <typename ParamType>
+    static ParamType getParam(const Any &arg, ParamCopy<ParamType> &, std::false_type)
     {
-        if (args.size() != sizeof...(Args))
+        typedef typename std::decay<ParamType>::type ValueType;
+        return static_cast<ParamType>(const_cast<ValueType &>(checkedParam<ValueType>(arg)));
+    }
+
+    // 非 const 左值引用参数会写入实参：共享存储（Any::shared）的值可能同时被其他 Any 和其他线程读取，
+    // 方法改为写入调用期间的副本，实参本身不被修改
+    template <typename ParamType>
+    static ParamType getParam(const Any &arg, ParamCopy<ParamType> &copy, std::true_type)
+    {
+        typedef typename std::decay<ParamType>::type ValueType;
+        const ValueType &value = checkedParam<ValueType>(arg);
+        if (!arg.isShared())
         {
-            throw std::invalid_argument("参数数量不匹配");
+            return const_cast<ValueType &>(value);
         }
-        T *obj = static_cast<T *>(instance);
-        return invokeImpl(obj, args, typename index_sequence_for<Args...>::type{});
+        copy.value.reset(new ValueType(value));
+        return *copy.value;
     }
 
-    template <typename T, typename... Args>
-    template <std::size_t... Indexes>
-    inline Any MethodInvoker<T, void, Args...>::invokeImpl(
-        T *obj, const std::vector<Any> &args, index_sequence<Indexes...>) const
+    // 默认实参中的临时对象存续到包含调用的完整表达式结束，即方法返回之后
+    template <typename ParamType>
+    static ParamType getParam(const Any &arg, ParamCopy<ParamType> &&copy = ParamCopy<ParamType>())
     {
+        return getParam<ParamType>(
+            arg, copy, std::integral_constant<bool, std::is_lvalue_reference<ParamType>::value &&
+                                                        !std::is_const<typename std::remove_reference<ParamType>::type>::value>());
+    }
 
-        try
-        {
-            (obj->*method_)(getParam<Args>(args[Indexes])...);
-            return Any();
-        }
-        catch (const bad_any_cast &e)
-        {
-            std::cerr << "参数类型转换失败: " << e.what() << "\n";
-            throw;
-        }
+    // 类型化调用的参数获取：指针已由调用方按 argType 校验
+    template <typename ParamType>
+    static ParamType getRawParam(const void *arg)
+    {
+        typedef typename std::decay<ParamType>::type ValueType;
+        return static_cast<ParamType>(*const_cast<ValueType *>(static_cast<const ValueType *>(arg)));
     }
 
-    template <typename T, typename ReturnType, typename... Args>
-    template <std::size_t... Indexes>
-    inline Any ConstMethodInvoker<T, ReturnType, Args...>::invokeImpl(
-        const T *obj, const std::vector<Any> &args, index_sequence<Indexes...>) const
+    /**
+     * @brief 类型化调用的返回值写入（void 返回类型特化为直接调用）
+     */
+    template <typename ReturnType>
+    struct RawResult
     {
-        try
+        template <typename Call>
+        static void store(const Call &call, void *result)
         {
-            if constexpr (!std::is_void<ReturnType>::value)
+            if (result != nullptr)
             {
-                return Any((obj->*method_)(getParam<Args>(args[Indexes])...));
+                *static_cast<typename std::decay<ReturnType>::type *>(result) = call();
             }
             else
             {
-                (obj->*method_)(getParam<Args>(args[Indexes])...);
-                return Any();
+                call();
             }
         }
-        catch (const bad_any_cast &e)
+    };
+
+    template <>
+    struct RawResult<void>
+    {
+        template <typename Call>
+        static void store(const Call &call, void *)
         {
-            std::cerr << "参数类型转换失败: " << e.what() << "\n";
-            throw;
+            call();
         }
-    }
+    };
 
-    // PropertySetter 实现
-    template <typename T, typename FieldType>
-    PropertySetter<T, FieldType>::PropertySetter(FieldType T::*field) : field_(field) {}
+    /**
+     * @brief 字段访问器的函数（按字段类型实例化，经表项中的偏移定位字段）
+     */
+    template <typename FieldType>
+    struct FieldThunkFunctions
+    {
+        static Any get(const FieldThunk &thunk, const void *instance)
+        {
+            return Any(*static_cast<const FieldType *>(thunk.fieldAddress(instance)));
+        }
 
-    template <typename T, typename FieldType>
-    void PropertySetter<T, FieldType>::set(void *instance, const Any &value)
+        static void set(const FieldThunk &thunk, void *instance, const Any &value)
+        {
+            const FieldType *typed = any_cast<FieldType>(&value);
+            if (typed == nullptr)
+            {
+                throw std::invalid_argument("PropertySetter: Invalid type for field");
+            }
+            *static_cast<FieldType *>(const_cast<void *>(thunk.fieldAddress(instance))) = *typed;
+        }
+
+        template <typename T>
+        static FieldThunk make(FieldType T::*field)
+        {
+            // 与 baseClassOffset 相同，只做地址运算，不构造对象
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            const T *object = reinterpret_cast<const T *>(&storage);
+
+            FieldThunk thunk;
+            thunk.getter = &get;
+            thunk.setter = setterOf(std::is_const<FieldType>());
+            thunk.ops = &TypeOps::of<FieldType>();
+            thunk.offset = reinterpret_cast<const char *>(&(object->*field)) - reinterpret_cast<const char *>(object);
+            return thunk;
+        }
+
+    private:
+        static FieldThunk::Setter setterOf(std::true_type) { return nullptr; }
+        static FieldThunk::Setter setterOf(std::false_type) { return &set; }
+    };
+
+    /**
+     * @brief 方法表项的函数（Object 为 T 或 const T，Method 为对应的成员函数指针类型）
+     */
+    template <typename Object, typename Method, typename ReturnType, typename... Args>
+    struct MethodThunkFunctions
     {
-        T *obj = static_cast<T *>(instance);
+        static Object *object(const MethodThunk &thunk, void *instance)
+        {
+            return reinterpret_cast<Object *>(static_cast<char *>(instance) + thunk.adjust);
+        }
+
+        static Any invoke(const MethodThunk &thunk, void *instance, const std::vector<Any> &args)
+        {
+            if (args.size() != sizeof...(Args))
+            {
+                throw std::invalid_argument("参数数量不匹配");
+            }
+            return call(object(thunk, instance), loadMemberPointer<Method>(thunk.member), args,
+                        typename index_sequence_for<Args...>::type{}, std::is_void<ReturnType>());
+        }
+
+        static void invokeRaw(const MethodThunk &thunk, void *instance, const void *const *args, void *result)
+        {
+            callRaw(object(thunk, instance), loadMemberPointer<Method>(thunk.member), args, result,
+                    typename index_sequence_for<Args...>::type{});
+        }
 
-        if constexpr (std::is_const<FieldType>::value)
+        static MethodThunk make(Method method)
         {
-            throw std::invalid_argument("PropertySetter: Cannot set value of const field");
+            MethodThunk thunk;
+            thunk.invoker = &invoke;
+            thunk.rawInvoker = &invokeRaw;
+            thunk.argOpsOf = &MethodSignature<Args...>::argOps;
+            thunk.resultOps = &TypeOps::of<typename std::decay<ReturnType>::type>();
+            thunk.arity = static_cast<std::uint32_t>(sizeof...(Args));
+            thunk.outArgs = MethodSignature<Args...>::outArgs();
+            thunk.hash = MethodSignature<Args...>::hash();
+            thunk.adjust = 0;
+            storeMemberPointer(thunk.member, method);
+            return thunk;
         }
-        else
+
+    private:
+        template <std::size_t... Indexes>
+        static Any call(Object *obj, Method method, const std::vector<Any> &args,
+                        index_sequence<Indexes...>, std::false_type)
         {
+            (void)args;
             try
             {
-                obj->*field_ = any_cast<FieldType>(value);
+                return Any((obj->*method)(getParam<Args>(args[Indexes])...));
             }
-            catch (const bad_any_cast &)
+            catch (const bad_any_cast &e)
             {
-                throw std::invalid_argument("PropertySetter: Invalid type for field");
+                std::cerr << "参数类型转换失败: " << e.what() << "\n";
+                throw;
             }
         }
-    }
 
-    template <typename T, typename FieldType>
-    Any PropertySetter<T, FieldType>::get(const void *instance) const
-    {
-        const T *obj = static_cast<const T *>(instance);
-        return Any(obj->*field_);
-    }
+        template <std::size_t... Indexes>
+        static Any call(Object *obj, Method method, const std::vector<Any> &args,
+                        index_sequence<Indexes...>, std::true_type)
+        {
+            (void)args;
+            try
+            {
+                (obj->*method)(getParam<Args>(args[Indexes])...);
+                return Any();
+            }
+            catch (const bad_any_cast &e)
+            {
+                std::cerr << "参数类型转换失败: " << e.what() << "\n";
+                throw;
+            }
+        }
+
+        template <std::size_t... Indexes>
+        static void callRaw(Object *obj, Method method, const void *const *args, void *result,
+                            index_sequence<Indexes...>)
+        {
+            (void)args;
+            RawResult<ReturnType>::store([&]() -> ReturnType
+                                         { return (obj->*method)(getRawParam<Args>(args[Indexes])...); },
+                                         result);
+        }
+    };
 
     // ReflectionRegistry 模板方法实现
     template <typename T>
     void ReflectionRegistry::registerClassName(const std::string &className)
     {
-        classNames_[typeid(T).name()] = className;
+        setClassName(typeid(T), className);
+    }
+
+    template <typename T>
+    void ReflectionRegistry::registerLazyClass(const std::string &className, ClassRegistrar registrar)
+    {
+        // 类型名映射很轻量，提前登记以便 getClassName<T>() 能触发加载
+        setClassName(typeid(T), className);
+        registerLazyClass(className, registrar);
     }
 
     template <typename T>
     std::string ReflectionRegistry::getClassName() const
     {
-        auto it = classNames_.find(typeid(T).name());
-        return it != classNames_.end() ? it->second : "unregistered";
+        return classNameOf(typeid(T));
     }
 
     template <typename T, typename ReturnType, typename... Args>
@@ -434,11 +1398,8 @@ namespace Evently
                                             const std::string &methodName,
                                             ReturnType (T::*method)(Args...))
     {
-        auto key = std::make_pair(className, methodName);
-
-        methods_[key] = std::unique_ptr<MethodInvokerBase>(
-            new MethodInvoker<T, ReturnType, Args...>(method));
-        methodNames_[className].insert(methodName);
+        addMethod(className, methodName,
+                  MethodThunkFunctions<T, ReturnType (T::*)(Args...), ReturnType, Args...>::make(method));
     }
 
     template <typename T, typename ReturnType>
@@ -446,10 +1407,7 @@ namespace Evently
                                             const std::string &methodName,
                                             ReturnType (T::*method)())
     {
-        auto key = std::make_pair(className, methodName);
-        methods_[key] = std::unique_ptr<MethodInvokerBase>(
-            new MethodInvoker<T, ReturnType>(method));
-        methodNames_[className].insert(methodName);
+        addMethod(className, methodName, MethodThunkFunctions<T, ReturnType (T::*)(), ReturnType>::make(method));
     }
 
     template <typename T, typename ReturnType, typename... Args>
@@ -457,10 +1415,8 @@ namespace Evently
                                             const std::string &methodName,
                                             ReturnType (T::*method)(Args...) const)
     {
-        auto key = std::make_pair(className, methodName);
-        methods_[key] = std::unique_ptr<MethodInvokerBase>(
-            new ConstMethodInvoker<T, ReturnType, Args...>(method));
-        methodNames_[className].insert(methodName);
+        addMethod(className, methodName,
+                  MethodThunkFunctions<const T, ReturnType (T::*)(Args...) const, ReturnType, Args...>::make(method));
     }
 
     template <typename T, typename FieldType>
@@ -468,33 +1424,102 @@ namespace Evently
                                            const std::string &fieldName,
                                            FieldType T::*field)
     {
-        auto key = std::make_pair(className, fieldName);
-        setterWritable_[key] = !std::is_const<FieldType>::value;
-        setters_[key] = std::unique_ptr<PropertySetterBase>(
-            new PropertySetter<T, FieldType>(field));
+        addField(className, fieldName, FieldThunkFunctions<FieldType>::make(field));
     }
 
     template <typename T, typename FieldType>
     void ReflectionRegistry::registerField(const std::string &fieldName,
                                            FieldType T::*field)
     {
-        auto key = std::make_pair(classNames_[typeid(T).name()], fieldName);
-        setterWritable_[key] = !std::is_const<FieldType>::value;
-        setters_[key] = std::unique_ptr<PropertySetterBase>(
-            new PropertySetter<T, FieldType>(field));
+        const std::string className = registeredClassName(typeid(T));
+        addField(className, fieldName, FieldThunkFunctions<FieldType>::make(field));
     }
 
-    template <typename T, typename ReturnType, typename... Args>
-    inline ConstMethodInvoker<T, ReturnType, Args...>::ConstMethodInvoker(MethodType method)
-        : method_(method) {}
+    template <typename Visitor>
+    void ReflectionRegistry::forEachField(const std::string &className, const void *instance,
+                                          Visitor &&visitor) const
+    {
+        if (instance == nullptr)
+        {
+            throw std::runtime_error("实例指针不能为空");
+        }
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            layer.forEachField(className, instance, std::forward<Visitor>(visitor));
+            return;
+        }
+        auto lock = lockForLookup(className);
+        const MemberTable *table = findTable(NameRef(className));
+        if (table == nullptr)
+        {
+            return;
+        }
+        if (!lock.active())
+        {
+            // 没有待加载的类，表不会被并发修改，直接遍历（不分配内存）
+            for (std::size_t i = 0; i < table->fieldCount(); ++i)
+            {
+                const FieldThunk &field = table->field(i);
+                visitValue(table->fieldName(i), field.fieldOps(), field.fieldAddress(instance), visitor);
+            }
+            return;
+        }
+        // 访问者可能耗时或触发加载：拷贝表项后结束登记，不在登记期间调用访问者
+        std::vector<std::pair<const std::string *, FieldThunk>> fields;
+        fields.reserve(table->fieldCount());
+        for (std::size_t i = 0; i < table->fieldCount(); ++i)
+        {
+            fields.push_back(std::make_pair(&table->fieldName(i), table->field(i)));
+        }
+        lock.release();
+        for (const auto &entry : fields)
+        {
+            visitValue(*entry.first, entry.second.fieldOps(), entry.second.fieldAddress(instance), visitor);
+        }
+    }
 
-    template <typename T, typename ReturnType, typename... Args>
-    inline Any ConstMethodInvoker<T, ReturnType, Args...>::invoke(void *instance, const std::vector<Any> &args) const
+    template <typename Visitor>
+    void ReflectionRegistry::forEachMethod(const std::string &className, Visitor &&visitor) const
+    {
+        const ReflectionRegistry &layer = layerFor(NameRef(className));
+        if (&layer != this)
+        {
+            layer.forEachMethod(className, std::forward<Visitor>(visitor));
+            return;
+        }
+        auto lock = lockForLookup(className);
+        const MemberTable *table = findTable(NameRef(className));
+        if (table == nullptr)
+        {
+            return;
+        }
+        if (!lock.active())
+        {
+            for (std::size_t i = 0; i < table->methodCount(); ++i)
+            {
+                visitor(table->methodName(i), table->method(i));
+            }
+            return;
+        }
+        // 与 forEachField 相同：拷贝表项后结束登记再调用访问者
+        std::vector<std::pair<const std::string *, MethodThunk>> methods;
+        methods.reserve(table->methodCount());
+        for (std::size_t i = 0; i < table->methodCount(); ++i)
+        {
+            methods.push_back(std::make_pair(&table->methodName(i), table->method(i)));
+        }
+        lock.release();
+        for (const auto &entry : methods)
+        {
+            visitor(*entry.first, entry.second);
+        }
+    }
+
+    template <typename Derived, typename Base>
+    void ReflectionRegistry::registerBase(const std::string &derivedName, const std::string &baseName)
     {
-        if (args.size() != sizeof...(Args))
-            throw std::invalid_argument("参数数量不匹配");
-        const T *obj = static_cast<const T *>(instance);
-        return invokeImpl(obj, args, typename index_sequence_for<Args...>::type{});
+        registerBaseImpl(derivedName, baseName, baseClassOffset<Derived, Base>());
     }
 }
 
@@ -0,0 +1,53 @@
+#include "Reflection.h"
+#include <string>
+
+/**
+ * @brief 测试用插件模块：按需加载的类
+ *
+ * 模块不链接反射库，注册表的实现来自加载它的宿主程序。
+ */
+
+/// 注册函数的执行次数（模块被真正卸载后重新从 0 开始）
+static int hookCalls = 0;
+
+/**
+ * @brief 插件中的类
+ */
+class Greeter
+{
+public:
+    std::string greet(const std::string &who)
+    {
+        ++greetings_;
+        return name_ + "向" + who + "问好";
+    }
+
+    int hookCalls() const { return ::hookCalls; }
+
+public:
+    std::string name_ = "插件";
+    int greetings_ = 0;
+};
+
+/**
+ * @brief 同一模块中的第二个类（查询它同样触发模块加载）
+ */
+class Farewell
+{
+public:
+    std::string words_ = "再见";
+};
+
+EVENTLY_PLUGIN(registry)
+{
+    ++hookCalls;
+    registry.registerClassName<Greeter>("Greeter");
+    registry.registerClass<Greeter>("Greeter");
+    registry.registerField<Greeter>("Greeter", "name", &Greeter::name_);
+    registry.registerField<Greeter>("Greeter", "greetings", &Greeter::greetings_);
+    registry.registerMethod<Greeter, std::string, const std::string &>("Greeter", "greet", &Greeter::greet);
+    registry.registerMethod<Greeter, int>("Greeter", "hookCalls", &Greeter::hookCalls);
+
+    registry.registerClass<Farewell>("Farewell");
+    registry.registerField<Farewell>("Farewell", "words", &Farewell::words_);
+}
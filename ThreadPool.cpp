@@ -0,0 +1,298 @@
+#include "ThreadPool.h"
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+namespace Evently
+{
+
+    namespace
+    {
+        // 当前线程所属的线程池及其队列下标（非工作线程为 nullptr）
+        thread_local ThreadPool *currentPool = nullptr;
+        thread_local std::size_t currentIndex = 0;
+    }
+
+    std::size_t ThreadPool::resolveWorkerCount(std::size_t workerCount)
+    {
+        if (workerCount == 0)
+        {
+            workerCount = std::thread::hardware_concurrency();
+            if (workerCount == 0)
+            {
+                workerCount = 1;
+            }
+        }
+        return workerCount;
+    }
+
+    ThreadPool::ThreadPool(std::size_t workerCount)
+        : pending_(0), nextQueue_(0), stopping_(false)
+    {
+        workerCount = resolveWorkerCount(workerCount);
+
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            threads_.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            stopping_ = true;
+        }
+        idleCv_.notify_all();
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        if (!task)
+        {
+            throw std::invalid_argument("ThreadPool: 任务不能为空");
+        }
+
+        // 工作线程内部提交的任务放入自己的队列，保持局部性
+        std::size_t index = currentPool == this
+                                ? currentIndex
+                                : nextQueue_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        {
+            std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+            workers_[index]->tasks.push_back(std::move(task));
+        }
+        pending_.fetch_add(1, std::memory_order_release);
+
+        // 短暂持有 idleMutex_，避免与工作线程的等待判断之间丢失唤醒
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+        }
+        idleCv_.notify_one();
+    }
+
+    bool ThreadPool::popLocal(std::size_t index, std::function<void()> &task)
+    {
+        Worker &worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool ThreadPool::steal(std::size_t thief, std::function<void()> &task)
+    {
+        for (std::size_t i = 1; i < workers_.size(); ++i)
+        {
+            Worker &victim = *workers_[(thief + i) % workers_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::workerLoop(std::size_t index)
+    {
+        currentPool = this;
+        currentIndex = index;
+
+        for (;;)
+        {
+            std::function<void()> task;
+            if (popLocal(index, task) || steal(index, task))
+            {
+                pending_.fetch_sub(1, std::memory_order_acq_rel);
+                try
+                {
+                    task();
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "线程池任务异常: " << e.what() << '\n';
+                }
+                catch (...)
+                {
+                    std::cerr << "线程池任务异常: 未知异常\n";
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            idleCv_.wait(lock, [this]
+                         { return stopping_ || pending_.load(std::memory_order_acquire) != 0; });
+            // 退出前先执行完剩余任务
+            if (stopping_ && pending_.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    namespace
+    {
+        /**
+         * @brief parallelFor 的共享状态
+         *
+         * 由 shared_ptr 持有：调用线程可能在辅助任务开始前就完成了所有分块，
+         * 之后才运行的辅助任务仍需安全地访问它。
+         */
+        struct ParallelForState
+        {
+            std::function<void(std::size_t, std::size_t)> body;
+            std::size_t count;
+            std::size_t grain;
+            std::size_t chunks;
+            std::atomic<std::size_t> next;
+            std::atomic<std::size_t> done;
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+
+            ParallelForState() : count(0), grain(1), chunks(0), next(0), done(0) {}
+
+            // 循环领取分块直到全部被领取
+            void run()
+            {
+                for (;;)
+                {
+                    std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= chunks)
+                    {
+                        return;
+                    }
+                    std::size_t begin = chunk * grain;
+                    std::size_t end = begin + grain < count ? begin + grain : count;
+                    try
+                    {
+                        body(begin, end);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                        {
+                            error = std::current_exception();
+                        }
+                    }
+                    if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        finished.notify_all();
+                    }
+                }
+            }
+        };
+    }
+
+    void ThreadPool::parallelFor(std::size_t count, std::size_t grain,
+                                 const std::function<void(std::size_t, std::size_t)> &body)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (grain == 0)
+        {
+            grain = 1;
+        }
+
+        std::shared_ptr<ParallelForState> state(new ParallelForState());
+        state->body = body;
+        state->count = count;
+        state->grain = grain;
+        state->chunks = (count + grain - 1) / grain;
+
+        // 调用线程自己也会领取分块，辅助任务最多 workerCount 个
+        std::size_t helpers = state->chunks - 1 < workers_.size() ? state->chunks - 1 : workers_.size();
+        for (std::size_t i = 0; i < helpers; ++i)
+        {
+            submit([state]()
+                   { state->run(); });
+        }
+        state->run();
+
+        // 只等待已被领取的分块执行完毕，不等待尚未开始的辅助任务
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state]
+                             { return state->done.load(std::memory_order_acquire) == state->chunks; });
+        if (state->error)
+        {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    InstanceStrands::InstanceStrands(ThreadPool &pool) : pool_(pool) {}
+
+    void InstanceStrands::post(const void *instance, std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = queues_.find(instance);
+            if (it != queues_.end())
+            {
+                // 该实例已有任务在执行，排队等待
+                it->second.push_back(std::move(task));
+                return;
+            }
+            queues_[instance];
+        }
+        schedule(instance, std::move(task));
+    }
+
+    void InstanceStrands::schedule(const void *instance, std::function<void()> task)
+    {
+        // std::function 要求可拷贝，用 shared_ptr 持有任务避免重复拷贝捕获的参数
+        std::shared_ptr<std::function<void()>> shared(new std::function<void()>(std::move(task)));
+        pool_.submit([this, instance, shared]()
+                     {
+                         try
+                         {
+                             (*shared)();
+                         }
+                         catch (...)
+                         {
+                             // 保证异常时仍能继续执行该实例的后续任务
+                             runNext(instance);
+                             throw;
+                         }
+                         runNext(instance); });
+    }
+
+    void InstanceStrands::runNext(const void *instance)
+    {
+        std::function<void()> next;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = queues_.find(instance);
+            if (it == queues_.end())
+            {
+                return;
+            }
+            if (it->second.empty())
+            {
+                queues_.erase(it);
+                return;
+            }
+            next = std::move(it->second.front());
+            it->second.pop_front();
+        }
+        schedule(instance, std::move(next));
+    }
+
+} // namespace Evently
@@ -0,0 +1,99 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Evently
+{
+
+    /**
+     * @brief 工作窃取线程池
+     *
+     * 每个工作线程有自己的任务队列：从自己队列尾部取任务（LIFO，缓存友好），
+     * 自己的队列为空时从其他线程队列头部窃取。工作线程内部提交的任务进入
+     * 自己的队列，外部线程提交的任务轮流分配到各队列。
+     */
+    class ThreadPool
+    {
+    public:
+        /// @param workerCount 工作线程数，0 表示使用硬件并发数
+        explicit ThreadPool(std::size_t workerCount = 0);
+
+        /// 构造时实际使用的工作线程数：0 解析为硬件并发数（无法取得时为 1）
+        static std::size_t resolveWorkerCount(std::size_t workerCount);
+
+        /// 执行完所有已提交的任务后退出
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /// 提交任务；任务抛出的异常会被记录并吞掉，需要结果请使用 std::packaged_task
+        void submit(std::function<void()> task);
+
+        std::size_t workerCount() const { return workers_.size(); }
+
+        /**
+         * @brief 把 [0, count) 按 grain 大小分块并行执行 body(begin, end)
+         *
+         * 调用线程也参与执行，因此可以在工作线程内部嵌套调用而不会死锁。
+         * 任一分块抛出的第一个异常会在全部分块结束后重新抛出。
+         */
+        void parallelFor(std::size_t count, std::size_t grain,
+                         const std::function<void(std::size_t, std::size_t)> &body);
+
+    private:
+        struct Worker
+        {
+            std::deque<std::function<void()>> tasks;
+            std::mutex mutex;
+        };
+
+        void workerLoop(std::size_t index);
+        bool popLocal(std::size_t index, std::function<void()> &task);
+        bool steal(std::size_t thief, std::function<void()> &task);
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+        std::atomic<std::size_t> pending_;   ///< 已提交但尚未开始执行的任务数
+        std::atomic<std::size_t> nextQueue_; ///< 外部提交时轮转的目标队列
+        std::mutex idleMutex_;
+        std::condition_variable idleCv_;
+        bool stopping_;
+    };
+
+    /**
+     * @brief 按实例串行化的任务分发器
+     *
+     * 同一实例的任务按提交顺序逐个执行，任意时刻最多一个在运行；
+     * 不同实例的任务在线程池中并行执行。
+     */
+    class InstanceStrands
+    {
+    public:
+        explicit InstanceStrands(ThreadPool &pool);
+
+        void post(const void *instance, std::function<void()> task);
+
+    private:
+        void schedule(const void *instance, std::function<void()> task);
+        void runNext(const void *instance);
+
+        ThreadPool &pool_;
+        std::mutex mutex_;
+        // 正在执行任务的实例 -> 等待中的后续任务
+        std::unordered_map<const void *, std::deque<std::function<void()>>> queues_;
+    };
+
+} // namespace Evently
+
+#endif // THREAD_POOL_H
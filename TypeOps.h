@@ -0,0 +1,643 @@
+#ifndef TYPE_OPS_H
+#define TYPE_OPS_H
+#pragma once
+
+#include "Any.h"
+#include "EnumInfo.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <map>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Evently
+{
+
+    struct TypeOps;
+
+    /**
+     * @brief 容器类型的操作表
+     *
+     * 顺序容器：std::vector、std::deque、std::array、std::list；
+     * 关联容器：std::map、std::unordered_map（元素为映射值，另有键类型）。
+     * 所有操作都直接作用于原容器，不拷贝容器本身。不支持的操作为 nullptr。
+     */
+    struct ContainerOps
+    {
+        /// 遍历回调：key 对顺序容器为 nullptr
+        typedef void (*Visitor)(void *context, const void *key, const void *element);
+
+        bool associative;
+        bool unordered; ///< 遍历顺序与插入历史有关（unordered_map），相等的容器可能以不同顺序遍历
+        const TypeOps &(*elementOps)();
+        const TypeOps &(*keyOps)(); ///< 顺序容器为 TypeOps::of<void>()
+        std::size_t (*size)(const void *container);
+        void (*forEach)(const void *container, Visitor visit, void *context);
+        /// 第 index 个元素的地址，不检查越界（只有可随机访问的顺序容器提供）
+        const void *(*at)(const void *container, std::size_t index);
+        /// 在末尾追加元素拷贝（vector、deque、list 提供）
+        void (*append)(void *container, const void *element);
+        /// 按键查找映射值，不存在时返回 nullptr（关联容器提供）
+        const void *(*find)(const void *container, const void *key);
+        /// 按键插入或覆盖映射值（关联容器提供）
+        void (*insert)(void *container, const void *key, const void *element);
+        /// 清空（std::array 为 nullptr）
+        void (*clear)(void *container);
+    };
+
+    /**
+     * @brief 常用值类型的分类，用于在枚举字段时按类型做 switch 分派而不经过 Any
+     */
+    enum class ValueKind : unsigned char
+    {
+        Other, ///< 不在下列类型中（类、容器等）
+        Bool,
+        Char,
+        SignedChar,
+        UnsignedChar,
+        Short,
+        UnsignedShort,
+        Int,
+        UnsignedInt,
+        Long,
+        UnsignedLong,
+        LongLong,
+        UnsignedLongLong,
+        Float,
+        Double,
+        LongDouble,
+        String
+    };
+
+    /**
+     * @brief 类型擦除的值操作表
+     *
+     * 描述一个具体类型的大小、对齐以及构造/析构/赋值操作，
+     * 让调用计划等组件可以在原始内存中存放类型化的值而不经过 Any。
+     * 每个类型只有一个静态实例，可以直接比较指针。
+     */
+    struct TypeOps
+    {
+        const std::type_info *type;
+        std::size_t size;
+        std::size_t align;
+        void (*construct)(void *storage);          ///< 默认构造；类型不可默认构造时为 nullptr
+        void (*destroy)(void *object);             ///< 析构；void 类型为 nullptr
+        void (*assign)(void *dst, const void *src); ///< 拷贝赋值；类型不可赋值时为 nullptr
+        Any (*box)(const void *object);             ///< 拷贝到 Any；类型不可拷贝构造时为 nullptr
+        const ContainerOps *container;              ///< 容器的元素访问；其他类型为 nullptr
+        ValueKind kind;                             ///< 常用值类型分类
+        bool trivial;                               ///< 可平凡拷贝：可以用 memcpy 代替 assign
+        bool bitwise;                               ///< 值相等当且仅当字节相等（整数、枚举、指针）
+        bool (*equals)(const void *a, const void *b);  ///< operator==；不支持时为 nullptr
+        int (*compare)(const void *a, const void *b);  ///< 按 operator< 三路比较；不支持时为 nullptr
+        std::uint64_t (*hash)(const void *object);      ///< 不支持时为 nullptr（字符串按字节哈希，其余用 std::hash）
+        /// 枚举类型注册的名字表（未注册时返回 nullptr）；非枚举类型为 nullptr
+        const EnumInfo *(*enumInfo)();
+
+        template <typename T>
+        static const TypeOps &of();
+    };
+
+    /**
+     * @brief 编译期的值类型分类
+     */
+    template <typename T>
+    struct ValueKindOf
+    {
+        static const ValueKind value = ValueKind::Other;
+    };
+
+#define EVENTLY_VALUE_KIND(Type, Kind)                    \
+    template <>                                           \
+    struct ValueKindOf<Type>                              \
+    {                                                     \
+        static const ValueKind value = ValueKind::Kind;   \
+    };
+
+    EVENTLY_VALUE_KIND(bool, Bool)
+    EVENTLY_VALUE_KIND(char, Char)
+    EVENTLY_VALUE_KIND(signed char, SignedChar)
+    EVENTLY_VALUE_KIND(unsigned char, UnsignedChar)
+    EVENTLY_VALUE_KIND(short, Short)
+    EVENTLY_VALUE_KIND(unsigned short, UnsignedShort)
+    EVENTLY_VALUE_KIND(int, Int)
+    EVENTLY_VALUE_KIND(unsigned int, UnsignedInt)
+    EVENTLY_VALUE_KIND(long, Long)
+    EVENTLY_VALUE_KIND(unsigned long, UnsignedLong)
+    EVENTLY_VALUE_KIND(long long, LongLong)
+    EVENTLY_VALUE_KIND(unsigned long long, UnsignedLongLong)
+    EVENTLY_VALUE_KIND(float, Float)
+    EVENTLY_VALUE_KIND(double, Double)
+    EVENTLY_VALUE_KIND(long double, LongDouble)
+    EVENTLY_VALUE_KIND(std::string, String)
+
+#undef EVENTLY_VALUE_KIND
+
+    /**
+     * @brief 快速的非加密字节哈希（每次处理 8 字节，最后做一次雪崩混合）
+     */
+    inline std::uint64_t hashBytes(const void *data, std::size_t size, std::uint64_t seed = 0)
+    {
+        const std::uint64_t multiplier = 0x9e3779b97f4a7c15ULL;
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        std::uint64_t hash = seed ^ (size * multiplier);
+        for (; size >= 8; bytes += 8, size -= 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, 8);
+            hash = ((hash << 5 | hash >> 59) ^ word) * multiplier;
+        }
+        if (size != 0)
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes, size);
+            hash = ((hash << 5 | hash >> 59) ^ word) * multiplier;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /// 组合两个哈希值
+    inline std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    /**
+     * @brief 按 TypeOps 比较和哈希类型擦除的值，用于以值的地址为键的容器
+     *
+     * 没有哈希或 operator== 的按字节可比类型（如 C++11 中的枚举）按字节处理。
+     */
+    struct ValueHash
+    {
+        const TypeOps *ops;
+
+        std::size_t operator()(const void *value) const
+        {
+            return static_cast<std::size_t>(ops->hash != nullptr ? ops->hash(value) : hashBytes(value, ops->size));
+        }
+    };
+
+    struct ValueEqual
+    {
+        const TypeOps *ops;
+
+        bool operator()(const void *a, const void *b) const
+        {
+            return ops->equals != nullptr ? ops->equals(a, b) : std::memcmp(a, b, ops->size) == 0;
+        }
+    };
+
+    struct ValueLess
+    {
+        const TypeOps *ops;
+
+        bool operator()(const void *a, const void *b) const { return ops->compare(a, b) < 0; }
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        void constructValue(void *storage)
+        {
+            new (storage) T();
+        }
+
+        template <typename T>
+        void destroyValue(void *object)
+        {
+            static_cast<T *>(object)->~T();
+        }
+
+        template <typename T>
+        void assignValue(void *dst, const void *src)
+        {
+            *static_cast<T *>(dst) = *static_cast<const T *>(src);
+        }
+
+        // 按类型能力选择操作函数，不支持的操作为 nullptr
+        template <typename T, bool = std::is_default_constructible<T>::value>
+        struct ConstructOp
+        {
+            static void (*get())(void *) { return &constructValue<T>; }
+        };
+
+        template <typename T>
+        struct ConstructOp<T, false>
+        {
+            static void (*get())(void *) { return nullptr; }
+        };
+
+        template <typename T, bool = std::is_copy_assignable<T>::value>
+        struct AssignOp
+        {
+            static void (*get())(void *, const void *) { return &assignValue<T>; }
+        };
+
+        template <typename T>
+        struct AssignOp<T, false>
+        {
+            static void (*get())(void *, const void *) { return nullptr; }
+        };
+
+        template <typename T>
+        Any boxValue(const void *object)
+        {
+            return Any(*static_cast<const T *>(object));
+        }
+
+        template <typename T, bool = std::is_copy_constructible<T>::value>
+        struct BoxOp
+        {
+            static Any (*get())(const void *) { return &boxValue<T>; }
+        };
+
+        template <typename T>
+        struct BoxOp<T, false>
+        {
+            static Any (*get())(const void *) { return nullptr; }
+        };
+
+        // 比较与哈希能力的检测：标准容器和 pair 的运算符总是声明的，按元素类型判断
+        template <typename T>
+        struct ElementTypes
+        {
+            template <typename U>
+            static typename U::value_type test(int);
+            template <typename U>
+            static void test(...);
+            typedef decltype(test<T>(0)) Element;
+        };
+
+        template <typename T, typename Element = typename ElementTypes<T>::Element>
+        struct HasEqual
+        {
+            static const bool value = HasEqual<Element>::value && HasEqual<T, void>::value;
+        };
+
+        template <typename T>
+        struct HasEqual<T, void>
+        {
+            template <typename U>
+            static auto test(int) -> decltype(std::declval<const U &>() == std::declval<const U &>(), std::true_type());
+            template <typename U>
+            static std::false_type test(...);
+            static const bool value = decltype(test<T>(0))::value;
+        };
+
+        template <typename A, typename B>
+        struct HasEqual<std::pair<A, B>, void>
+        {
+            static const bool value = HasEqual<typename std::remove_const<A>::type>::value && HasEqual<B>::value;
+        };
+
+        template <typename T, typename Element = typename ElementTypes<T>::Element>
+        struct HasLess
+        {
+            static const bool value = HasLess<Element>::value && HasLess<T, void>::value;
+        };
+
+        template <typename T>
+        struct HasLess<T, void>
+        {
+            template <typename U>
+            static auto test(int) -> decltype(std::declval<const U &>() < std::declval<const U &>(), std::true_type());
+            template <typename U>
+            static std::false_type test(...);
+            static const bool value = decltype(test<T>(0))::value;
+        };
+
+        template <typename A, typename B>
+        struct HasLess<std::pair<A, B>, void>
+        {
+            static const bool value = HasLess<typename std::remove_const<A>::type>::value && HasLess<B>::value;
+        };
+
+        template <typename T>
+        struct HasStdHash
+        {
+            template <typename U>
+            static auto test(int) -> decltype(std::hash<U>()(std::declval<const U &>()), std::true_type());
+            template <typename U>
+            static std::false_type test(...);
+            static const bool value = decltype(test<T>(0))::value;
+        };
+
+        template <typename T>
+        bool equalValues(const void *a, const void *b)
+        {
+            return *static_cast<const T *>(a) == *static_cast<const T *>(b);
+        }
+
+        template <typename T>
+        int compareValues(const void *a, const void *b)
+        {
+            const T &left = *static_cast<const T *>(a);
+            const T &right = *static_cast<const T *>(b);
+            return left < right ? -1 : (right < left ? 1 : 0);
+        }
+
+        template <typename T>
+        std::uint64_t hashValue(const void *object)
+        {
+            return std::hash<T>()(*static_cast<const T *>(object));
+        }
+
+        inline std::uint64_t hashString(const void *object)
+        {
+            const std::string &text = *static_cast<const std::string *>(object);
+            return hashBytes(text.data(), text.size());
+        }
+
+        template <typename T, bool = HasEqual<T>::value>
+        struct EqualOp
+        {
+            static bool (*get())(const void *, const void *) { return &equalValues<T>; }
+        };
+
+        template <typename T>
+        struct EqualOp<T, false>
+        {
+            static bool (*get())(const void *, const void *) { return nullptr; }
+        };
+
+        template <typename T, bool = HasLess<T>::value>
+        struct CompareOp
+        {
+            static int (*get())(const void *, const void *) { return &compareValues<T>; }
+        };
+
+        template <typename T>
+        struct CompareOp<T, false>
+        {
+            static int (*get())(const void *, const void *) { return nullptr; }
+        };
+
+        template <typename T, bool = HasStdHash<T>::value>
+        struct HashOp
+        {
+            static std::uint64_t (*get())(const void *) { return &hashValue<T>; }
+        };
+
+        template <typename T>
+        struct HashOp<T, false>
+        {
+            static std::uint64_t (*get())(const void *) { return nullptr; }
+        };
+
+        template <>
+        struct HashOp<std::string, true>
+        {
+            static std::uint64_t (*get())(const void *) { return &hashString; }
+        };
+
+        // 各容器操作的实现；按容器能力组合成 ContainerOps
+        template <typename Container>
+        struct ContainerFunctions
+        {
+            typedef typename Container::value_type Element;
+
+            static const TypeOps &elementOps();
+            static const TypeOps &noKeyOps();
+
+            static std::size_t size(const void *container)
+            {
+                return static_cast<const Container *>(container)->size();
+            }
+
+            static void forEach(const void *container, ContainerOps::Visitor visit, void *context)
+            {
+                for (const auto &element : *static_cast<const Container *>(container))
+                {
+                    visit(context, nullptr, &element);
+                }
+            }
+
+            static const void *at(const void *container, std::size_t index)
+            {
+                return &(*static_cast<const Container *>(container))[index];
+            }
+
+            static void append(void *container, const void *element)
+            {
+                static_cast<Container *>(container)->push_back(*static_cast<const Element *>(element));
+            }
+
+            static void clear(void *container)
+            {
+                static_cast<Container *>(container)->clear();
+            }
+        };
+
+        template <typename Map, bool Unordered = false>
+        struct MapFunctions
+        {
+            typedef typename Map::key_type Key;
+            typedef typename Map::mapped_type Mapped;
+
+            static const TypeOps &keyOps();
+            static const TypeOps &elementOps();
+
+            static std::size_t size(const void *container)
+            {
+                return static_cast<const Map *>(container)->size();
+            }
+
+            static void forEach(const void *container, ContainerOps::Visitor visit, void *context)
+            {
+                for (const auto &entry : *static_cast<const Map *>(container))
+                {
+                    visit(context, &entry.first, &entry.second);
+                }
+            }
+
+            static const void *find(const void *container, const void *key)
+            {
+                const Map &map = *static_cast<const Map *>(container);
+                auto it = map.find(*static_cast<const Key *>(key));
+                return it != map.end() ? &it->second : nullptr;
+            }
+
+            static void insert(void *container, const void *key, const void *element)
+            {
+                (*static_cast<Map *>(container))[*static_cast<const Key *>(key)] =
+                    *static_cast<const Mapped *>(element);
+            }
+
+            static void clear(void *container)
+            {
+                static_cast<Map *>(container)->clear();
+            }
+
+            static const ContainerOps *get()
+            {
+                static const ContainerOps ops = {true, Unordered, &elementOps, &keyOps, &size, &forEach,
+                                                 nullptr, nullptr, &find, &insert, &clear};
+                return &ops;
+            }
+        };
+
+        // 可随机访问且可追加：vector、deque
+        template <typename Container>
+        struct DynamicArrayOps : ContainerFunctions<Container>
+        {
+            typedef ContainerFunctions<Container> F;
+
+            static const ContainerOps *get()
+            {
+                static const ContainerOps ops = {false, false, &F::elementOps, &F::noKeyOps, &F::size, &F::forEach,
+                                                 &F::at, &F::append, nullptr, nullptr, &F::clear};
+                return &ops;
+            }
+        };
+
+        template <typename T>
+        struct ContainerOp
+        {
+            static const ContainerOps *get() { return nullptr; }
+        };
+
+        template <typename E, typename A>
+        struct ContainerOp<std::vector<E, A>> : DynamicArrayOps<std::vector<E, A>>
+        {
+        };
+
+        // vector<bool> 的元素不是真实对象，不提供元素访问
+        template <typename A>
+        struct ContainerOp<std::vector<bool, A>>
+        {
+            static const ContainerOps *get() { return nullptr; }
+        };
+
+        template <typename E, typename A>
+        struct ContainerOp<std::deque<E, A>> : DynamicArrayOps<std::deque<E, A>>
+        {
+        };
+
+        // 定长数组：可随机访问，不能追加或清空
+        template <typename E, std::size_t N>
+        struct ContainerOp<std::array<E, N>>
+        {
+            typedef ContainerFunctions<std::array<E, N>> F;
+
+            static const ContainerOps *get()
+            {
+                static const ContainerOps ops = {false, false, &F::elementOps, &F::noKeyOps, &F::size, &F::forEach,
+                                                 &F::at, nullptr, nullptr, nullptr, nullptr};
+                return &ops;
+            }
+        };
+
+        // 链表：只能顺序遍历和追加
+        template <typename E, typename A>
+        struct ContainerOp<std::list<E, A>>
+        {
+            typedef ContainerFunctions<std::list<E, A>> F;
+
+            static const ContainerOps *get()
+            {
+                static const ContainerOps ops = {false, false, &F::elementOps, &F::noKeyOps, &F::size, &F::forEach,
+                                                 nullptr, &F::append, nullptr, nullptr, &F::clear};
+                return &ops;
+            }
+        };
+
+        template <typename K, typename V, typename C, typename A>
+        struct ContainerOp<std::map<K, V, C, A>> : MapFunctions<std::map<K, V, C, A>>
+        {
+        };
+
+        template <typename K, typename V, typename H, typename E, typename A>
+        struct ContainerOp<std::unordered_map<K, V, H, E, A>> : MapFunctions<std::unordered_map<K, V, H, E, A>, true>
+        {
+        };
+
+        template <typename T, bool = std::is_enum<T>::value>
+        struct EnumInfoOp
+        {
+            static const EnumInfo *(*get())() { return &EnumSlot<T>::get; }
+        };
+
+        template <typename T>
+        struct EnumInfoOp<T, false>
+        {
+            static const EnumInfo *(*get())() { return nullptr; }
+        };
+
+        template <typename T>
+        struct TypeOpsFor
+        {
+            static const TypeOps &get()
+            {
+                static const TypeOps ops = {&typeid(T), sizeof(T), alignof(T),
+                                            ConstructOp<T>::get(), &destroyValue<T>,
+                                            AssignOp<T>::get(), BoxOp<T>::get(),
+                                            ContainerOp<T>::get(), ValueKindOf<T>::value,
+                                            std::is_trivially_copyable<T>::value,
+                                            std::is_integral<T>::value || std::is_enum<T>::value ||
+                                                std::is_pointer<T>::value,
+                                            EqualOp<T>::get(), CompareOp<T>::get(), HashOp<T>::get(),
+                                            EnumInfoOp<T>::get()};
+                return ops;
+            }
+        };
+
+        template <>
+        struct TypeOpsFor<void>
+        {
+            static const TypeOps &get()
+            {
+                static const TypeOps ops = {&typeid(void), 0, 1, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                            ValueKind::Other, false, false, nullptr, nullptr, nullptr, nullptr};
+                return ops;
+            }
+        };
+    }
+
+    template <typename T>
+    const TypeOps &TypeOps::of()
+    {
+        return detail::TypeOpsFor<typename std::remove_cv<T>::type>::get();
+    }
+
+    template <typename Container>
+    const TypeOps &detail::ContainerFunctions<Container>::elementOps()
+    {
+        return TypeOps::of<Element>();
+    }
+
+    template <typename Container>
+    const TypeOps &detail::ContainerFunctions<Container>::noKeyOps()
+    {
+        return TypeOps::of<void>();
+    }
+
+    template <typename Map, bool Unordered>
+    const TypeOps &detail::MapFunctions<Map, Unordered>::keyOps()
+    {
+        return TypeOps::of<Key>();
+    }
+
+    template <typename Map, bool Unordered>
+    const TypeOps &detail::MapFunctions<Map, Unordered>::elementOps()
+    {
+        return TypeOps::of<Mapped>();
+    }
+
+} // namespace Evently
+
+#endif // TYPE_OPS_H
@@ -0,0 +1,1608 @@
+#include "AnyAllocator.h"
+#include "BenchmarkSupport.h"
+#include "CallPlan.h"
+#include "ComparePlan.h"
+#include "CopyPlan.h"
+#include "CsvTable.h"
+#include "DataBinding.h"
+#include "ObjectStore.h"
+#include "Query.h"
+#include "Reflection.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#if EVENTLY_HAS_CXX17
+#include <any>
+#endif
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace Evently;
+
+/// 全局堆分配计数（用于验证零分配路径）与当前仍在使用的堆字节数（用于统计内存占用）
+static std::atomic<std::size_t> allocationCount(0);
+static std::atomic<std::ptrdiff_t> liveHeapBytes(0);
+
+/// 每块内存前记录请求的大小，释放时扣减
+static const std::size_t kAllocationHeader = alignof(std::max_align_t);
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    char *memory = static_cast<char *>(std::malloc(size + kAllocationHeader));
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(memory) = size;
+    liveHeapBytes.fetch_add(static_cast<std::ptrdiff_t>(size), std::memory_order_relaxed);
+    return memory + kAllocationHeader;
+}
+
+void operator delete(void *memory) noexcept
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+    // 经整数还原块地址：编译器内联后不会把它当作 operator new 的返回值去 free
+    void *block = reinterpret_cast<void *>(reinterpret_cast<std::uintptr_t>(memory) - kAllocationHeader);
+    liveHeapBytes.fetch_sub(static_cast<std::ptrdiff_t>(*static_cast<std::size_t *>(block)),
+                            std::memory_order_relaxed);
+    std::free(block);
+}
+
+/// C++14 起容器按大小释放，转给上面的实现
+void operator delete(void *memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+/**
+ * @brief 基准测试用的轻量类（避免千万级实例占用过多内存）
+ */
+class Citizen
+{
+public:
+    int calculateBirthYear(int currentYear) { return currentYear - age_; }
+
+public:
+    int age_ = 0;
+    int birthYear_ = 0;
+};
+
+/**
+ * @brief 路径基准用的嵌套类（中间对象带一个较大的字段，放大逐层拷贝的代价）
+ */
+struct Street
+{
+    std::string name;
+    std::vector<int> history = std::vector<int>(256);
+};
+
+struct Residence
+{
+    Street street;
+    std::vector<int> rooms = std::vector<int>(256);
+};
+
+struct Household
+{
+    Residence residence;
+};
+
+/**
+ * @brief 拷贝基准用的类：两段相邻的平凡字段被字符串隔开
+ */
+struct Profile
+{
+    std::string name = "profile";
+    int age = 0;
+    int level = 0;
+    double score = 0;
+    double balance = 0;
+    long long id = 0;
+    std::string city = "city";
+    bool active = false;
+    char grade = 'A';
+    short rank = 0;
+    int visits = 0;
+};
+
+/**
+ * @brief 查询基准用的类：测试程序中 Person 的常用字段
+ */
+struct PersonRecord
+{
+    std::string name;
+    int age = 0;
+    float money = 0;
+    double height = 0;
+    long long id = 0;
+};
+
+/**
+ * @brief 容器视图基准用的数据集
+ */
+struct Dataset
+{
+    std::vector<double> samples;
+};
+
+/**
+ * @brief 注册基准测试用到的 Citizen 成员
+ */
+static void registerCitizen()
+{
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerField("Citizen", "age", &Citizen::age_);
+    registry.registerField("Citizen", "birthYear", &Citizen::birthYear_);
+    registry.registerMethod<Citizen, int, int>("Citizen", "calculateBirthYear", &Citizen::calculateBirthYear);
+}
+
+/**
+ * @brief 命令行参数：Benchmark [测试名|all] [规模]
+ */
+struct BenchmarkOptions
+{
+    std::string name;  ///< 要运行的测试名，all 表示全部
+    std::size_t scale; ///< 规模（0 表示使用各测试的默认值）
+
+    bool selected(const char *benchmark) const { return name == "all" || name == benchmark; }
+
+    std::size_t scaleOr(std::size_t fallback) const { return scale != 0 ? scale : fallback; }
+};
+
+/**
+ * @brief 批量调用与逐个 invokeMethod 的对比，以及线程数扩展性
+ */
+void benchmarkBatchInvocation(std::size_t count)
+{
+    std::cout << "\n=== 批量调用基准（" << count << " 个实例）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registerCitizen();
+
+    std::vector<Citizen> citizens(count);
+    std::vector<void *> instances(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        citizens[i].age_ = static_cast<int>(i % 90);
+        instances[i] = &citizens[i];
+    }
+    std::vector<int> results(count);
+
+    // 逐个调用只取前 1/10 的实例，按比例折算
+    std::size_t sampled = count / 10 == 0 ? count : count / 10;
+    Stopwatch perCall;
+    long long checksum = 0;
+    for (std::size_t i = 0; i < sampled; ++i)
+    {
+        std::vector<Any> args = {Any(2024)};
+        checksum += any_cast<int>(registry.invokeMethod("Citizen", "calculateBirthYear", instances[i], args));
+    }
+    double perCallNs = perCall.elapsedMs() * 1e6 / static_cast<double>(sampled);
+    std::cout << "逐个 invokeMethod: " << std::fixed << std::setprecision(1) << perCallNs
+              << " ns/次（校验和 " << checksum << "）" << std::endl;
+
+    ResolvedMethod method = registry.resolveMethod("Citizen", "calculateBirthYear", {&typeid(int)});
+    double singleThreadMs = 0.0;
+    for (std::size_t threads : threadCounts())
+    {
+        registry.setAsyncWorkerCount(threads);
+        registry.asyncPool(); // 预先创建线程，不计入耗时
+
+        Stopwatch batch;
+        registry.invokeBatch(method, instances.data(), count, {BatchColumn::shared(2024)}, results.data());
+        double ms = batch.elapsedMs();
+        if (threads == 1)
+        {
+            singleThreadMs = ms;
+        }
+        double speedup = singleThreadMs / ms;
+        std::cout << "invokeBatch " << threads << " 线程: " << std::setprecision(1) << ms << " ms, "
+                  << std::setprecision(2) << ms * 1e6 / static_cast<double>(count) << " ns/次, 加速比 "
+                  << speedup << "，扩展效率 " << std::setprecision(0) << speedup / threads * 100.0 << "%"
+                  << std::endl;
+    }
+}
+
+/**
+ * @brief 调用计划与按名字逐步调用（getValues / invokeMethod / set）的对比
+ */
+void benchmarkCallPlan(std::size_t iterations)
+{
+    std::cout << "\n=== 调用计划基准（" << iterations << " 次）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registerCitizen();
+    Citizen citizen;
+
+    // age = age + 0 的读写往返；birthYear = calculateBirthYear(year)
+    Stopwatch byName;
+    long long checksum = 0;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        citizen.age_ = static_cast<int>(i % 90);
+        Any age = registry.getValues("Citizen", "age", &citizen);
+        registry.getSetter("Citizen", "age")->set(&citizen, age);
+        std::vector<Any> args = {Any(2024)};
+        Any birthYear = registry.invokeMethod("Citizen", "calculateBirthYear", &citizen, args);
+        registry.getSetter("Citizen", "birthYear")->set(&citizen, birthYear);
+        checksum += citizen.birthYear_;
+    }
+    double byNameNs = byName.elapsedMs() * 1e6 / static_cast<double>(iterations);
+
+    CallPlan plan(registry, "Citizen");
+    std::size_t age = plan.readField("age");
+    plan.writeField("age", age);
+    std::size_t year = plan.input<int>();
+    plan.writeField("birthYear", plan.callMethod("calculateBirthYear", {year}));
+    CallPlanFrame frame = plan.createFrame();
+    frame.slot<int>(year) = 2024;
+
+    Stopwatch planned;
+    long long planChecksum = 0;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        citizen.age_ = static_cast<int>(i % 90);
+        plan.execute(&citizen, frame);
+        planChecksum += citizen.birthYear_;
+    }
+    double planNs = planned.elapsedMs() * 1e6 / static_cast<double>(iterations);
+
+    std::cout << "按名字逐步调用: " << std::fixed << std::setprecision(1) << byNameNs << " ns/次" << std::endl;
+    std::cout << "调用计划: " << planNs << " ns/次, 加速比 " << std::setprecision(2) << byNameNs / planNs
+              << (checksum == planChecksum ? "（结果一致）" : "（✗ 结果不一致）") << std::endl;
+}
+
+/**
+ * @brief 嵌套路径访问：逐层 getValues 拷贝、缓存的按名访问与预先解析的路径对比
+ */
+void benchmarkPropertyPath(std::size_t iterations)
+{
+    std::cout << "\n=== 嵌套路径基准（" << iterations << " 次）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerClassName<Street>("Street");
+    registry.registerField<Street>("Street", "name", &Street::name);
+    registry.registerClassName<Residence>("Residence");
+    registry.registerField<Residence>("Residence", "street", &Residence::street);
+    registry.registerClassName<Household>("Household");
+    registry.registerField<Household>("Household", "residence", &Household::residence);
+
+    Household household;
+    household.residence.street.name = "长安街";
+
+    Stopwatch hops;
+    std::size_t checksum = 0;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        Any residence = registry.getValues("Household", "residence", &household);
+        Any street = registry.getValues("Residence", "street", any_cast<Residence>(&residence));
+        checksum += any_cast<std::string>(registry.getValues("Street", "name", any_cast<Street>(&street))).size();
+    }
+    double hopsNs = hops.elapsedMs() * 1e6 / static_cast<double>(iterations);
+
+    Stopwatch cached;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        checksum += any_cast<std::string>(registry.getPathValue("Household", "residence.street.name", &household)).size();
+    }
+    double cachedNs = cached.elapsedMs() * 1e6 / static_cast<double>(iterations);
+
+    PropertyPath path = registry.resolvePath("Household", "residence.street.name");
+    Stopwatch resolved;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        checksum += path.value<std::string>(&household).size();
+    }
+    double resolvedNs = resolved.elapsedMs() * 1e6 / static_cast<double>(iterations);
+
+    std::cout << std::fixed << std::setprecision(1) << "逐层 getValues: " << hopsNs << " ns/次" << std::endl;
+    std::cout << "getPathValue（缓存）: " << cachedNs << " ns/次" << std::endl;
+    std::cout << "预先解析的 PropertyPath: " << resolvedNs << " ns/次（校验和 " << checksum << "）" << std::endl;
+}
+
+/**
+ * @brief 读取大容器字段：getValues 整体拷贝与容器视图原地遍历的对比
+ */
+void benchmarkContainerView(std::size_t elements)
+{
+    std::cout << "\n=== 容器视图基准（" << elements << " 个元素）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerField<Dataset>("Dataset", "samples", &Dataset::samples);
+    Dataset dataset;
+    dataset.samples.assign(elements, 1.0);
+
+    const std::size_t rounds = 50;
+    Stopwatch copied;
+    double copiedSum = 0.0;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        Any samples = registry.getValues("Dataset", "samples", &dataset);
+        for (double value : any_cast<std::vector<double>>(samples))
+        {
+            copiedSum += value;
+        }
+    }
+    double copiedMs = copied.elapsedMs() / rounds;
+
+    Stopwatch viewed;
+    double viewedSum = 0.0;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        ContainerView samples = registry.containerField("Dataset", "samples", &dataset);
+        samples.forEach<double>([&viewedSum](double value)
+                                { viewedSum += value; });
+    }
+    double viewedMs = viewed.elapsedMs() / rounds;
+
+    std::cout << std::fixed << std::setprecision(2) << "getValues 拷贝后遍历: " << copiedMs << " ms/次" << std::endl;
+    std::cout << "ContainerView 原地遍历: " << viewedMs << " ms/次"
+              << (copiedSum == viewedSum ? "（结果一致）" : "（✗ 结果不一致）") << std::endl;
+}
+
+/**
+ * @brief 枚举访问者：累加数值字段，字符串只累加长度
+ */
+struct ChecksumVisitor
+{
+    double sum = 0.0;
+
+    void operator()(const std::string &, const std::string &value) { sum += value.size(); }
+    void operator()(const std::string &, ValueRef) {}
+
+    template <typename T>
+    void operator()(const std::string &, const T &value) { sum += static_cast<double>(value); }
+};
+
+/**
+ * @brief 字段枚举：getAllValues 与 forEachField 的耗时和堆分配次数对比
+ */
+void benchmarkEnumeration(std::size_t iterations)
+{
+    std::cout << "\n=== 字段枚举基准（" << iterations << " 次）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registerCitizen();
+    Citizen citizen;
+    citizen.age_ = 30;
+
+    std::size_t allocationsBefore = allocationCount.load();
+    Stopwatch copied;
+    double copiedSum = 0.0;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        auto values = registry.getAllValues("Citizen", &citizen);
+        for (const auto &entry : values)
+        {
+            copiedSum += any_cast<int>(entry.second);
+        }
+    }
+    double copiedNs = copied.elapsedMs() * 1e6 / static_cast<double>(iterations);
+    double copiedAllocations = static_cast<double>(allocationCount.load() - allocationsBefore) / iterations;
+
+    ChecksumVisitor visitor;
+    allocationsBefore = allocationCount.load();
+    Stopwatch visited;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        registry.forEachField("Citizen", &citizen, visitor);
+    }
+    double visitedNs = visited.elapsedMs() * 1e6 / static_cast<double>(iterations);
+    double visitedAllocations = static_cast<double>(allocationCount.load() - allocationsBefore) / iterations;
+
+    std::cout << std::fixed << std::setprecision(1) << "getAllValues: " << copiedNs << " ns/次, "
+              << copiedAllocations << " 次分配/次" << std::endl;
+    std::cout << "forEachField: " << visitedNs << " ns/次, " << visitedAllocations << " 次分配/次"
+              << (copiedSum == visitor.sum ? "（结果一致）" : "（✗ 结果不一致）") << std::endl;
+}
+
+/**
+ * @brief 单次按名查找：std::string 键、指针 + 长度键与编译期哈希键的对比
+ */
+void benchmarkNameLookup(std::size_t iterations)
+{
+    std::cout << "\n=== 按名查找基准（" << iterations << " 次）===" << std::endl;
+
+    using namespace Evently::literals;
+    auto &registry = ReflectionRegistry::getInstance();
+    registerCitizen();
+
+    const std::string className = "Citizen";
+    const std::string fieldName = "birthYear";
+    const char *token = "birthYear = 1990";
+
+    std::size_t found = 0;
+    std::size_t allocationsBefore = allocationCount.load();
+    Stopwatch byString;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        found += registry.findField(className, fieldName) != nullptr;
+    }
+    double stringNs = byString.elapsedMs() * 1e6 / static_cast<double>(iterations);
+    double stringAllocations = static_cast<double>(allocationCount.load() - allocationsBefore) / iterations;
+
+    allocationsBefore = allocationCount.load();
+    Stopwatch byToken;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        found += registry.findField(NameRef(className), NameRef(token, 9)) != nullptr;
+    }
+    double tokenNs = byToken.elapsedMs() * 1e6 / static_cast<double>(iterations);
+    double tokenAllocations = static_cast<double>(allocationCount.load() - allocationsBefore) / iterations;
+
+    allocationsBefore = allocationCount.load();
+    Stopwatch byLiteral;
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        found += registry.findField(EVENTLY_NAME("Citizen"), EVENTLY_NAME("birthYear")) != nullptr;
+    }
+    double literalNs = byLiteral.elapsedMs() * 1e6 / static_cast<double>(iterations);
+    double literalAllocations = static_cast<double>(allocationCount.load() - allocationsBefore) / iterations;
+
+    std::cout << std::fixed << std::setprecision(1) << "std::string 键: " << stringNs << " ns/次, "
+              << stringAllocations << " 次分配/次" << std::endl;
+    std::cout << "指针 + 长度键: " << tokenNs << " ns/次, " << tokenAllocations << " 次分配/次" << std::endl;
+    std::cout << "编译期哈希键: " << literalNs << " ns/次, " << literalAllocations << " 次分配/次（命中 "
+              << found << "）" << std::endl;
+}
+
+/// Any 分配器基准的基线：直接使用 malloc / free（绕过本程序带计数的全局 operator new）
+static void *mallocAllocate(std::size_t size)
+{
+    void *memory = std::malloc(size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+static void mallocDeallocate(void *memory, std::size_t)
+{
+    std::free(memory);
+}
+
+/**
+ * @brief Any 分配器基准的负载（48 字节，常见小对象大小）
+ */
+struct AllocPayload
+{
+    double values[6];
+};
+
+/**
+ * @brief 多线程下 Any 的分配吞吐与尾延迟：池化分配器与 malloc 的对比
+ *
+ * 每个线程循环替换 64 个槽位中的 Any（一次释放 + 一次分配），逐次计时。
+ */
+void benchmarkAnyAllocator(std::size_t iterations)
+{
+    const std::size_t threadCount = 16;
+    const std::size_t slotCount = 64;
+    std::cout << "\n=== Any 分配器基准（" << threadCount << " 线程，每线程 " << iterations << " 次）===" << std::endl;
+
+    static const AnyAllocator mallocAllocator = {&mallocAllocate, &mallocDeallocate};
+    const AnyAllocator *allocators[] = {&mallocAllocator, &AnyAllocator::pooled()};
+    const char *labels[] = {"malloc", "池化"};
+
+    for (int round = 0; round < 2; ++round)
+    {
+        setAnyAllocator(*allocators[round]);
+        std::vector<std::vector<std::uint32_t>> latencies(threadCount, std::vector<std::uint32_t>(iterations));
+        std::atomic<std::size_t> ready(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> threads;
+
+        for (std::size_t t = 0; t < threadCount; ++t)
+        {
+            threads.push_back(std::thread([&, t]() {
+                std::vector<Any> slots(slotCount);
+                AllocPayload payload = {{1, 2, 3, 4, 5, static_cast<double>(t)}};
+                std::vector<std::uint32_t> &samples = latencies[t];
+                ++ready;
+                while (!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                for (std::size_t i = 0; i < iterations; ++i)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    slots[i % slotCount] = Any(payload);
+                    auto end = std::chrono::steady_clock::now();
+                    samples[i] = static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                }
+            }));
+        }
+        while (ready.load() != threadCount)
+        {
+            std::this_thread::yield();
+        }
+        Stopwatch wall;
+        go.store(true, std::memory_order_release);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        double elapsedMs = wall.elapsedMs();
+
+        std::vector<std::uint32_t> merged;
+        merged.reserve(threadCount * iterations);
+        for (const auto &samples : latencies)
+        {
+            merged.insert(merged.end(), samples.begin(), samples.end());
+        }
+        std::sort(merged.begin(), merged.end());
+        auto percentile = [&merged](double p) {
+            return merged[std::min(merged.size() - 1, static_cast<std::size_t>(p * merged.size()))];
+        };
+
+        double opsPerSecond = static_cast<double>(threadCount * iterations) / (elapsedMs / 1000.0);
+        std::cout << std::fixed << std::setprecision(1) << labels[round] << ": " << opsPerSecond / 1e6
+                  << " M 次/秒, p50 " << percentile(0.50) << " ns, p99 " << percentile(0.99) << " ns, p99.9 "
+                  << percentile(0.999) << " ns" << std::endl;
+    }
+    setAnyAllocator(AnyAllocator::pooled());
+}
+
+/**
+ * @brief 大负载 Any 经过多层传递的开销：深拷贝与共享存储的对比
+ *
+ * 模拟参数在四层反射调用间按值传递（每层拷贝一次），每轮只读取一次内容。
+ */
+void benchmarkSharedAny(std::size_t iterations)
+{
+    std::cout << "\n=== 共享 Any 基准（" << iterations << " 次，每次 4 层拷贝）===" << std::endl;
+
+    const std::size_t sizes[] = {1024, 64 * 1024};
+    for (std::size_t size : sizes)
+    {
+        const Any sources[] = {Any(std::string(size, 'x')), Any::shared(std::string(size, 'x'))};
+        const char *labels[] = {"深拷贝", "共享"};
+        double nanoseconds[2];
+        std::size_t checksum = 0;
+
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            Stopwatch watch;
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                Any layer1 = sources[mode];
+                Any layer2 = layer1;
+                Any layer3 = layer2;
+                Any layer4 = layer3;
+                checksum += any_cast<std::string>(&static_cast<const Any &>(layer4))->size();
+            }
+            nanoseconds[mode] = watch.elapsedMs() * 1e6 / static_cast<double>(iterations);
+        }
+
+        std::cout << std::fixed << std::setprecision(1) << size / 1024 << " KB: " << labels[0] << " "
+                  << nanoseconds[0] << " ns/次, " << labels[1] << " " << nanoseconds[1] << " ns/次（"
+                  << nanoseconds[0] / nanoseconds[1] << "x，校验 " << checksum << "）" << std::endl;
+    }
+}
+
+/**
+ * @brief 注册 Profile 的全部字段（多个基准共用，只注册一次）
+ */
+void registerProfile(ReflectionRegistry &registry)
+{
+    if (registry.getSetter("Profile", "visits") != nullptr)
+    {
+        return;
+    }
+    registry.registerClass<Profile>("Profile");
+    registry.registerField("Profile", "name", &Profile::name);
+    registry.registerField("Profile", "age", &Profile::age);
+    registry.registerField("Profile", "level", &Profile::level);
+    registry.registerField("Profile", "score", &Profile::score);
+    registry.registerField("Profile", "balance", &Profile::balance);
+    registry.registerField("Profile", "id", &Profile::id);
+    registry.registerField("Profile", "city", &Profile::city);
+    registry.registerField("Profile", "active", &Profile::active);
+    registry.registerField("Profile", "grade", &Profile::grade);
+    registry.registerField("Profile", "rank", &Profile::rank);
+    registry.registerField("Profile", "visits", &Profile::visits);
+}
+
+/**
+ * @brief 对象拷贝：逐字段经 Any 读写、clone、缓存的拷贝计划与原生拷贝赋值的对比
+ */
+void benchmarkObjectCopy(std::size_t count)
+{
+    std::cout << "\n=== 对象拷贝基准（" << count << " 个对象，11 个字段）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registerProfile(registry);
+    const char *const names[] = {"name", "age", "level", "score", "balance", "id",
+                                 "city", "active", "grade", "rank", "visits"};
+
+    std::vector<Profile> sources(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        sources[i].age = static_cast<int>(i % 90);
+        sources[i].id = static_cast<long long>(i);
+        sources[i].visits = static_cast<int>(i);
+    }
+    std::vector<const PropertySetterBase *> setters;
+    for (const char *name : names)
+    {
+        setters.push_back(registry.getSetter("Profile", name));
+    }
+
+    long long checksum = 0;
+    {
+        // 逐字段反射拷贝：每个字段一次 get（装箱到 Any）和一次 set
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto copy = registry.createInstance("Profile");
+            for (const PropertySetterBase *setter : setters)
+            {
+                setter->set(copy.get(), setter->get(&sources[i]));
+            }
+            checksum += static_cast<Profile *>(copy.get())->id;
+        }
+        std::cout << std::fixed << std::setprecision(1) << "逐字段 Any 拷贝: " << watch.elapsedMs() * 1e6 / count
+                  << " ns/对象" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto copy = registry.clone("Profile", &sources[i]);
+            checksum += static_cast<Profile *>(copy.get())->id;
+        }
+        std::cout << "clone:           " << watch.elapsedMs() * 1e6 / count << " ns/对象" << std::endl;
+    }
+
+    std::vector<Profile> targets(count);
+    std::shared_ptr<const CopyPlan> plan = registry.copyPlan("Profile", &sources[0]);
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            plan->copy(&targets[i], &sources[i]);
+        }
+        checksum += targets[count - 1].id;
+        std::cout << "拷贝计划 copy:   " << watch.elapsedMs() * 1e6 / count << " ns/对象（" << plan->fieldCount()
+                  << " 个字段，" << plan->stepCount() << " 步，其中 " << plan->memcpyCount() << " 次 memcpy）"
+                  << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            registry.copyInto("Profile", &targets[i], &sources[i]);
+        }
+        checksum += targets[count - 1].visits;
+        std::cout << "copyInto:        " << watch.elapsedMs() * 1e6 / count << " ns/对象" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            targets[i] = sources[i];
+        }
+        checksum += targets[count - 1].age;
+        std::cout << "原生拷贝赋值:    " << watch.elapsedMs() * 1e6 / count << " ns/对象（校验 " << checksum << "）"
+                  << std::endl;
+    }
+}
+
+/**
+ * @brief 对象比较与哈希：比较计划与手写的 operator== 和逐字段 std::hash 组合的对比
+ */
+void benchmarkObjectCompare(std::size_t count)
+{
+    std::cout << "\n=== 对象比较与哈希基准（" << count << " 个对象，11 个字段）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registerProfile(registry);
+    std::vector<Profile> left(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        left[i].age = static_cast<int>(i % 90);
+        left[i].id = static_cast<long long>(i);
+        left[i].visits = static_cast<int>(i);
+    }
+    std::vector<Profile> right = left;
+    right[count - 1].visits = -1;
+
+    std::shared_ptr<const ComparePlan> plan = registry.comparePlan("Profile", &left[0]);
+    std::cout << plan->fieldCount() << " 个字段，" << plan->stepCount() << " 步，其中 " << plan->byteRunCount()
+              << " 段按字节比较" << std::endl;
+
+    std::size_t checksum = 0;
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            checksum += plan->equals(&left[i], &right[i]);
+        }
+        std::cout << std::fixed << std::setprecision(1) << "计划 equals:     " << watch.elapsedMs() * 1e6 / count
+                  << " ns/对象" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Profile &a = left[i];
+            const Profile &b = right[i];
+            checksum += a.name == b.name && a.age == b.age && a.level == b.level && a.score == b.score &&
+                        a.balance == b.balance && a.id == b.id && a.city == b.city && a.active == b.active &&
+                        a.grade == b.grade && a.rank == b.rank && a.visits == b.visits;
+        }
+        std::cout << "手写 operator==: " << watch.elapsedMs() * 1e6 / count << " ns/对象" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            checksum += plan->hash(&left[i]);
+        }
+        std::cout << "计划 hash:       " << watch.elapsedMs() * 1e6 / count << " ns/对象" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Profile &a = left[i];
+            std::uint64_t hash = std::hash<std::string>()(a.name);
+            hash = hashCombine(hash, std::hash<int>()(a.age));
+            hash = hashCombine(hash, std::hash<int>()(a.level));
+            hash = hashCombine(hash, std::hash<double>()(a.score));
+            hash = hashCombine(hash, std::hash<double>()(a.balance));
+            hash = hashCombine(hash, std::hash<long long>()(a.id));
+            hash = hashCombine(hash, std::hash<std::string>()(a.city));
+            hash = hashCombine(hash, std::hash<bool>()(a.active));
+            hash = hashCombine(hash, std::hash<char>()(a.grade));
+            hash = hashCombine(hash, std::hash<short>()(a.rank));
+            hash = hashCombine(hash, std::hash<int>()(a.visits));
+            checksum += hash;
+        }
+        std::cout << "手写逐字段 hash: " << watch.elapsedMs() * 1e6 / count << " ns/对象" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        std::unordered_set<Profile, ReflectedHash<Profile>, ReflectedEqual<Profile>> unique(
+            count, ReflectedHash<Profile>(registry, "Profile"), ReflectedEqual<Profile>(registry, "Profile"));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            unique.insert(left[i]);
+            unique.insert(right[i]);
+        }
+        checksum += unique.size();
+        std::cout << "unordered_set 插入: " << watch.elapsedMs() * 1e6 / (2 * count) << " ns/次（" << unique.size()
+                  << " 个不同对象，校验 " << checksum << "）" << std::endl;
+    }
+}
+
+/**
+ * @brief 查询：逐对象按名 getValues、编译后的查询（串行/并行）与手写代码的过滤加排序对比
+ */
+void benchmarkQuery(std::size_t count)
+{
+    std::cout << "\n=== 查询基准（" << count << " 个 Person，money > 100 且 age < 40，按 age 降序、id 升序）==="
+              << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerField("PersonRecord", "name", &PersonRecord::name);
+    registry.registerField("PersonRecord", "age", &PersonRecord::age);
+    registry.registerField("PersonRecord", "money", &PersonRecord::money);
+    registry.registerField("PersonRecord", "height", &PersonRecord::height);
+    registry.registerField("PersonRecord", "id", &PersonRecord::id);
+
+    const char *const names[] = {"张三", "李四", "王五", "赵六", "钱七"};
+    std::vector<PersonRecord> people(count);
+    std::uint64_t seed = 12345;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        people[i].name = names[(seed >> 20) % 5];
+        people[i].age = static_cast<int>((seed >> 33) % 80);
+        people[i].money = static_cast<float>((seed >> 40) % 1000);
+        people[i].height = 1.5 + static_cast<double>((seed >> 50) % 50) / 100;
+        people[i].id = static_cast<long long>(i);
+    }
+
+    std::size_t checksum = 0;
+    {
+        // 逐对象按名读取：每次比较查找字段并装箱到 Any（只跑前 1/10 以控制耗时）
+        const std::size_t sample = count / 10;
+        Stopwatch watch;
+        std::vector<std::size_t> matched;
+        for (std::size_t i = 0; i < sample; ++i)
+        {
+            if (*registry.getValues("PersonRecord", "money", &people[i]).cast<float>() > 100 &&
+                *registry.getValues("PersonRecord", "age", &people[i]).cast<int>() < 40)
+            {
+                matched.push_back(i);
+            }
+        }
+        std::stable_sort(matched.begin(), matched.end(),
+                         [&](std::size_t a, std::size_t b)
+                         {
+                             int left = *registry.getValues("PersonRecord", "age", &people[a]).cast<int>();
+                             int right = *registry.getValues("PersonRecord", "age", &people[b]).cast<int>();
+                             return left > right;
+                         });
+        checksum += matched.size();
+        std::cout << std::fixed << std::setprecision(1) << "按名 getValues:   "
+                  << watch.elapsedMs() * 10 << " ms（按 1/10 规模外推）" << std::endl;
+    }
+
+    Query query(registry, "PersonRecord");
+    query.where("money", ">", Any(100)).where("age", "<", Any(40)).orderBy("age", true).orderBy("id");
+    std::size_t matchedCount = 0;
+    {
+        Query serial(query);
+        serial.parallel(false);
+        Stopwatch watch;
+        std::vector<std::size_t> result = serial.select(people.data(), people.size(), sizeof(PersonRecord));
+        matchedCount = result.size();
+        checksum += result.empty() ? 0 : result[0];
+        std::cout << "查询（串行）:     " << watch.elapsedMs() << " ms" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        std::vector<std::size_t> result = query.select(people.data(), people.size(), sizeof(PersonRecord));
+        checksum += result.empty() ? 0 : result[0];
+        std::cout << "查询（并行 " << registry.asyncPool()->workerCount() << " 线程）: " << watch.elapsedMs()
+                  << " ms（" << result.size() << " 个结果）" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        std::vector<std::size_t> result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (people[i].money > 100 && people[i].age < 40)
+            {
+                result.push_back(i);
+            }
+        }
+        std::stable_sort(result.begin(), result.end(),
+                         [&](std::size_t a, std::size_t b)
+                         {
+                             return people[a].age != people[b].age ? people[a].age > people[b].age
+                                                                   : people[a].id < people[b].id;
+                         });
+        checksum += result.size() == matchedCount;
+        std::cout << "手写（串行）:     " << watch.elapsedMs() << " ms" << std::endl;
+    }
+    {
+        Query byName(registry, "PersonRecord");
+        byName.where("money", ">", Any(100)).groupBy("name");
+        Stopwatch watch;
+        std::vector<Query::Group> groups = byName.group(people);
+        checksum += groups.size();
+        std::cout << "按 name 分组:     " << watch.elapsedMs() << " ms（" << groups.size() << " 组，校验 " << checksum
+                  << "）" << std::endl;
+    }
+}
+
+/**
+ * @brief CSV 导入导出：逐行解析后经 Any 和 setter 赋值，与按列编译的读写器（串行/并行）对比
+ */
+void benchmarkCsv(std::size_t count)
+{
+    std::cout << "\n=== CSV 导入导出基准（" << count << " 行，5 列）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerField("PersonRecord", "name", &PersonRecord::name);
+    registry.registerField("PersonRecord", "age", &PersonRecord::age);
+    registry.registerField("PersonRecord", "money", &PersonRecord::money);
+    registry.registerField("PersonRecord", "height", &PersonRecord::height);
+    registry.registerField("PersonRecord", "id", &PersonRecord::id);
+
+    const char *const names[] = {"张三", "李四", "王, 五", "赵\"六\"", "钱七"};
+    std::vector<PersonRecord> people(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        people[i].name = names[i % 5];
+        people[i].age = static_cast<int>(i % 80);
+        people[i].money = static_cast<float>(i % 100000) * 0.5f;
+        people[i].height = 1.5 + static_cast<double>(i % 50) / 100;
+        people[i].id = static_cast<long long>(i);
+    }
+
+    std::string text;
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        CsvWriter writer(registry, "PersonRecord");
+        writer.parallel(mode == 1);
+        Stopwatch watch;
+        std::ostringstream out;
+        writer.write(out, people);
+        text = out.str();
+        double ms = watch.elapsedMs();
+        std::cout << std::fixed << std::setprecision(1) << (mode == 0 ? "导出（串行）: " : "导出（并行）: ") << ms
+                  << " ms，" << count / ms / 1000 << " 百万行/秒（" << text.size() / (1024 * 1024) << " MB）"
+                  << std::endl;
+    }
+
+    {
+        // 逐行：切分后把每个值解析为字段类型、装箱到 Any，再经 setter 赋值（只跑前 1/10）
+        const std::size_t sample = count / 10;
+        std::vector<const PropertySetterBase *> setters;
+        for (const char *name : {"name", "age", "money", "height", "id"})
+        {
+            setters.push_back(registry.getSetter("PersonRecord", name));
+        }
+        std::vector<PersonRecord> rows(sample);
+        std::istringstream in(text);
+        std::string line;
+        std::getline(in, line);
+        Stopwatch watch;
+        for (std::size_t i = 0; i < sample && std::getline(in, line); ++i)
+        {
+            std::vector<std::string> cells;
+            std::string cell;
+            bool quoted = false;
+            for (char c : line)
+            {
+                if (c == '"')
+                {
+                    quoted = !quoted;
+                }
+                else if (c == ',' && !quoted)
+                {
+                    cells.push_back(cell);
+                    cell.clear();
+                }
+                else
+                {
+                    cell.push_back(c);
+                }
+            }
+            cells.push_back(cell);
+            setters[0]->set(&rows[i], Any(cells[0]));
+            setters[1]->set(&rows[i], Any(std::stoi(cells[1])));
+            setters[2]->set(&rows[i], Any(std::stof(cells[2])));
+            setters[3]->set(&rows[i], Any(std::stod(cells[3])));
+            setters[4]->set(&rows[i], Any(std::stoll(cells[4])));
+        }
+        double ms = watch.elapsedMs() * 10;
+        std::cout << "逐行 Any 导入:   " << ms << " ms，" << count / ms / 1000 << " 百万行/秒（按 1/10 规模外推）"
+                  << std::endl;
+    }
+    std::size_t checksum = 0;
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        CsvReader reader(registry, "PersonRecord");
+        reader.parallel(mode == 1);
+        Stopwatch watch;
+        std::vector<PersonRecord> rows = reader.read<PersonRecord>(text);
+        double ms = watch.elapsedMs();
+        checksum += rows.size() + static_cast<std::size_t>(rows.back().id);
+        std::cout << (mode == 0 ? "导入（串行）: " : "导入（并行）: ") << ms << " ms，" << count / ms / 1000
+                  << " 百万行/秒（" << registry.asyncPool()->workerCount() << " 线程，校验 " << checksum << "）"
+                  << std::endl;
+    }
+}
+
+/**
+ * @brief 对象存储：哈希索引查找、有序索引范围查询与按名逐个扫描的对比，以及带索引更新的写入
+ */
+void benchmarkObjectStore(std::size_t count)
+{
+    std::cout << "\n=== 对象存储基准（" << count << " 个对象，id 哈希索引，age 有序索引）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerClass<PersonRecord>("PersonRecord");
+    registry.registerField("PersonRecord", "name", &PersonRecord::name);
+    registry.registerField("PersonRecord", "age", &PersonRecord::age);
+    registry.registerField("PersonRecord", "id", &PersonRecord::id);
+
+    ObjectStore store(registry, "PersonRecord");
+    store.addHashIndex("id");
+    store.addOrderedIndex("age");
+    std::vector<ObjectStore::Id> ids(count);
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ids[i] = store.insert();
+            store.set(ids[i], "id", Any(static_cast<long long>(i * 7)));
+            store.set(ids[i], "age", Any(static_cast<int>(i % 100)));
+        }
+        std::cout << std::fixed << std::setprecision(1) << "插入并写入两个索引字段: "
+                  << watch.elapsedMs() * 1e6 / count << " ns/对象" << std::endl;
+    }
+
+    const std::size_t lookups = 100000;
+    std::size_t checksum = 0;
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < lookups; ++i)
+        {
+            checksum += store.findOne("id", Any(static_cast<long long>((i * 7919 % count) * 7)));
+        }
+        std::cout << "哈希索引查找:           " << watch.elapsedMs() * 1e6 / lookups << " ns/次" << std::endl;
+    }
+    {
+        // 没有索引时只能逐个按名读取字段比较（只跑 100 次）
+        const std::size_t scans = 100;
+        Stopwatch watch;
+        for (std::size_t i = 0; i < scans; ++i)
+        {
+            const long long key = static_cast<long long>((i * 7919 % count) * 7);
+            store.forEach([&](ObjectStore::Id id, const void *object)
+                          {
+                              if (*registry.getValues("PersonRecord", "id", object).cast<long long>() == key)
+                              {
+                                  checksum += id;
+                              }
+                          });
+        }
+        std::cout << "按名逐个扫描:           " << watch.elapsedMs() * 1e6 / scans << " ns/次" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        std::size_t matched = 0;
+        for (int age = 0; age < 100; ++age)
+        {
+            matched += store.range("age", Any(age), Any(age)).size();
+        }
+        std::cout << "有序索引范围查询:       " << watch.elapsedMs() * 1e6 / matched << " ns/结果（" << matched
+                  << " 个结果）" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < lookups; ++i)
+        {
+            store.set(ids[i % count], "age", Any(static_cast<int>((i * 31) % 100)));
+        }
+        std::cout << "写入索引字段:           " << watch.elapsedMs() * 1e6 / lookups << " ns/次（校验 " << checksum
+                  << "）" << std::endl;
+    }
+}
+
+/**
+ * @brief 轮流访问大量成员：每次按名查找与按下标遍历扁平成员表的对比
+ *
+ * 在一个类上注册 memberCount 个字段和方法（同一组成员指针，不同名字），
+ * 按注册顺序反复遍历，统计每次访问的耗时和缓存未命中。
+ * 按名查找经过类名编号和成员表的名字索引，表项本身与按下标访问的是同一份。
+ */
+void benchmarkMemberTable(std::size_t rounds)
+{
+    const std::size_t memberCount = 20000;
+    std::cout << "\n=== 扁平成员表基准（" << memberCount << " 个字段 + " << memberCount << " 个方法，"
+              << rounds << " 轮）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < memberCount; ++i)
+    {
+        names.push_back("member" + std::to_string(i));
+        if (i % 2 == 0)
+        {
+            registry.registerField("WideCitizen", names.back(), &Citizen::age_);
+        }
+        else
+        {
+            registry.registerField("WideCitizen", names.back(), &Citizen::birthYear_);
+        }
+        registry.registerMethod<Citizen, int, int>("WideCitizen", names.back(), &Citizen::calculateBirthYear);
+    }
+    std::vector<NameRef> nameRefs;
+    for (const auto &name : names)
+    {
+        nameRefs.push_back(NameRef(name));
+    }
+    const NameRef className = EVENTLY_NAME("WideCitizen");
+    const MemberTable &table = *registry.memberTable("WideCitizen");
+
+    Citizen citizen;
+    citizen.age_ = 30;
+    citizen.birthYear_ = 1994;
+    int year = 2024;
+    const void *args[] = {&year};
+    CacheMissCounter misses;
+    const double accesses = static_cast<double>(rounds * memberCount);
+
+    long long lookupSum = 0;
+    misses.start();
+    Stopwatch lookupWatch;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (std::size_t i = 0; i < memberCount; ++i)
+        {
+            int result = 0;
+            lookupSum += *static_cast<const int *>(registry.findField(className, nameRefs[i])->fieldAddress(&citizen));
+            table.method(table.findMethod(nameRefs[i])).invokeRaw(&citizen, args, &result);
+            lookupSum += result;
+        }
+    }
+    double lookupNs = lookupWatch.elapsedMs() * 1e6 / accesses;
+    std::uint64_t lookupMisses = misses.stop();
+
+    long long thunkSum = 0;
+    misses.start();
+    Stopwatch thunkWatch;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (std::size_t i = 0; i < memberCount; ++i)
+        {
+            int result = 0;
+            thunkSum += *static_cast<const int *>(table.field(i).fieldAddress(&citizen));
+            table.method(i).invokeRaw(&citizen, args, &result);
+            thunkSum += result;
+        }
+    }
+    double thunkNs = thunkWatch.elapsedMs() * 1e6 / accesses;
+    std::uint64_t thunkMisses = misses.stop();
+
+    std::cout << std::fixed << std::setprecision(2) << "按名查找: " << lookupNs << " ns/成员";
+    if (misses.available())
+    {
+        std::cout << ", " << static_cast<double>(lookupMisses) / accesses << " 次缓存未命中/成员";
+    }
+    std::cout << std::endl;
+    std::cout << "按下标遍历: " << thunkNs << " ns/成员";
+    if (misses.available())
+    {
+        std::cout << ", " << static_cast<double>(thunkMisses) / accesses << " 次缓存未命中/成员";
+    }
+    else
+    {
+        std::cout << "（perf_event_open 不可用，未统计缓存未命中）";
+    }
+    std::cout << (lookupSum == thunkSum ? "" : "（✗ 结果不一致）") << std::endl;
+}
+
+/**
+ * @brief 与测试程序中 Person 规模相同的样例类（21 个字段、5 个方法）
+ */
+struct SampleRecord
+{
+    std::string text;
+    int number = 0;
+    double amount = 0;
+    bool flag = false;
+    long long stamp = 0;
+
+    void setText(const std::string &value) { text = value; }
+    void setNumber(int value) { number = value; }
+    void reset() { number = 0; }
+    int offset(int value) { return value - number; }
+    std::string describe(const std::string &prefix) { return prefix + text; }
+};
+
+/**
+ * @brief 注册 count 个与 Person 同样成员的类，返回注册前后堆上仍在使用的字节数之差
+ */
+static std::ptrdiff_t registerSampleClasses(ReflectionRegistry &registry, std::size_t count)
+{
+    static const char *const textFields[] = {"name", "constantString"};
+    static const char *const numberFields[] = {"age", "gender", "level", "rank", "grade", "status",
+                                               "constantValue", "constantChar", "constantUnsignedInt"};
+    static const char *const amountFields[] = {"money", "height", "score", "constantDouble", "constantFloat"};
+    static const char *const flagFields[] = {"isEmployed", "constantBool"};
+    static const char *const stampFields[] = {"id", "timestamp", "constantLongLong"};
+
+    std::ptrdiff_t before = liveHeapBytes.load();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::string className = "Sample" + std::to_string(i);
+        for (const char *name : textFields)
+        {
+            registry.registerField(className, name, &SampleRecord::text);
+        }
+        for (const char *name : numberFields)
+        {
+            registry.registerField(className, name, &SampleRecord::number);
+        }
+        for (const char *name : amountFields)
+        {
+            registry.registerField(className, name, &SampleRecord::amount);
+        }
+        for (const char *name : flagFields)
+        {
+            registry.registerField(className, name, &SampleRecord::flag);
+        }
+        for (const char *name : stampFields)
+        {
+            registry.registerField(className, name, &SampleRecord::stamp);
+        }
+        registry.registerMethod<SampleRecord, void, const std::string &>(className, "setName", &SampleRecord::setText);
+        registry.registerMethod<SampleRecord, void, int>(className, "setAge", &SampleRecord::setNumber);
+        registry.registerMethod<SampleRecord, void>(className, "printInfo", &SampleRecord::reset);
+        registry.registerMethod<SampleRecord, int, int>(className, "calculateBirthYear", &SampleRecord::offset);
+        registry.registerMethod<SampleRecord, std::string, const std::string &>(className, "greet",
+                                                                                &SampleRecord::describe);
+    }
+    return liveHeapBytes.load() - before;
+}
+
+/**
+ * @brief 注册表元数据占用：count 个 Person 规模的类
+ */
+void benchmarkRegistryMemory(std::size_t count)
+{
+    std::cout << "\n=== 注册表内存基准（" << count << " 个类，每类 21 个字段 + 5 个方法）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    std::ptrdiff_t bytes = registerSampleClasses(registry, count);
+    std::cout << std::fixed << std::setprecision(1) << "注册后堆占用: " << bytes / 1048576.0 << " MB（"
+              << static_cast<double>(bytes) / count << " 字节/类）" << std::endl;
+
+    RegistryMemoryStats stats = registry.memoryStats();
+    for (const auto &structure : stats.structures)
+    {
+        std::cout << "  " << std::left << std::setw(16) << structure.name << std::right << std::setw(10)
+                  << structure.entries << " 项 " << std::setw(8) << structure.bytes / 1048576.0 << " MB"
+                  << std::endl;
+    }
+    std::cout << "估算合计: " << stats.totalBytes / 1048576.0 << " MB（与实测相差 "
+              << std::setprecision(2) << (static_cast<double>(stats.totalBytes) - bytes) * 100.0 / bytes
+              << std::setprecision(1) << "%），Sample0 占 "
+              << stats.classes["Sample0"] << " 字节" << std::endl;
+
+    std::size_t before = liveHeapBytes.load();
+    registry.compact();
+    std::ptrdiff_t compacted = bytes - static_cast<std::ptrdiff_t>(before - liveHeapBytes.load());
+    std::cout << "compact() 后堆占用: " << compacted / 1048576.0 << " MB（" << static_cast<double>(compacted) / count
+              << " 字节/类）" << std::endl;
+}
+
+/**
+ * @brief 当前标准下的词汇类型开销：Any 的构造、拷贝与取值（C++17 起同时测 std::any）
+ */
+void benchmarkVocabulary(std::size_t iterations)
+{
+    std::cout << "\n=== 词汇类型基准（" << iterations << " 次，C++ " << EVENTLY_CPLUSPLUS << "）===" << std::endl;
+
+    std::size_t checksum = 0;
+    const std::string text(24, 'x'); // 超过 libstdc++ 短字符串缓冲
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Any value(static_cast<int>(i));
+            Any copy = value;
+            checksum += static_cast<std::size_t>(*any_cast<int>(&static_cast<const Any &>(copy)));
+        }
+        std::cout << std::fixed << std::setprecision(1) << "Any int 构造+拷贝+取值:         "
+                  << watch.elapsedMs() * 1e6 / iterations << " ns/次" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Any value(text);
+            Any copy = value;
+            checksum += any_cast<std::string>(&static_cast<const Any &>(copy))->size();
+        }
+        std::cout << "Any string 构造+拷贝+取值:      " << watch.elapsedMs() * 1e6 / iterations << " ns/次" << std::endl;
+    }
+#if EVENTLY_HAS_CXX17
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::any value(static_cast<int>(i));
+            std::any copy = value;
+            checksum += static_cast<std::size_t>(*std::any_cast<int>(&copy));
+        }
+        std::cout << "std::any int 构造+拷贝+取值:    " << watch.elapsedMs() * 1e6 / iterations << " ns/次" << std::endl;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            std::any value(text);
+            std::any copy = value;
+            checksum += std::any_cast<std::string>(&copy)->size();
+        }
+        std::cout << "std::any string 构造+拷贝+取值: " << watch.elapsedMs() * 1e6 / iterations << " ns/次" << std::endl;
+    }
+#endif
+
+    // 按名字读取字段：NameRef 的哈希在运行时计算（C++17 起也可由 string_view 构造）
+    auto &registry = ReflectionRegistry::getInstance();
+    registerProfile(registry);
+    Profile profile;
+    const std::string fieldName = "visits";
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            checksum += registry.getValues("Profile", fieldName, &profile).type() == typeid(int);
+        }
+        std::cout << "getValues 按名读取:             " << watch.elapsedMs() * 1e6 / iterations << " ns/次（校验 "
+                  << checksum << "）" << std::endl;
+    }
+}
+
+/**
+ * @brief 枚举名字转换基准用的星期
+ */
+enum class Weekday
+{
+    Monday,
+    Tuesday,
+    Wednesday,
+    Thursday,
+    Friday,
+    Saturday,
+    Sunday
+};
+
+/// 手写的转换：switch 与逐个比较的 if 链
+const char *weekdayName(Weekday day)
+{
+    switch (day)
+    {
+    case Weekday::Monday:
+        return "Monday";
+    case Weekday::Tuesday:
+        return "Tuesday";
+    case Weekday::Wednesday:
+        return "Wednesday";
+    case Weekday::Thursday:
+        return "Thursday";
+    case Weekday::Friday:
+        return "Friday";
+    case Weekday::Saturday:
+        return "Saturday";
+    default:
+        return "Sunday";
+    }
+}
+
+Weekday weekdayFromName(const std::string &name)
+{
+    static const char *const names[] = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+    for (int i = 0; i < 6; ++i)
+    {
+        if (name == names[i])
+        {
+            return static_cast<Weekday>(i);
+        }
+    }
+    return Weekday::Sunday;
+}
+
+/**
+ * @brief 枚举名字转换：注册的名字表与手写的 switch / 逐个比较
+ */
+void benchmarkEnum(std::size_t iterations)
+{
+    std::cout << "\n=== 枚举名字转换基准（" << iterations << " 次）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    const EnumInfo &info = registry.registerEnum<Weekday>(
+        "Weekday", {{"Monday", Weekday::Monday}, {"Tuesday", Weekday::Tuesday}, {"Wednesday", Weekday::Wednesday},
+                    {"Thursday", Weekday::Thursday}, {"Friday", Weekday::Friday}, {"Saturday", Weekday::Saturday},
+                    {"Sunday", Weekday::Sunday}});
+    const std::string names[] = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
+
+    std::size_t checksum = 0;
+    double ns[4];
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            checksum += std::strlen(weekdayName(static_cast<Weekday>(i % 7)));
+        }
+        ns[0] = watch.elapsedMs() * 1e6 / iterations;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            checksum += info.nameOf(static_cast<long long>(i % 7))->size();
+        }
+        ns[1] = watch.elapsedMs() * 1e6 / iterations;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            checksum += static_cast<std::size_t>(weekdayFromName(names[i % 7]));
+        }
+        ns[2] = watch.elapsedMs() * 1e6 / iterations;
+    }
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            long long value = 0;
+            info.valueOf(NameRef(names[i % 7]), value);
+            checksum += static_cast<std::size_t>(value);
+        }
+        ns[3] = watch.elapsedMs() * 1e6 / iterations;
+    }
+    std::cout << std::fixed << std::setprecision(1) << "值 -> 名字: switch " << ns[0] << " ns/次, 名字表 " << ns[1]
+              << " ns/次" << std::endl;
+    std::cout << "名字 -> 值: 逐个比较 " << ns[2] << " ns/次, 名字表 " << ns[3] << " ns/次（校验 " << checksum << "）"
+              << std::endl;
+}
+
+/**
+ * @brief 字段同步：每帧按名读取并写回全部字段与只 flush 变化的绑定的对比
+ *
+ * pairs 对 Citizen 实例的 age 字段相互对应，每帧经注册表修改其中 1%。
+ */
+void benchmarkBinding(std::size_t pairs)
+{
+    const std::size_t frames = 200;
+    const std::size_t changesPerFrame = std::max<std::size_t>(1, pairs / 100);
+    std::cout << "\n=== 字段绑定基准（" << pairs << " 对字段，每帧修改 " << changesPerFrame << " 个，" << frames
+              << " 帧）===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registerCitizen();
+    std::vector<Citizen> models(pairs);
+    std::vector<Citizen> views(pairs);
+    std::size_t checksum = 0;
+    double polling;
+    {
+        Stopwatch watch;
+        for (std::size_t frame = 0; frame < frames; ++frame)
+        {
+            for (std::size_t i = 0; i < changesPerFrame; ++i)
+            {
+                const std::size_t index = (frame * 7919 + i * 101) % pairs;
+                registry.setValue("Citizen", "age", &models[index], Any(static_cast<int>(frame + i)));
+            }
+            for (std::size_t i = 0; i < pairs; ++i)
+            {
+                registry.setValue("Citizen", "age", &views[i], registry.getValues("Citizen", "age", &models[i]));
+            }
+        }
+        polling = watch.elapsedMs() * 1e3 / frames;
+        checksum += static_cast<std::size_t>(views[pairs / 2].age_);
+    }
+
+    BindingSet bindings(registry);
+    {
+        Stopwatch watch;
+        for (std::size_t i = 0; i < pairs; ++i)
+        {
+            bindings.bind("Citizen", &models[i], "age", "Citizen", &views[i], "age");
+        }
+        std::cout << std::fixed << std::setprecision(1) << "建立绑定: " << watch.elapsedMs() * 1e6 / pairs
+                  << " ns/个" << std::endl;
+    }
+    std::size_t applied = 0;
+    double batched;
+    {
+        Stopwatch watch;
+        for (std::size_t frame = 0; frame < frames; ++frame)
+        {
+            for (std::size_t i = 0; i < changesPerFrame; ++i)
+            {
+                const std::size_t index = (frame * 7919 + i * 101) % pairs;
+                registry.setValue("Citizen", "age", &models[index], Any(static_cast<int>(frame + i)));
+            }
+            applied += bindings.flush();
+        }
+        batched = watch.elapsedMs() * 1e3 / frames;
+        checksum += static_cast<std::size_t>(views[pairs / 2].age_);
+    }
+    std::cout << "每帧读取并写回全部字段: " << polling << " us/帧" << std::endl;
+    std::cout << "修改时标记 + flush:     " << batched << " us/帧（平均每帧执行 " << applied / frames
+              << " 个绑定，校验 " << checksum << "）" << std::endl;
+}
+
+/**
+ * @brief 基准测试入口
+ *
+ * 用法: Benchmark [测试名|all] [规模]
+ * 测试名: batch, plan, path, view, enumerate, lookup, anyalloc, sharedany, membertable, memory, copy, compare, query, csv, store, vocab, enum, binding
+ */
+int main(int argc, char **argv)
+{
+#if defined(_WIN64) || defined(_WIN32)
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    BenchmarkOptions options;
+    options.name = argc > 1 ? argv[1] : "all";
+    options.scale = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 0;
+
+    std::cout << "=== 反射系统基准测试 ===" << std::endl;
+
+    try
+    {
+        if (options.selected("batch"))
+        {
+            benchmarkBatchInvocation(options.scaleOr(10000000));
+        }
+        if (options.selected("plan"))
+        {
+            benchmarkCallPlan(options.scaleOr(1000000));
+        }
+        if (options.selected("path"))
+        {
+            benchmarkPropertyPath(options.scaleOr(1000000));
+        }
+        if (options.selected("view"))
+        {
+            benchmarkContainerView(options.scaleOr(1000000));
+        }
+        if (options.selected("enumerate"))
+        {
+            benchmarkEnumeration(options.scaleOr(1000000));
+        }
+        if (options.selected("lookup"))
+        {
+            benchmarkNameLookup(options.scaleOr(1000000));
+        }
+        if (options.selected("anyalloc"))
+        {
+            benchmarkAnyAllocator(options.scaleOr(200000));
+        }
+        if (options.selected("sharedany"))
+        {
+            benchmarkSharedAny(options.scaleOr(100000));
+        }
+        if (options.selected("membertable"))
+        {
+            benchmarkMemberTable(options.scaleOr(200));
+        }
+        if (options.selected("memory"))
+        {
+            benchmarkRegistryMemory(options.scaleOr(10000));
+        }
+        if (options.selected("copy"))
+        {
+            benchmarkObjectCopy(options.scaleOr(1000000));
+        }
+        if (options.selected("compare"))
+        {
+            benchmarkObjectCompare(options.scaleOr(1000000));
+        }
+        if (options.selected("query"))
+        {
+            benchmarkQuery(options.scaleOr(5000000));
+        }
+        if (options.selected("csv"))
+        {
+            benchmarkCsv(options.scaleOr(2000000));
+        }
+        if (options.selected("store"))
+        {
+            benchmarkObjectStore(options.scaleOr(1000000));
+        }
+        if (options.selected("vocab"))
+        {
+            benchmarkVocabulary(options.scaleOr(10000000));
+        }
+        if (options.selected("enum"))
+        {
+            benchmarkEnum(options.scaleOr(10000000));
+        }
+        if (options.selected("binding"))
+        {
+            benchmarkBinding(options.scaleOr(100000));
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "✗ 基准测试出错: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
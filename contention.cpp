@@ -0,0 +1,388 @@
+#include "BenchmarkSupport.h"
+#include "Reflection.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN64) || defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace Evently;
+using namespace Evently::literals;
+
+/**
+ * @brief 并发测试用的类：整数、浮点和字符串字段各一个，方法修改余额
+ */
+class Account
+{
+public:
+    double deposit(double amount)
+    {
+        balance_ += amount;
+        return balance_;
+    }
+
+public:
+    long long id_ = 42;
+    double balance_ = 0;
+    std::string owner_ = "a reasonably long owner name";
+};
+
+/**
+ * @brief 单个操作的种类；mixed 负载按 70% / 20% / 8% / 2% 的比例随机混合
+ */
+enum class Operation
+{
+    Read,     ///< 按名读取字段（交替读取 double 和 string，后者经过 Any 的堆分配）
+    Invoke,   ///< 按名调用方法
+    Create,   ///< 经工厂创建并销毁实例
+    Register, ///< 在本线程的子注册表中注册字段（共享注册表只读，见 ReflectionRegistry 的父子叠加）
+    Mixed
+};
+
+struct Workload
+{
+    const char *name;
+    Operation operation;
+};
+
+static const Workload kWorkloads[] = {{"read", Operation::Read},
+                                      {"invoke", Operation::Invoke},
+                                      {"create", Operation::Create},
+                                      {"register", Operation::Register},
+                                      {"mixed", Operation::Mixed}};
+
+/**
+ * @brief 每个工作线程的状态：自己的实例、参数和子注册表，只共享注册表本身
+ */
+class Worker
+{
+public:
+    Worker(const ReflectionRegistry &registry, std::size_t seed)
+        : registry_(registry), shard_(&registry), args_(1, Any(1.0)), random_(seed * 2654435761u + 1), step_(0)
+    {
+    }
+
+    void run(Operation operation)
+    {
+        switch (operation)
+        {
+        case Operation::Read:
+            read();
+            break;
+        case Operation::Invoke:
+            registry_.invokeMethod("Account"_name, "deposit"_name, &account_, args_);
+            break;
+        case Operation::Create:
+            registry_.createInstance("Account");
+            break;
+        case Operation::Register:
+            shard_.registerField("Account", kShardFields[step_++ % 8], &Account::balance_);
+            break;
+        case Operation::Mixed:
+            runMixed();
+            break;
+        }
+    }
+
+private:
+    static const char *const kShardFields[8];
+
+    void read()
+    {
+        if ((step_++ & 1) == 0)
+        {
+            Any balance = registry_.getValues("Account"_name, "balance"_name, &shared());
+            checksum_ += static_cast<std::size_t>(*balance.cast<double>());
+        }
+        else
+        {
+            checksum_ += registry_.getValues("Account"_name, "owner"_name, &shared()).cast<std::string>()->size();
+        }
+    }
+
+    void runMixed()
+    {
+        // xorshift：不与其他线程共享状态
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        const unsigned roll = static_cast<unsigned>(random_ % 100);
+        run(roll < 70 ? Operation::Read : roll < 90 ? Operation::Invoke : roll < 98 ? Operation::Create
+                                                                                   : Operation::Register);
+    }
+
+    /// 所有线程读取同一个实例，模拟共享的只读数据
+    static const Account &shared()
+    {
+        static const Account account;
+        return account;
+    }
+
+    const ReflectionRegistry &registry_;
+    ReflectionRegistry shard_;
+    Account account_;
+    std::vector<Any> args_;
+    std::uint64_t random_;
+    std::size_t step_;
+
+public:
+    std::size_t checksum_ = 0;
+};
+
+const char *const Worker::kShardFields[8] = {"f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7"};
+
+/**
+ * @brief 一次测量的结果（所有线程合计）
+ */
+struct RunResult
+{
+    double opsPerSecond;
+    std::uint64_t p50;
+    std::uint64_t p99;
+    std::uint64_t p999;
+    // 硬件计数器，available 为 false 时无意义
+    bool available[4];
+    std::uint64_t counters[4];
+};
+
+static const PerfCounter::Event kCounterEvents[4] = {PerfCounter::Event::Cycles, PerfCounter::Event::Instructions,
+                                                     PerfCounter::Event::CacheMisses,
+                                                     PerfCounter::Event::ContextSwitches};
+
+/**
+ * @brief 用 threads 个线程各执行 operations 次操作
+ *
+ * 所有线程就绪后同时开始；每个操作单独计时（包含两次读时钟的开销），延迟分位数按全部样本计算。
+ */
+static RunResult measure(const ReflectionRegistry &registry, Operation operation, std::size_t threads,
+                         std::size_t operations, std::size_t &checksum)
+{
+    std::vector<std::vector<std::uint32_t>> latencies(threads, std::vector<std::uint32_t>(operations));
+    std::vector<std::array<std::uint64_t, 4>> counts(threads);
+    std::vector<std::array<bool, 4>> available(threads);
+    std::vector<std::size_t> sums(threads);
+    std::atomic<std::size_t> ready(0);
+    std::atomic<bool> go(false);
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]()
+                          {
+                              Worker worker(registry, t);
+                              // 预热：填充线程本地的分配池和缓存
+                              for (std::size_t i = 0; i < 1000; ++i)
+                              {
+                                  worker.run(operation);
+                              }
+                              std::unique_ptr<PerfCounter> counters[4];
+                              for (int c = 0; c < 4; ++c)
+                              {
+                                  counters[c].reset(new PerfCounter(kCounterEvents[c]));
+                              }
+                              ready.fetch_add(1);
+                              while (!go.load(std::memory_order_acquire))
+                              {
+                                  std::this_thread::yield();
+                              }
+                              for (int c = 0; c < 4; ++c)
+                              {
+                                  counters[c]->start();
+                              }
+                              std::uint32_t *samples = latencies[t].data();
+                              for (std::size_t i = 0; i < operations; ++i)
+                              {
+                                  const auto start = std::chrono::steady_clock::now();
+                                  worker.run(operation);
+                                  const auto end = std::chrono::steady_clock::now();
+                                  samples[i] = static_cast<std::uint32_t>(std::min<long long>(
+                                      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                                      0xffffffffLL));
+                              }
+                              for (int c = 0; c < 4; ++c)
+                              {
+                                  counts[t][c] = counters[c]->stop();
+                                  available[t][c] = counters[c]->available();
+                              }
+                              sums[t] = worker.checksum_;
+                          });
+    }
+    while (ready.load() < threads)
+    {
+        std::this_thread::yield();
+    }
+    Stopwatch watch;
+    go.store(true, std::memory_order_release);
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+    const double elapsedMs = watch.elapsedMs();
+
+    RunResult result;
+    result.opsPerSecond = static_cast<double>(threads * operations) * 1e3 / elapsedMs;
+    std::vector<std::uint32_t> all;
+    all.reserve(threads * operations);
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        checksum += sums[t];
+    }
+    auto percentile = [&all](double fraction) -> std::uint64_t
+    {
+        const std::size_t rank = std::min(all.size() - 1, static_cast<std::size_t>(fraction * all.size()));
+        std::nth_element(all.begin(), all.begin() + rank, all.end());
+        return all[rank];
+    };
+    result.p50 = percentile(0.5);
+    result.p99 = percentile(0.99);
+    result.p999 = percentile(0.999);
+    for (int c = 0; c < 4; ++c)
+    {
+        result.available[c] = true;
+        result.counters[c] = 0;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            result.available[c] = result.available[c] && available[t][c];
+            result.counters[c] += counts[t][c];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 对一种负载按线程数序列测量，输出吞吐、延迟分位数、扩展效率和可用的硬件计数
+ *
+ * 扩展效率 = N 线程吞吐 / (N × 单线程吞吐)；线程数超过硬件并发数时效率必然下降。
+ */
+static void runWorkload(const ReflectionRegistry &registry, const Workload &workload,
+                        const std::vector<std::size_t> &counts, std::size_t operations)
+{
+    std::cout << "\n=== " << workload.name << "（每线程 " << operations << " 次）===" << std::endl;
+    // 表头用 ASCII，setw 按字节计宽，中文会错位
+    std::cout << std::left << std::setw(8) << "threads" << std::right << std::setw(10) << "Mops/s" << std::setw(10)
+              << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(10) << "p999 ns" << std::setw(10) << "scaling"
+              << std::setw(12) << "cycles/op" << std::setw(8) << "IPC" << std::setw(12) << "miss/op" << std::setw(10)
+              << "ctx-sw" << std::endl;
+
+    std::size_t checksum = 0;
+    double single = 0;
+    for (std::size_t threads : counts)
+    {
+        const RunResult result = measure(registry, workload.operation, threads, operations, checksum);
+        if (threads == counts.front())
+        {
+            single = result.opsPerSecond / static_cast<double>(threads);
+        }
+        const double total = static_cast<double>(threads * operations);
+        std::cout << std::left << std::setw(8) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << result.opsPerSecond / 1e6 << std::setw(10) << result.p50 << std::setw(10)
+                  << result.p99 << std::setw(10) << result.p999 << std::setprecision(1) << std::setw(9)
+                  << result.opsPerSecond / (single * static_cast<double>(threads)) * 100 << "%";
+        if (result.available[0])
+        {
+            std::cout << std::setw(12) << static_cast<double>(result.counters[0]) / total;
+        }
+        else
+        {
+            std::cout << std::setw(12) << "-";
+        }
+        if (result.available[0] && result.available[1] && result.counters[0] != 0)
+        {
+            std::cout << std::setprecision(2) << std::setw(8)
+                      << static_cast<double>(result.counters[1]) / static_cast<double>(result.counters[0]);
+        }
+        else
+        {
+            std::cout << std::setw(8) << "-";
+        }
+        if (result.available[2])
+        {
+            std::cout << std::setprecision(3) << std::setw(12) << static_cast<double>(result.counters[2]) / total;
+        }
+        else
+        {
+            std::cout << std::setw(12) << "-";
+        }
+        if (result.available[3])
+        {
+            std::cout << std::setw(10) << result.counters[3];
+        }
+        else
+        {
+            std::cout << std::setw(10) << "-";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "（校验 " << checksum << "）" << std::endl;
+}
+
+/**
+ * @brief 多线程争用与扩展性测试入口
+ *
+ * 用法: ContentionBenchmark [负载|all] [每线程操作数] [最大线程数]
+ * 负载: read, invoke, create, register, mixed
+ * 线程数为 1, 2, 4, ... 直到最大线程数（默认硬件并发数）。
+ * Linux 上经 perf_event_open 读取周期、指令、缓存未命中和上下文切换，无权限时显示为 "-"。
+ */
+int main(int argc, char **argv)
+{
+#if defined(_WIN64) || defined(_WIN32)
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    const std::string name = argc > 1 ? argv[1] : "all";
+    const std::size_t operations = argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)) : 200000;
+    const std::size_t maxThreads = argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : 0;
+    if (operations == 0)
+    {
+        std::cerr << "✗ 每线程操作数必须大于 0" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== 反射系统多线程争用测试（硬件并发数 " << std::thread::hardware_concurrency() << "）==="
+              << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerClass<Account>("Account");
+    registry.registerField("Account", "id", &Account::id_);
+    registry.registerField("Account", "balance", &Account::balance_);
+    registry.registerField("Account", "owner", &Account::owner_);
+    registry.registerMethod<Account, double, double>("Account", "deposit", &Account::deposit);
+
+    const std::vector<std::size_t> counts = threadCounts(maxThreads);
+    bool matched = false;
+    try
+    {
+        for (const Workload &workload : kWorkloads)
+        {
+            if (name == "all" || name == workload.name)
+            {
+                matched = true;
+                runWorkload(registry, workload, counts, operations);
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "✗ 争用测试出错: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!matched)
+    {
+        std::cerr << "✗ 未知的负载: " << name << std::endl;
+        return 1;
+    }
+    return 0;
+}
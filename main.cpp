@@ -1,6 +1,25 @@
 #include "Reflection.h"
+#include "CallPlan.h"
+#include "ComparePlan.h"
+#include "CopyPlan.h"
+#include "CsvTable.h"
+#include "DataBinding.h"
+#include "ObjectStore.h"
+#include "Query.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <atomic>
+#include <map>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
 
 #if defined(_WIN64) || defined(_WIN32)
 #include <windows.h>
@@ -93,6 +112,202 @@ public:
 
 };
 
+/**
+ * @brief 测试延迟注册用的Book类
+ */
+class Book
+{
+public:
+    Book() : title_(""), pages_(0) {}
+
+    int getPages() const { return pages_; }
+
+public:
+    std::string title_; ///< 书名
+    int pages_;         ///< 页数
+};
+
+/// Book注册函数被执行的次数（验证只执行一次）
+static int bookRegistrarCalls = 0;
+
+/**
+ * @brief Book类的延迟注册函数
+ */
+void registerBookReflection(ReflectionRegistry &registry)
+{
+    ++bookRegistrarCalls;
+    registry.registerClassName<Book>("Book");
+    registry.registerField<Book>("Book", "title", &Book::title_);
+    registry.registerField<Book>("Book", "pages", &Book::pages_);
+    registry.registerMethod<Book, int>("Book", "getPages", &Book::getPages);
+    registry.registerClass<Book>("Book");
+}
+
+/// 并发首次查询时Book注册函数被执行的次数
+static std::atomic<int> concurrentBookCalls(0);
+
+/**
+ * @brief 较慢的Book延迟注册函数，让其他线程的查询与加载重叠
+ */
+void registerBookSlowly(ReflectionRegistry &registry)
+{
+    ++concurrentBookCalls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    registry.registerField<Book>("Book", "pages", &Book::pages_);
+}
+
+/// Book注册函数是否已开始执行、另一线程是否已完成对其他类的查询，以及注册函数返回前是否看到了该查询
+static std::atomic<bool> bookLoadStarted(false);
+static std::atomic<bool> catalogRead(false);
+static std::atomic<bool> catalogReadDuringLoad(false);
+
+/**
+ * @brief 等待其他类的查询完成后才结束的Book延迟注册函数（最多等待 2 秒）
+ *
+ * 加载期间阻塞所有查询时，其他类的查询要等注册函数返回，这里会等到超时。
+ */
+void registerBookAfterCatalogRead(ReflectionRegistry &registry)
+{
+    bookLoadStarted = true;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!catalogRead && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    catalogReadDuringLoad = catalogRead.load();
+    registry.registerField<Book>("Book", "pages", &Book::pages_);
+}
+
+/**
+ * @brief 测试继承用的基类：名称
+ */
+class Named
+{
+public:
+    std::string label_; ///< 标签
+};
+
+/**
+ * @brief 测试继承用的基类：积分
+ */
+class Scored
+{
+public:
+    int getPoints() const { return points_; }
+    void addPoints(int delta) { points_ += delta; }
+    void addPoints(int delta, int times) { points_ += delta * times; }
+    void addPoints(const std::string &delta) { points_ += std::stoi(delta); }
+
+public:
+    int points_ = 0; ///< 积分
+    int bonus_ = 0;  ///< 奖励分
+};
+
+/**
+ * @brief 多继承的派生类（Scored 子对象不在偏移 0 处）
+ */
+class Player : public Named, public Scored
+{
+public:
+    int level_ = 1; ///< 等级
+};
+
+/**
+ * @brief 测试嵌套属性路径用的地址类
+ */
+class Address
+{
+public:
+    std::string city_;   ///< 城市
+    std::string street_; ///< 街道
+};
+
+/**
+ * @brief 测试嵌套属性路径用的客户类
+ */
+class Customer
+{
+public:
+    std::string name_; ///< 姓名
+    Address address_;  ///< 地址
+};
+
+/**
+ * @brief 测试无序容器字段的哈希用的库存
+ */
+class Inventory
+{
+public:
+    std::unordered_map<std::string, int> stock_; ///< 品名 -> 数量
+};
+
+/**
+ * @brief 测试嵌套属性路径用的订单明细
+ */
+class LineItem
+{
+public:
+    double price_ = 0.0; ///< 单价
+    int quantity_ = 0;   ///< 数量
+};
+
+/**
+ * @brief 测试嵌套属性路径用的订单类
+ */
+class Order
+{
+public:
+    const int orderId_ = 1001;     ///< 订单号（只读）
+    Customer customer_;            ///< 客户
+    std::vector<LineItem> items_;  ///< 明细
+    std::map<std::string, int> discounts_; ///< 折扣码 -> 折扣
+};
+
+/**
+ * @brief 测试枚举反射用的优先级（连续取值）
+ */
+enum class Priority : unsigned char
+{
+    Low,
+    Normal,
+    High
+};
+
+/**
+ * @brief 测试枚举反射用的权限位标志
+ */
+enum Permission : unsigned
+{
+    PermNone = 0,
+    PermRead = 1,
+    PermWrite = 2,
+    PermExec = 4,
+    PermReadWrite = PermRead | PermWrite
+};
+
+/**
+ * @brief 测试枚举反射用的工单类
+ */
+class Ticket
+{
+public:
+    std::string title_;                    ///< 标题
+    Priority priority_ = Priority::Normal; ///< 优先级
+    Permission access_ = PermNone;         ///< 权限
+    int estimate_ = 0;                     ///< 估时
+};
+
+/**
+ * @brief 测试数据绑定用的视图类
+ */
+class ProfileView
+{
+public:
+    int age_ = 0;          ///< 年龄
+    std::string ageLabel_; ///< 年龄文本
+    std::string title_;    ///< 标题
+};
+
 /**
  * @brief 注册Person类的反射信息
  */
@@ -580,6 +795,1859 @@ void testConstMethodInvocation()
     }
 }
 
+/**
+ * @brief 测试延迟注册
+ */
+void testLazyRegistration()
+{
+    std::cout << "\n=== 测试延迟注册 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerLazyClass<Book>("Book", &registerBookReflection);
+
+    if (registry.hasPendingRegistration("Book") && bookRegistrarCalls == 0)
+    {
+        std::cout << "✓ Book类尚未加载" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ Book类被提前加载" << std::endl;
+    }
+
+    // 通过类型查询类名会触发加载
+    std::string className = registry.getClassName<Book>();
+    std::cout << "✓ Book类的注册名称: " << className << std::endl;
+
+    Book book;
+    book.pages_ = 320;
+    Any pages = registry.getValues("Book", "pages", &book);
+    auto instance = registry.createInstance("Book");
+
+    if (bookRegistrarCalls == 1 && !registry.hasPendingRegistration("Book") &&
+        any_cast<int>(pages) == 320 && instance)
+    {
+        std::cout << "✓ 首次查询时完成注册，且只执行一次" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 延迟注册结果不正确，注册次数: " << bookRegistrarCalls << std::endl;
+    }
+
+    // 另有类始终待加载时，多个线程并发查询，其中首次查询Book的线程触发加载
+    ReflectionRegistry local;
+    local.registerField<Book>("Catalog", "title", &Book::title_);
+    local.registerLazyClass("Book", &registerBookSlowly);
+    local.registerLazyClass("Unused", &registerBookReflection);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.push_back(std::thread([&local, &book, &failures]()
+                                      {
+            for (int i = 0; i < 200; ++i)
+            {
+                try
+                {
+                    if (any_cast<std::string>(local.getValues("Catalog", "title", &book)) != book.title_ ||
+                        any_cast<int>(local.getValues("Book", "pages", &book)) != 320)
+                    {
+                        ++failures;
+                    }
+                }
+                catch (const std::exception &)
+                {
+                    ++failures;
+                }
+            } }));
+    }
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+    if (failures == 0 && concurrentBookCalls == 1 && local.hasPendingRegistration("Unused") &&
+        !local.hasPendingRegistration("Book"))
+    {
+        std::cout << "✓ 并发查询只加载一次所需的类，其余类仍待加载" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 并发延迟加载结果不正确，失败次数: " << failures << "，注册次数: " << concurrentBookCalls << std::endl;
+    }
+
+    // 加载Book期间，其他类的查询不等待注册函数执行完；查询Book的线程等到加载完成
+    ReflectionRegistry overlapped;
+    overlapped.registerField<Book>("Catalog", "title", &Book::title_);
+    overlapped.registerLazyClass("Book", &registerBookAfterCatalogRead);
+    overlapped.registerLazyClass("Unused", &registerBookReflection);
+    std::atomic<int> loadedPages(0);
+    std::thread loader([&overlapped, &book, &loadedPages]()
+                       { loadedPages = any_cast<int>(overlapped.getValues("Book", "pages", &book)); });
+    while (!bookLoadStarted)
+    {
+        std::this_thread::yield();
+    }
+    Any title = overlapped.getValues("Catalog", "title", &book);
+    catalogRead = true;
+    std::thread waiter([&overlapped, &book, &failures]()
+                       {
+        if (any_cast<int>(overlapped.getValues("Book", "pages", &book)) != 320)
+        {
+            ++failures;
+        } });
+    loader.join();
+    waiter.join();
+    if (catalogReadDuringLoad && any_cast<std::string>(title) == book.title_ && loadedPages == 320 &&
+        failures == 0)
+    {
+        std::cout << "✓ 加载期间其他类的查询不等待，查询该类的线程等到加载完成" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 加载期间的查询结果不正确" << std::endl;
+    }
+}
+
+/**
+ * @brief 测试继承与扁平化成员表
+ */
+void testInheritance()
+{
+    std::cout << "\n=== 测试继承 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerField<Named>("Named", "label", &Named::label_);
+    registry.registerField<Scored>("Scored", "points", &Scored::points_);
+    registry.registerMethod<Scored, int>("Scored", "getPoints", &Scored::getPoints);
+    registry.registerMethod<Scored, void, int>("Scored", "addPoints", &Scored::addPoints);
+    registry.registerField<Player>("Player", "level", &Player::level_);
+    registry.registerBase<Player, Named>("Player", "Named");
+    registry.registerBase<Player, Scored>("Player", "Scored");
+    // 声明继承后再注册的基类成员也会同步到派生类
+    registry.registerField<Scored>("Scored", "bonus", &Scored::bonus_);
+
+    Player player;
+    player.label_ = "玩家一";
+    player.points_ = 10;
+    player.bonus_ = 3;
+
+    try
+    {
+        std::cout << "✓ 继承字段 label: " << any_cast<std::string>(registry.getValues("Player", "label", &player)) << std::endl;
+        std::cout << "✓ 继承字段 points: " << any_cast<int>(registry.getValues("Player", "points", &player)) << std::endl;
+        std::cout << "✓ 后注册的继承字段 bonus: " << any_cast<int>(registry.getValues("Player", "bonus", &player)) << std::endl;
+
+        registry.getSetter("Player", "points")->set(&player, Any(20));
+        std::vector<Any> addArgs = {Any(5)};
+        registry.invokeMethod("Player", "addPoints", &player, addArgs);
+        Any points = registry.invokeMethod("Player", "getPoints", &player, {});
+        if (any_cast<int>(points) == 25 && player.points_ == 25)
+        {
+            std::cout << "✓ 通过派生类调用基类方法，积分: " << player.points_ << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 基类方法调用结果错误: " << any_cast<int>(points) << std::endl;
+        }
+
+        Scored *scored = &player;
+        void *up = registry.castInstance("Player", "Scored", &player);
+        void *down = registry.castInstance("Scored", "Player", scored);
+        if (up == scored && down == &player && registry.isDerivedFrom("Player", "Scored") &&
+            registry.castInstance("Named", "Scored", &player) == nullptr)
+        {
+            std::cout << "✓ 向上/向下转换的指针调整正确" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 继承体系内的指针转换错误" << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 继承测试失败: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 测试重载方法注册与按签名分派
+ */
+void testOverloadedMethods()
+{
+    std::cout << "\n=== 测试重载方法 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    // addPoints(int) 已在继承测试中注册，这里追加另外两个重载
+    registry.registerMethod<Scored, void, int, int>("Scored", "addPoints", &Scored::addPoints);
+    registry.registerMethod<Scored, void, const std::string &>("Scored", "addPoints", &Scored::addPoints);
+
+    Player player;
+    try
+    {
+        std::vector<Any> single = {Any(1)};
+        std::vector<Any> twice = {Any(2), Any(3)};
+        std::vector<Any> text = {Any(std::string("4"))};
+        registry.invokeMethod("Scored", "addPoints", static_cast<Scored *>(&player), single);
+        registry.invokeMethod("Scored", "addPoints", static_cast<Scored *>(&player), twice);
+        // 派生类继承整个重载集合
+        registry.invokeMethod("Player", "addPoints", &player, text);
+
+        if (player.points_ == 11)
+        {
+            std::cout << "✓ 三个重载均按参数类型正确分派，积分: " << player.points_ << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 重载分派结果错误，积分: " << player.points_ << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 重载方法调用失败: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        std::vector<Any> wrong = {Any(1.5)};
+        registry.invokeMethod("Player", "addPoints", &player, wrong);
+        std::cout << "✗ 不匹配的参数类型未被拒绝" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 正确拒绝没有匹配重载的调用: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 测试异步方法调用
+ */
+void testAsyncInvocation()
+{
+    std::cout << "\n=== 测试异步方法调用 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.setAsyncWorkerCount(4);
+
+    // 同一实例上的大量调用不加锁也不会丢失更新（按实例串行执行）
+    Scored first;
+    Scored second;
+    std::vector<std::future<Any>> futures;
+    std::vector<Any> args = {Any(1)};
+    for (int i = 0; i < 1000; ++i)
+    {
+        futures.push_back(registry.invokeAsync("Scored", "addPoints", &first, args));
+        futures.push_back(registry.invokeAsync("Scored", "addPoints", &second, args));
+    }
+    for (auto &future : futures)
+    {
+        future.get();
+    }
+
+    try
+    {
+        Person person("异步", 20);
+        std::vector<Any> yearArgs = {Any(2024)};
+        auto birthYear = registry.invokeAsync("Person", "calculateBirthYear", &person, yearArgs);
+        int year = any_cast<int>(birthYear.get());
+
+        if (first.points_ == 1000 && second.points_ == 1000 && year == 2004)
+        {
+            std::cout << "✓ 异步调用结果正确，同一实例上的调用没有并发冲突" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 异步调用结果错误: " << first.points_ << ", " << second.points_
+                      << ", " << year << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 异步调用失败: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        Scored scored;
+        registry.invokeAsync("Scored", "nonExistentMethod", &scored, {}).get();
+        std::cout << "✗ 异步调用未传递异常" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 异步调用的异常通过 future 传递: " << e.what() << std::endl;
+    }
+
+    // 0 解析为硬件并发数，与现有线程池实际线程数相同时不重建
+    std::shared_ptr<ThreadPool> held = registry.asyncPool();
+    registry.setAsyncWorkerCount(ThreadPool::resolveWorkerCount(0));
+    std::shared_ptr<ThreadPool> hardware = registry.asyncPool();
+    registry.setAsyncWorkerCount(0);
+    bool kept = registry.asyncPool() == hardware;
+
+    // 调整线程数后，之前取得的线程池在持有期间仍然可用
+    registry.setAsyncWorkerCount(held->workerCount() + 1);
+    std::atomic<std::size_t> covered(0);
+    held->parallelFor(100, 1, [&covered](std::size_t begin, std::size_t end)
+                      { covered += end - begin; });
+    bool resized = registry.asyncPool()->workerCount() == held->workerCount() + 1;
+    registry.setAsyncWorkerCount(4);
+
+    if (kept && resized && covered == 100)
+    {
+        std::cout << "✓ 调整线程数只在实际线程数变化时重建，已取得的线程池保持有效" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 调整线程数结果不正确: " << kept << ", " << resized << ", " << covered << std::endl;
+    }
+}
+
+/**
+ * @brief 测试共享 Any 作为引用参数用的类：方法通过非 const 引用修改实参
+ */
+class Exclaimer
+{
+public:
+    void exclaim(std::string &text) { text += "!"; }
+};
+
+/**
+ * @brief 测试批量调用
+ */
+void testBatchInvocation()
+{
+    std::cout << "\n=== 测试批量调用 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    const std::size_t count = 5000;
+    std::vector<Person> people(count);
+    std::vector<void *> instances(count);
+    std::vector<int> currentYears(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        people[i].age_ = static_cast<int>(i % 100);
+        instances[i] = &people[i];
+        currentYears[i] = 2000 + static_cast<int>(i % 30);
+    }
+
+    try
+    {
+        ResolvedMethod birthYear = registry.resolveMethod("Person", "calculateBirthYear", {&typeid(int)});
+        std::vector<int> shared(count);
+        std::vector<int> columns(count);
+        registry.invokeBatch(birthYear, instances.data(), count, {BatchColumn::shared(2024)}, shared.data());
+        registry.invokeBatch(birthYear, instances.data(), count, {BatchColumn::perInstance(currentYears)}, columns.data());
+
+        bool correct = true;
+        for (std::size_t i = 0; i < count && correct; ++i)
+        {
+            correct = shared[i] == 2024 - people[i].age_ && columns[i] == currentYears[i] - people[i].age_;
+        }
+        std::cout << (correct ? "✓ 共享参数与逐实例参数的批量调用结果正确" : "✗ 批量调用结果错误") << std::endl;
+
+        // 无返回值方法，且通过重载集合选出具体签名
+        ResolvedMethod addTwice = registry.resolveMethod("Player", "addPoints", {&typeid(int), &typeid(int)});
+        std::vector<Player> players(count);
+        std::vector<void *> playerInstances(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            playerInstances[i] = &players[i];
+        }
+        registry.invokeBatch(addTwice, playerInstances.data(), count,
+                             {BatchColumn::shared(2), BatchColumn::shared(3)});
+        std::cout << (players.front().points_ == 6 && players.back().points_ == 6
+                          ? "✓ 继承的重载方法批量调用正确"
+                          : "✗ 继承的重载方法批量调用错误")
+                  << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 批量调用失败: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        ResolvedMethod birthYear = registry.resolveMethod("Person", "calculateBirthYear", {&typeid(int)});
+        std::vector<double> wrongResults(count);
+        registry.invokeBatch(birthYear, instances.data(), count, {BatchColumn::shared(2024)}, wrongResults.data());
+        std::cout << "✗ 结果缓冲区类型错误未被拒绝" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 正确拒绝类型不匹配的结果缓冲区: " << e.what() << std::endl;
+    }
+
+    // 非 const 引用参数：逐实例的列各自被修改，共享列被拒绝
+    ReflectionRegistry local;
+    local.registerMethod<Exclaimer, void, std::string &>("Exclaimer", "exclaim", &Exclaimer::exclaim);
+    ResolvedMethod exclaim = local.resolveMethod("Exclaimer", "exclaim", {&typeid(std::string)});
+    std::vector<Exclaimer> exclaimers(count);
+    std::vector<void *> exclaimerInstances(count);
+    std::vector<std::string> texts(count, "hi");
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        exclaimerInstances[i] = &exclaimers[i];
+    }
+    local.invokeBatch(exclaim, exclaimerInstances.data(), count, {BatchColumn::perInstance(texts)});
+    std::string sharedText = "hi";
+    try
+    {
+        local.invokeBatch(exclaim, exclaimerInstances.data(), count, {BatchColumn::shared(sharedText)});
+        std::cout << "✗ 非 const 引用参数的共享列未被拒绝" << std::endl;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << (texts.front() == "hi!" && texts.back() == "hi!" && sharedText == "hi"
+                          ? "✓ 引用参数按实例修改，共享列被拒绝: "
+                          : "✗ 引用参数的批量调用结果错误: ")
+                  << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 测试编译后的调用计划
+ */
+void testCallPlan()
+{
+    std::cout << "\n=== 测试调用计划 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    try
+    {
+        // name = greet(name)；birthYear = calculateBirthYear(year)
+        CallPlan plan(registry, "Person");
+        std::size_t name = plan.readField("name");
+        std::size_t greeting = plan.callMethod("greet", {name});
+        plan.writeField("name", greeting);
+        std::size_t year = plan.input<int>();
+        std::size_t birthYear = plan.callMethod("calculateBirthYear", {year});
+        std::size_t hello = plan.constant(std::string("你好"));
+        plan.callMethod("setName", {hello});
+
+        CallPlanFrame frame = plan.createFrame();
+        Person person("计划", 30);
+        frame.slot<int>(year) = 2024;
+        plan.execute(&person, frame);
+
+        if (frame.slot<std::string>(greeting) == "计划, 我是 计划" && frame.slot<int>(birthYear) == 1994 &&
+            person.name_ == "你好")
+        {
+            std::cout << "✓ 调用计划执行结果正确: " << frame.slot<std::string>(greeting) << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 调用计划执行结果错误" << std::endl;
+        }
+
+        // 同一帧可以在其他实例上重复执行
+        Person other("复用", 40);
+        plan.execute(&other, frame);
+        std::cout << (frame.slot<int>(birthYear) == 1984 ? "✓ 执行帧可重复使用" : "✗ 执行帧复用结果错误")
+                  << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 调用计划失败: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        CallPlan plan(registry, "Person");
+        std::size_t name = plan.readField("name");
+        plan.writeField("age", name);
+        std::cout << "✗ 类型不匹配的写入未被拒绝" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 构建时拒绝类型不匹配的写入: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 测试嵌套属性路径
+ */
+void testPropertyPath()
+{
+    std::cout << "\n=== 测试嵌套属性路径 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerClassName<Address>("Address");
+    registry.registerField<Address>("Address", "city", &Address::city_);
+    registry.registerField<Address>("Address", "street", &Address::street_);
+    registry.registerClassName<Customer>("Customer");
+    registry.registerField<Customer>("Customer", "name", &Customer::name_);
+    registry.registerField<Customer>("Customer", "address", &Customer::address_);
+    registry.registerClassName<LineItem>("LineItem");
+    registry.registerField<LineItem>("LineItem", "price", &LineItem::price_);
+    registry.registerField<LineItem>("LineItem", "quantity", &LineItem::quantity_);
+    registry.registerClassName<Order>("Order");
+    registry.registerField<Order>("Order", "orderId", &Order::orderId_);
+    registry.registerField<Order>("Order", "customer", &Order::customer_);
+    registry.registerField<Order>("Order", "items", &Order::items_);
+    registry.registerField<Order>("Order", "discounts", &Order::discounts_);
+
+    Order order;
+    order.customer_.name_ = "张三";
+    order.customer_.address_.city_ = "上海";
+    order.items_.resize(4);
+    order.items_[3].price_ = 9.5;
+
+    try
+    {
+        // 解析一次，之后直接按偏移访问，返回的是实例内部的引用
+        PropertyPath city = registry.resolvePath("Order", "customer.address.city");
+        if (&city.value<std::string>(&order) == &order.customer_.address_.city_)
+        {
+            std::cout << "✓ customer.address.city 直接引用实例内部字段: " << city.value<std::string>(&order) << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 嵌套路径的地址错误" << std::endl;
+        }
+
+        std::cout << "✓ items[3].price: " << any_cast<double>(registry.getPathValue("Order", "items[3].price", &order))
+                  << std::endl;
+        registry.setPathValue("Order", "customer.address.city", &order, Any(std::string("北京")));
+        registry.setPathValue("Order", "items[3].quantity", &order, Any(2));
+        if (order.customer_.address_.city_ == "北京" && order.items_[3].quantity_ == 2)
+        {
+            std::cout << "✓ 按路径写入嵌套字段和容器元素" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 按路径写入结果错误" << std::endl;
+        }
+
+        // 缓存命中时返回同一个解析结果
+        if (registry.cachedPath("Order", "items[3].price") == registry.cachedPath("Order", "items[3].price"))
+        {
+            std::cout << "✓ 已解析的路径被缓存复用" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 路径缓存未命中" << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 嵌套属性路径失败: " << e.what() << std::endl;
+    }
+
+    // 错误路径：越界、格式错误、不存在的字段、只读字段、类型不匹配
+    const char *badPaths[] = {"items[9].price", "customer..name", "customer.phone", "customer[0]"};
+    for (const char *path : badPaths)
+    {
+        try
+        {
+            registry.getPathValue("Order", path, &order);
+            std::cout << "✗ 错误路径未被拒绝: " << path << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "✓ 拒绝错误路径 " << path << ": " << e.what() << std::endl;
+        }
+    }
+    try
+    {
+        registry.setPathValue("Order", "orderId", &order, Any(1));
+        std::cout << "✗ 只读字段被写入" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 拒绝写入只读字段: " << e.what() << std::endl;
+    }
+    try
+    {
+        registry.setPathValue("Order", "items[0].price", &order, Any(1));
+        std::cout << "✗ 类型不匹配的写入未被拒绝" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 拒绝类型不匹配的写入: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 测试容器字段视图（依赖 testPropertyPath 注册的 Order 类）
+ */
+void testContainerView()
+{
+    std::cout << "\n=== 测试容器字段视图 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    Order order;
+    order.items_.resize(3);
+    order.items_[2].price_ = 4.5;
+
+    try
+    {
+        ContainerView items = registry.containerField("Order", "items", &order);
+        if (items.size() == 3 && items.elementType() == typeid(LineItem) &&
+            &items.at<LineItem>(2) == &order.items_[2])
+        {
+            std::cout << "✓ 视图直接引用容器元素，元素数: " << items.size() << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 容器视图的元素信息错误" << std::endl;
+        }
+
+        LineItem extra;
+        extra.price_ = 10.0;
+        extra.quantity_ = 2;
+        items.append(extra);
+        items.mutableAt<LineItem>(0).quantity_ = 7;
+        items.set(1, Any(extra));
+        double total = 0.0;
+        items.forEach<LineItem>([&total](const LineItem &item)
+                                { total += item.price_; });
+        if (order.items_.size() == 4 && order.items_[0].quantity_ == 7 && total == 24.5)
+        {
+            std::cout << "✓ 通过视图追加、修改和遍历元素，总价: " << total << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 通过视图修改容器的结果错误" << std::endl;
+        }
+
+        ContainerView discounts = registry.containerField("Order", "discounts", &order);
+        discounts.insert(std::string("VIP"), 20);
+        discounts.insert(Any(std::string("NEW")), Any(5));
+        int sum = 0;
+        discounts.forEachEntry<std::string, int>([&sum](const std::string &, int value)
+                                                 { sum += value; });
+        const int *vip = discounts.find<int>(std::string("VIP"));
+        if (discounts.associative() && vip == &order.discounts_["VIP"] && sum == 25 &&
+            discounts.find(Any(std::string("NONE"))).empty())
+        {
+            std::cout << "✓ 关联容器视图的插入、查找和遍历正确" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 关联容器视图结果错误" << std::endl;
+        }
+
+        // 路径末端的容器同样可以取得视图
+        ContainerView byPath = registry.cachedPath("Order", "items")->container(&order);
+        std::cout << (byPath.size() == 4 ? "✓ 通过路径取得容器视图" : "✗ 路径容器视图错误") << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✗ 容器视图失败: " << e.what() << std::endl;
+    }
+
+    try
+    {
+        const Order &constOrder = order;
+        ContainerView readOnly = registry.containerField("Order", "items", &constOrder);
+        readOnly.append(LineItem());
+        std::cout << "✗ 只读视图被修改" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 只读视图拒绝修改: " << e.what() << std::endl;
+    }
+    try
+    {
+        registry.containerField("Order", "customer", &order);
+        std::cout << "✗ 非容器字段未被拒绝" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "✓ 非容器字段不能取得视图: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 字段枚举访问者：常用类型直接取值，其他类型只记录类型名
+ */
+struct FieldPrinter
+{
+    int primitives = 0;
+    int others = 0;
+    std::string summary;
+
+    void operator()(const std::string &name, const std::string &value)
+    {
+        ++primitives;
+        summary += name + "=" + value + " ";
+    }
+
+    void operator()(const std::string &name, ValueRef value)
+    {
+        ++others;
+        summary += name + ":" + (value.as<Address>() != nullptr ? "Address" : "?") + " ";
+    }
+
+    template <typename T>
+    void operator()(const std::string &name, const T &value)
+    {
+        ++primitives;
+        summary += name + "=" + std::to_string(value) + " ";
+    }
+};
+
+/**
+ * @brief 字段枚举访问者：按名字找出一个 int 字段，并统计字段总数
+ */
+struct IntFieldFinder
+{
+    explicit IntFieldFinder(const char *target) : target(target) {}
+
+    const char *target;
+    int value = -1;
+    std::size_t fields = 0;
+
+    void operator()(const std::string &name, int field)
+    {
+        ++fields;
+        if (name == target)
+        {
+            value = field;
+        }
+    }
+
+    void operator()(const std::string &, ValueRef) { ++fields; }
+
+    template <typename T>
+    void operator()(const std::string &, const T &) { ++fields; }
+};
+
+/**
+ * @brief 测试字段与方法的访问者枚举
+ */
+void testMemberVisitors()
+{
+    std::cout << "\n=== 测试成员枚举 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    Customer customer;
+    customer.name_ = "李四";
+    customer.address_.city_ = "杭州";
+
+    FieldPrinter printer;
+    registry.forEachField("Customer", &customer, printer);
+    if (printer.primitives == 1 && printer.others == 1)
+    {
+        std::cout << "✓ 按注册顺序枚举字段: " << printer.summary << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 字段枚举结果错误: " << printer.summary << std::endl;
+    }
+
+    // 继承字段同样出现在派生类的枚举中
+    Player player;
+    player.points_ = 42;
+    IntFieldFinder finder("points");
+    registry.forEachField("Player", &player, finder);
+    std::cout << (finder.value == 42 && finder.fields == 4 ? "✓ 继承字段按类型分派: points="
+                                                           : "✗ 继承字段枚举错误: points=")
+              << finder.value << std::endl;
+
+    std::size_t overloads = 0;
+    std::string signatures;
+    registry.forEachMethod("Player", [&](const std::string &name, const MethodInvokerBase &method)
+                           {
+                               if (name == "addPoints")
+                               {
+                                   ++overloads;
+                                   signatures += std::to_string(method.argCount()) + " ";
+                               } });
+    std::cout << (overloads == 3 ? "✓ 重载方法按签名展开，参数个数: " : "✗ 方法枚举错误: ") << signatures << std::endl;
+}
+
+/**
+ * @brief 测试以 NameRef 为键的查找
+ */
+void testNameRefLookup()
+{
+    std::cout << "\n=== 测试 NameRef 查找 ===" << std::endl;
+
+    using namespace Evently::literals;
+    auto &registry = ReflectionRegistry::getInstance();
+
+    // 编译期计算的哈希与运行时一致
+    static_assert(nameHash("age", 3) == EVENTLY_NAME("age").hash(), "编译期哈希应可用于常量表达式");
+    std::cout << ("age"_name.hash() == NameRef(std::string("age")).hash() ? "✓ 字面量哈希与运行时哈希一致"
+                                                                          : "✗ 字面量哈希不一致")
+              << std::endl;
+
+    Person person("查找", 28);
+    const PropertySetterBase *age = registry.findField("Person"_name, "age"_name);
+    if (age != nullptr && age == registry.findField("Person", "age") &&
+        any_cast<int>(registry.getValues(EVENTLY_NAME("Person"), EVENTLY_NAME("age"), &person)) == 28)
+    {
+        std::cout << "✓ 字面量键查找到同一个字段" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 字面量键查找失败" << std::endl;
+    }
+
+    // 解析器中的词法单元：指针 + 长度，不拷贝成字符串
+    const char *source = "calculateBirthYear(2024)";
+    NameRef token(source, std::strchr(source, '(') - source);
+    std::vector<Any> args = {Any(2024)};
+    Any birthYear = registry.invokeMethod("Person"_name, token, &person, args);
+    std::cout << (any_cast<int>(birthYear) == 1996 ? "✓ 指针 + 长度的方法名调用成功"
+                                                    : "✗ 指针 + 长度的方法名调用结果错误")
+              << std::endl;
+
+    if (registry.getSetter("Person"_name, "constantValue"_name) == nullptr &&
+        registry.findField("Person"_name, "ag"_name) == nullptr)
+    {
+        std::cout << "✓ const 字段无 setter，前缀名不会误匹配" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ NameRef 查找的边界情况错误" << std::endl;
+    }
+
+#if EVENTLY_HAS_CXX17
+    // C++17 起可直接用 string_view 片段作键
+    std::string_view path = "Person.age";
+    NameRef className(path.substr(0, 6));
+    NameRef fieldName(path.substr(7));
+    std::cout << (registry.findField(className, fieldName) == age && fieldName.view() == "age"
+                      ? "✓ string_view 片段作为 NameRef 查找到同一个字段"
+                      : "✗ string_view 键查找失败")
+              << std::endl;
+#endif
+}
+
+/// 测试用的自定义 Any 分配器：统计分配与释放次数
+static std::atomic<int> customAllocations(0);
+static std::atomic<int> customDeallocations(0);
+
+static void *countingAllocate(std::size_t size)
+{
+    ++customAllocations;
+    return ::operator new(size);
+}
+
+static void countingDeallocate(void *memory, std::size_t)
+{
+    ++customDeallocations;
+    ::operator delete(memory);
+}
+
+/**
+ * @brief 测试 Any 的池化分配器与自定义分配器
+ */
+void testAnyAllocator()
+{
+    std::cout << "\n=== 测试 Any 分配器 ===" << std::endl;
+
+    // 一个线程分配、另一个线程释放，再由两边继续复用
+    std::vector<Any> values;
+    std::thread producer([&values]() {
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(Any(std::string(i % 200, 'x')));
+        }
+    });
+    producer.join();
+
+    bool intact = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        intact = intact && any_cast<std::string>(values[i]).size() == static_cast<std::size_t>(i % 200);
+    }
+    std::thread consumer([&values]() { values.clear(); });
+    consumer.join();
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back(Any(i));
+    }
+    for (int i = 0; i < 1000; ++i)
+    {
+        intact = intact && any_cast<int>(values[i]) == i;
+    }
+    values.clear();
+    std::cout << (intact ? "✓ 跨线程释放后内存可安全复用" : "✗ 跨线程释放后值被破坏") << std::endl;
+
+    // 自定义分配器：切换前分配的值仍由原分配器释放
+    static const AnyAllocator counting = {&countingAllocate, &countingDeallocate};
+    Any before(1);
+    setAnyAllocator(counting);
+    {
+        Any a(2);
+        Any b(a);
+        before = Any();
+    }
+    setAnyAllocator(AnyAllocator::pooled());
+    if (customAllocations == 2 && customDeallocations == 2 && &anyAllocator() == &AnyAllocator::pooled())
+    {
+        std::cout << "✓ 自定义分配器只负责切换后分配的值" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 自定义分配器计数错误: " << customAllocations << " / " << customDeallocations << std::endl;
+    }
+
+    // 超过分级上限的值直接走全局分配
+    struct Large
+    {
+        char bytes[4096];
+    };
+    Large large;
+    large.bytes[4095] = 'z';
+    Any big(large);
+    std::cout << (any_cast<Large>(big).bytes[4095] == 'z' ? "✓ 大对象绕过分级池" : "✗ 大对象存储错误")
+              << std::endl;
+
+    // 对齐要求超过 max_align_t 的值：独立、拷贝和共享的存储都满足其对齐
+    struct alignas(64) Aligned
+    {
+        int value;
+    };
+    Aligned aligned;
+    aligned.value = 7;
+    Any alignedValue(aligned);
+    Any alignedCopy(alignedValue);
+    Any alignedShared = Any::shared(aligned);
+    bool alignedOk = true;
+    for (const Any *stored : {&alignedValue, &alignedCopy, &alignedShared})
+    {
+        const Aligned *held = any_cast<Aligned>(stored);
+        alignedOk = alignedOk && held != nullptr && held->value == 7 &&
+                    reinterpret_cast<std::uintptr_t>(held) % alignof(Aligned) == 0;
+    }
+    std::cout << (alignedOk ? "✓ 超对齐的值按其对齐存放" : "✗ 超对齐的值地址未对齐") << std::endl;
+}
+
+/**
+ * @brief 测试共享存储的 Any：拷贝只增加引用计数，可修改访问时写时复制
+ */
+void testSharedAny()
+{
+    std::cout << "\n=== 测试共享 Any ===" << std::endl;
+
+    Any original = Any::shared(std::string(1024, 'a'));
+    Any copy = original;
+    if (copy.isShared() && copy.data() == original.data() && !Any(std::string("x")).isShared())
+    {
+        std::cout << "✓ 拷贝共享同一份值" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 拷贝没有共享值" << std::endl;
+    }
+
+    // 写时复制：修改副本不影响原值，且只读访问不会触发复制
+    const void *before = original.data();
+    const std::string *readOnly = any_cast<std::string>(static_cast<const Any *>(&copy));
+    std::string *mutableValue = any_cast<std::string>(&copy);
+    mutableValue->assign("changed");
+    if (readOnly == before && copy.data() != before && original.data() == before &&
+        any_cast<std::string>(original).size() == 1024 && any_cast<std::string>(copy) == "changed" &&
+        copy.isShared())
+    {
+        std::cout << "✓ 可修改访问时写时复制，原值不变" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 写时复制错误" << std::endl;
+    }
+
+    // 独占时修改不再复制
+    const void *unique = copy.data();
+    copy.cast<std::string>()->append("!");
+    std::cout << (copy.data() == unique ? "✓ 独占的共享值原地修改" : "✗ 独占的共享值被多余复制") << std::endl;
+
+    // 非 const 引用参数绑定到共享值时写入调用期间的副本，实参和共享同一份值的其他 Any 都不变；
+    // 普通存储的实参仍直接被写入
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerMethod<Exclaimer, void, std::string &>("Exclaimer", "exclaim", &Exclaimer::exclaim);
+    Exclaimer exclaimer;
+    Any hello = Any::shared(std::string("hello"));
+    std::vector<Any> args{hello};
+    const void *sharedData = args[0].data();
+    registry.invokeMethod("Exclaimer", "exclaim", &exclaimer, args);
+    std::vector<Any> plainArgs{Any(std::string("plain"))};
+    registry.invokeMethod("Exclaimer", "exclaim", &exclaimer, plainArgs);
+    if (any_cast<std::string>(hello) == "hello" && any_cast<std::string>(args[0]) == "hello" &&
+        args[0].data() == sharedData && any_cast<std::string>(plainArgs[0]) == "plain!")
+    {
+        std::cout << "✓ 引用参数不修改共享的实参，普通实参仍被写入" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 引用参数绕过写时复制修改了共享值" << std::endl;
+    }
+
+    // 多线程并发拷贝与释放同一份值
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([original]() {
+            for (int i = 0; i < 10000; ++i)
+            {
+                Any local = original;
+                (void)local;
+            }
+        }));
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    std::cout << (any_cast<std::string>(original) == std::string(1024, 'a') ? "✓ 并发拷贝后引用计数正确"
+                                                                            : "✗ 并发拷贝后值被破坏")
+              << std::endl;
+}
+
+/**
+ * @brief 测试扁平成员表：连续存放的表项，经函数指针访问字段和调用方法
+ */
+void testMemberTable()
+{
+    std::cout << "\n=== 测试扁平成员表 ===" << std::endl;
+
+    using namespace Evently::literals;
+    auto &registry = ReflectionRegistry::getInstance();
+
+    const MemberTable *person = registry.memberTable("Person");
+    Person alice("成员表", 30);
+    std::size_t age = person != nullptr ? person->findField("age"_name) : MemberTable::npos;
+    if (age != MemberTable::npos && person->fieldName(age) == "age" && person->field(age).fieldType() == typeid(int))
+    {
+        person->field(age).set(&alice, Any(31));
+        std::vector<Any> args = {Any(2024)};
+        std::size_t method = person->findMethod("calculateBirthYear"_name);
+        Any birthYear = person->method(method).invoke(&alice, args);
+        std::cout << (alice.getAge() == 31 && any_cast<int>(birthYear) == 1993 &&
+                              any_cast<int>(person->field(age).get(&alice)) == 31
+                          ? "✓ 表项读写字段并调用方法"
+                          : "✗ 表项访问结果错误")
+                  << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 成员表中找不到字段 age" << std::endl;
+    }
+
+    // 继承成员带指针调整；重载集合按签名展开
+    const MemberTable *players = registry.memberTable("Player");
+    Player player;
+    player.points_ = 7;
+    std::size_t points = players->findField("points"_name);
+    std::size_t overloads = 0;
+    for (std::size_t i = 0; i < players->methodCount(); ++i)
+    {
+        overloads += players->methodName(i) == "addPoints";
+    }
+    std::vector<const std::type_info *> twoInts = {&typeid(int), &typeid(int)};
+    std::size_t addTwice = players->findMethod("addPoints"_name, registry.resolveMethod("Player", "addPoints", twoInts)
+                                                                    .invoker.signatureHash());
+    int first = 2;
+    int second = 3;
+    const void *rawArgs[] = {&first, &second};
+    if (points != MemberTable::npos && addTwice != MemberTable::npos)
+    {
+        players->method(addTwice).invokeRaw(&player, rawArgs, nullptr);
+    }
+    if (points != MemberTable::npos && overloads == 3 && player.points_ == 13 &&
+        players->field(points).fieldAddress(&player) == &player.points_)
+    {
+        std::cout << "✓ 继承成员指针调整正确，重载展开为 " << overloads << " 个表项" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 继承或重载表项错误" << std::endl;
+    }
+
+    if (!registry.memberTable("Player")->field(players->findField("label"_name)).writable() ||
+        registry.memberTable("NoSuchClass") != nullptr)
+    {
+        std::cout << "✗ 表项可写性或未注册类处理错误" << std::endl;
+    }
+    else
+    {
+        std::cout << "✓ 未注册的类没有成员表" << std::endl;
+    }
+}
+
+void testMemoryStats()
+{
+    std::cout << "\n=== 测试注册表内存统计与收紧 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    RegistryMemoryStats stats = registry.memoryStats();
+    std::size_t sum = 0;
+    for (const auto &structure : stats.structures)
+    {
+        sum += structure.bytes;
+    }
+    if (!stats.structures.empty() && sum == stats.totalBytes && stats.classes["Person"] > 0)
+    {
+        std::cout << "✓ 合计 " << stats.totalBytes << " 字节，Person 占 " << stats.classes["Person"] << " 字节"
+                  << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 内存统计不完整" << std::endl;
+    }
+
+    // 收紧后查询与注册照常
+    registry.compact();
+    Person person("收紧", 40);
+    registry.getSetter("Person", "age")->set(&person, Any(41));
+    registry.registerField("Person", "compactedAge", &Person::age_);
+    std::vector<Any> args = {Any(2024)};
+    bool intact = any_cast<int>(registry.getValues("Person", "age", &person)) == 41 &&
+                  any_cast<int>(registry.getValues("Person", "compactedAge", &person)) == 41 &&
+                  any_cast<int>(registry.invokeMethod("Person", "calculateBirthYear", &person, args)) == 1983 &&
+                  registry.memoryStats().totalBytes <= stats.totalBytes + 4096;
+    std::cout << (intact ? "✓ compact() 后字段读写和方法调用正常" : "✗ compact() 后查询失败") << std::endl;
+}
+
+void testRegistryInstances()
+{
+    std::cout << "\n=== 测试独立注册表与子注册表 ===" << std::endl;
+
+    auto &global = ReflectionRegistry::getInstance();
+
+    // 独立实例与单例互不影响
+    ReflectionRegistry local;
+    local.registerField<Scored>("Scored", "localOnly", &Scored::bonus_);
+    bool isolated = local.findField("Scored", "localOnly") != nullptr && local.findField("Person", "age") == nullptr &&
+                    global.findField("Scored", "localOnly") == nullptr;
+    std::cout << (isolated ? "✓ 独立注册表与单例互不可见" : "✗ 独立注册表与单例相互影响") << std::endl;
+
+    // 子注册表：未注册的类读父注册表，本层的类可以继承父注册表中的类
+    ReflectionRegistry shard(&global);
+    shard.registerField<Player>("ShardPlayer", "level", &Player::level_);
+    shard.registerBase<Player, Scored>("ShardPlayer", "Scored");
+    Player player;
+    player.points_ = 5;
+    player.level_ = 9;
+    Person person("分片", 28);
+    std::vector<Any> delta = {Any(4)};
+    shard.invokeMethod("ShardPlayer", "addPoints", &player, delta);
+    bool overlaid = any_cast<int>(shard.getValues("Person", "age", &person)) == 28 &&
+                    any_cast<int>(shard.getValues("ShardPlayer", "level", &player)) == 9 &&
+                    any_cast<int>(shard.getValues("ShardPlayer", "points", &player)) == 9 &&
+                    shard.isDerivedFrom("ShardPlayer", "Scored") &&
+                    shard.castInstance("ShardPlayer", "Scored", &player) == static_cast<Scored *>(&player) &&
+                    shard.getClassName<Person>() == "Person" && global.findField("ShardPlayer", "level") == nullptr;
+    std::cout << (overlaid ? "✓ 子注册表读取父注册表的类并继承其成员" : "✗ 子注册表叠加结果错误") << std::endl;
+
+    // 本层注册过的类整体遮蔽父注册表中的同名类，父注册表不变
+    shard.registerField<Person>("Person", "nickname", &Person::name_);
+    bool shadowed = shard.findField("Person", "age") == nullptr && shard.findField("Person", "nickname") != nullptr &&
+                    global.findField("Person", "nickname") == nullptr && global.findField("Person", "age") != nullptr;
+    std::cout << (shadowed ? "✓ 子注册表的同名类遮蔽父注册表" : "✗ 子注册表遮蔽结果错误") << std::endl;
+}
+
+void testPluginLoading()
+{
+    std::cout << "\n=== 测试按需加载插件模块 ===" << std::endl;
+
+#ifdef EVENTLY_TEST_PLUGIN
+    const std::string modulePath = EVENTLY_TEST_PLUGIN;
+    const std::string manifestPath = modulePath + ".manifest";
+    {
+        std::ofstream manifest(manifestPath);
+        manifest << "# 类名 模块路径\n"
+                 << "Greeter " << modulePath << "\n"
+                 << "Farewell " << modulePath << "\n";
+    }
+    ReflectionRegistry registry;
+    registry.loadPluginManifest(manifestPath);
+    std::remove(manifestPath.c_str());
+    bool deferred = registry.hasPendingRegistration("Greeter") && !registry.isPluginLoaded(modulePath);
+
+    // 多个线程同时首次查询模块中的两个类，模块只加载一次
+    std::atomic<int> found(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&registry, &found, i]()
+                             {
+                                 bool greeter = i % 2 == 0;
+                                 if (registry.findField(greeter ? "Greeter" : "Farewell", greeter ? "name" : "words") != nullptr)
+                                 {
+                                     ++found;
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    auto greeter = registry.createInstance("Greeter");
+    std::vector<Any> args = {Any(std::string("测试"))};
+    std::string greeting = any_cast<std::string>(registry.invokeMethod("Greeter", "greet", greeter.get(), args));
+    int hookCalls = any_cast<int>(registry.invokeMethod("Greeter", "hookCalls", greeter.get(), std::vector<Any>()));
+    if (deferred && found == 8 && hookCalls == 1 && greeting == "插件向测试问好" && registry.isPluginLoaded(modulePath))
+    {
+        std::cout << "✓ 首次查询时加载插件，并发查询只执行一次注册函数" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 插件加载结果错误" << std::endl;
+    }
+
+    // 仍有实例时不能卸载；实例释放后卸载，再次查询会重新加载
+    bool busy = !registry.unloadPlugin(modulePath);
+    greeter.reset();
+    bool unloaded = registry.unloadPlugin(modulePath) && !registry.isPluginLoaded(modulePath) &&
+                    registry.hasPendingRegistration("Farewell");
+    bool reloaded = registry.getSetter("Farewell", "words") != nullptr && registry.isPluginLoaded(modulePath);
+    std::cout << (busy && unloaded && reloaded ? "✓ 实例释放后卸载插件，之后的查询重新加载"
+                                               : "✗ 插件卸载或重新加载错误")
+              << std::endl;
+#else
+    std::cout << "✓ 未构建测试插件，跳过" << std::endl;
+#endif
+}
+
+void testObjectCopy()
+{
+    std::cout << "\n=== 测试按元数据拷贝对象 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    Person alice("拷贝", 35);
+    alice.height_ = 1.72;
+    alice.id_ = 7001;
+    alice.status_ = 3;
+    auto copy = registry.clone("Person", &alice);
+    const Person *cloned = static_cast<const Person *>(copy.get());
+    if (cloned != nullptr && cloned->name_ == "拷贝" && cloned->age_ == 35 && cloned->height_ == 1.72 &&
+        cloned->id_ == 7001 && cloned->status_ == 3 && cloned->constantValue_ == 42)
+    {
+        std::cout << "✓ clone 用工厂创建实例并拷贝全部可写字段" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ clone 结果错误" << std::endl;
+    }
+
+    // 继承字段带偏移；相邻的 points、bonus、level 合并为一次 memcpy
+    Player source;
+    source.label_ = "拷贝玩家";
+    source.points_ = 11;
+    source.bonus_ = 4;
+    source.level_ = 6;
+    Player target;
+    registry.copyInto("Player", &target, &source);
+    CopyPlan plan(registry, "Player", &source);
+    if (target.label_ == "拷贝玩家" && target.points_ == 11 && target.bonus_ == 4 && target.level_ == 6 &&
+        plan.fieldCount() == 4 && plan.stepCount() == 2 && plan.memcpyCount() == 1)
+    {
+        std::cout << "✓ copyInto 拷贝继承字段，" << plan.fieldCount() << " 个字段合并为 " << plan.stepCount()
+                  << " 步" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ copyInto 结果或合并步骤错误" << std::endl;
+    }
+}
+
+void testObjectComparison()
+{
+    std::cout << "\n=== 测试按元数据比较和哈希对象 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    // 默认构造函数不初始化数值字段，先逐个赋值
+    Person alice("比较", 30);
+    alice.money_ = 10.5f;
+    alice.height_ = 1.8;
+    alice.isEmployed_ = true;
+    alice.gender_ = 'F';
+    alice.id_ = 8001;
+    alice.score_ = 90;
+    alice.timestamp_ = 1700000000ULL;
+    alice.level_ = 3;
+    alice.rank_ = 2;
+    alice.grade_ = 'A';
+    alice.status_ = 1;
+    Person same = alice;
+    Person older = alice;
+    older.age_ = 31;
+    if (registry.equals("Person", &alice, &same) && !registry.equals("Person", &alice, &older) &&
+        registry.hash("Person", &alice) == registry.hash("Person", &same) &&
+        registry.compare("Person", &alice, &older) < 0 && registry.compare("Person", &older, &alice) > 0 &&
+        registry.compare("Person", &alice, &same) == 0)
+    {
+        std::cout << "✓ equals / compare / hash 覆盖全部注册字段" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ Person 的比较结果错误" << std::endl;
+    }
+
+    // 继承字段带偏移；相邻的 points、bonus、level 合并为一段字节比较
+    Player first;
+    first.label_ = "alpha";
+    first.points_ = 5;
+    Player second = first;
+    second.level_ = 2;
+    Player third = first;
+    third.label_ = "beta";
+    ComparePlan plan(registry, "Player", &first);
+    bool planOk = plan.fieldCount() == 4 && plan.stepCount() == 2 && plan.byteRunCount() == 1 &&
+                  !plan.equals(&first, &second) && plan.compare(&first, &third) < 0;
+
+    // 函数对象直接用作无序容器和有序容器的模板参数
+    std::unordered_map<Player, int, ReflectedHash<Player>, ReflectedEqual<Player>> counts(
+        8, ReflectedHash<Player>(registry, "Player"), ReflectedEqual<Player>(registry, "Player"));
+    ++counts[first];
+    ++counts[second];
+    ++counts[third];
+    Player copy = first;
+    ++counts[copy];
+    std::set<Player, ReflectedLess<Player>> ordered(ReflectedLess<Player>(registry, "Player"));
+    ordered.insert(third);
+    ordered.insert(second);
+    ordered.insert(first);
+    bool containersOk = counts.size() == 3 && counts[first] == 2 && ordered.size() == 3 &&
+                        ordered.begin()->label_ == "alpha" && ordered.begin()->level_ == 1;
+    if (planOk && containersOk)
+    {
+        std::cout << "✓ 相邻整数字段合并比较，函数对象可用于 unordered_map 和 set" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ Player 的比较计划或容器结果错误" << std::endl;
+    }
+
+    // 相等的无序容器可能以不同顺序遍历，哈希必须与顺序无关
+    registry.registerField("Inventory", "stock", &Inventory::stock_);
+    Inventory left;
+    Inventory right;
+    right.stock_.reserve(256);
+    for (int i = 0; i < 32; ++i)
+    {
+        left.stock_["item" + std::to_string(i)] = i;
+        right.stock_["item" + std::to_string(31 - i)] = 31 - i;
+    }
+    bool differentOrder = left.stock_.begin()->first != right.stock_.begin()->first;
+    Inventory fewer = left;
+    fewer.stock_.erase("item0");
+    if (differentOrder && registry.equals("Inventory", &left, &right) &&
+        registry.hash("Inventory", &left) == registry.hash("Inventory", &right) &&
+        registry.hash("Inventory", &left) != registry.hash("Inventory", &fewer))
+    {
+        std::cout << "✓ 遍历顺序不同的相等 unordered_map 字段哈希相同" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ unordered_map 字段的哈希与遍历顺序有关" << std::endl;
+    }
+
+    // 不可比较的字段在使用该能力时报错
+    try
+    {
+        if (registry.getSetter("Customer", "address") == nullptr)
+        {
+            registry.registerField<Customer>("Customer", "address", &Customer::address_);
+        }
+        Customer customer;
+        registry.equals("Customer", &customer, &customer);
+        std::cout << "✗ 不可比较的字段没有报错" << std::endl;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "✓ 不可比较的字段报错: " << e.what() << std::endl;
+    }
+}
+
+void testQuery()
+{
+    std::cout << "\n=== 测试按字段名查询对象集合 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    std::vector<Person> people(40000);
+    const char *const names[] = {"张三", "李四", "王五", "赵六"};
+    for (std::size_t i = 0; i < people.size(); ++i)
+    {
+        Person &person = people[i];
+        person.name_ = names[i % 4];
+        person.age_ = static_cast<int>(i % 60);
+        person.money_ = static_cast<float>(i % 500);
+        person.height_ = 1.5 + (i % 50) * 0.01;
+        person.id_ = static_cast<long long>(i);
+        person.score_ = static_cast<unsigned int>(i % 7);
+    }
+
+    // 并行与串行执行的结果必须一致（包括相等键的原顺序）
+    Query query(registry, "Person");
+    query.where("money", ">", Any(100)).where("age", "<=", Any(30.5)).orderBy("age", true).orderBy("name");
+    std::vector<const Person *> parallel = query.select(people);
+    std::vector<const Person *> serial = Query(query).parallel(false).select(people);
+    bool filtered = !parallel.empty() && parallel == serial;
+    for (std::size_t i = 0; filtered && i < parallel.size(); ++i)
+    {
+        const Person &person = *parallel[i];
+        filtered = person.money_ > 100 && person.age_ <= 30;
+        if (i > 0)
+        {
+            const Person &previous = *parallel[i - 1];
+            filtered = filtered && (previous.age_ > person.age_ ||
+                                    (previous.age_ == person.age_ &&
+                                     (previous.name_ < person.name_ ||
+                                      (previous.name_ == person.name_ && previous.id_ < person.id_))));
+        }
+    }
+    if (filtered)
+    {
+        std::cout << "✓ 过滤和多键排序正确，并行与串行结果一致（" << parallel.size() << " 个对象）" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 过滤或排序结果错误" << std::endl;
+    }
+
+    // 按字符串字段分组，组按首次出现的顺序排列
+    Query byName(registry, "Person");
+    byName.where("score", "==", Any(3)).groupBy("name");
+    std::vector<Query::Group> groups = byName.group(people);
+    std::size_t grouped = 0;
+    bool groupsOk = groups.size() == 4 && any_cast<std::string>(groups[0].key) == names[3];
+    for (const auto &group : groups)
+    {
+        grouped += group.indices.size();
+        for (std::size_t index : group.indices)
+        {
+            groupsOk = groupsOk && people[index].name_ == any_cast<std::string>(group.key) && people[index].score_ == 3;
+        }
+    }
+    if (groupsOk && grouped == (people.size() + 3) / 7)
+    {
+        std::cout << "✓ 按 name 分组得到 " << groups.size() << " 组，共 " << grouped << " 个对象" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 分组结果错误" << std::endl;
+    }
+
+    try
+    {
+        Query(registry, "Person").where("name", ">", Any(5));
+        std::cout << "✗ 类型不匹配的常量没有报错" << std::endl;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "✓ 类型不匹配的常量报错: " << e.what() << std::endl;
+    }
+}
+
+void testCsvTable()
+{
+    std::cout << "\n=== 测试 CSV / TSV 批量导入导出 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    // 文本中带分隔符、引号和换行，必须加引号并在读回时还原
+    const char *const names[] = {"张三", "李,四", "王\"五\"", "赵\n六"};
+    std::vector<Person> people(20000);
+    for (std::size_t i = 0; i < people.size(); ++i)
+    {
+        Person &person = people[i];
+        person.name_ = names[i % 4];
+        person.age_ = static_cast<int>(i % 90) - 10;
+        person.money_ = static_cast<float>(i) * 0.25f;
+        person.height_ = 1.5 + static_cast<double>(i % 50) / 100;
+        person.isEmployed_ = i % 3 == 0;
+        person.gender_ = i % 2 == 0 ? 'M' : 'F';
+        person.id_ = -static_cast<long long>(i) * 1000003;
+        person.score_ = static_cast<unsigned int>(i);
+        person.timestamp_ = 18000000000000000000ULL + i;
+        person.level_ = static_cast<short>(i % 300);
+        person.rank_ = static_cast<unsigned short>(i % 65000);
+        person.grade_ = static_cast<signed char>(static_cast<int>(i % 256) - 128);
+        person.status_ = static_cast<unsigned char>(i % 256);
+    }
+
+    auto same = [](const Person &a, const Person &b)
+    {
+        return a.name_ == b.name_ && a.age_ == b.age_ && a.money_ == b.money_ && a.height_ == b.height_ &&
+               a.isEmployed_ == b.isEmployed_ && a.gender_ == b.gender_ && a.id_ == b.id_ && a.score_ == b.score_ &&
+               a.timestamp_ == b.timestamp_ && a.level_ == b.level_ && a.rank_ == b.rank_ &&
+               a.grade_ == b.grade_ && a.status_ == b.status_;
+    };
+
+    // 超过并行阈值：分块边界可能落在带引号的换行中间
+    CsvWriter writer(registry, "Person");
+    std::string text = writer.toString(people);
+    std::string serialText = CsvWriter(registry, "Person").parallel(false).toString(people);
+    CsvReader reader(registry, "Person");
+    std::vector<Person> parsed = reader.read<Person>(text);
+    std::vector<Person> serial = CsvReader(reader).parallel(false).read<Person>(text);
+    bool roundTrip = text == serialText && text.size() >= CsvReader::parallelThreshold &&
+                     parsed.size() == people.size() && serial.size() == people.size();
+    for (std::size_t i = 0; roundTrip && i < people.size(); ++i)
+    {
+        roundTrip = same(parsed[i], people[i]) && same(serial[i], people[i]);
+    }
+    if (roundTrip)
+    {
+        std::cout << "✓ 写出 " << text.size() / 1024 << " KB 后并行读回 " << parsed.size()
+                  << " 行，全部字段一致" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ CSV 往返结果不一致" << std::endl;
+    }
+
+    // TSV：只输出指定列；读入时忽略未知列，缺少的字段保持默认值
+    std::vector<std::string> columns = {"id", "name", "age"};
+    std::string tsv = CsvWriter(registry, "Person", columns, CsvFormat::tsv()).toString(people.data(), 2,
+                                                                                      sizeof(Person));
+    tsv += "7\tnew\t\r\n";
+    std::string withExtra = "unknown\t" + tsv.substr(0, tsv.find('\n')) + "\n1\t2\t\"多\t行\n名\"\t33\n";
+    std::vector<Person> rows = CsvReader(registry, "Person", CsvFormat::tsv()).read<Person>(tsv);
+    std::vector<Person> extra = CsvReader(registry, "Person", CsvFormat::tsv()).read<Person>(withExtra);
+    if (tsv.compare(0, 12, "id\tname\tage\n") == 0 && rows.size() == 3 && rows[1].name_ == "李,四" &&
+        rows[1].id_ == -1000003 && rows[2].name_ == "new" && rows[2].id_ == 7 && extra.size() == 1 &&
+        extra[0].id_ == 2 && extra[0].name_ == "多\t行\n名" && extra[0].age_ == 33)
+    {
+        std::cout << "✓ TSV 按列名对应字段，忽略未知列" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ TSV 列映射错误" << std::endl;
+    }
+
+    try
+    {
+        reader.read<Person>(std::string("name,age\nbad,12x\n"));
+        std::cout << "✗ 无法解析的值没有报错" << std::endl;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "✓ 无法解析的值报错: " << e.what() << std::endl;
+    }
+}
+
+void testObjectStore()
+{
+    std::cout << "\n=== 测试带二级索引的对象存储 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    ObjectStore store(registry, "Person");
+    store.addHashIndex("id");
+    store.addOrderedIndex("age");
+    const char *const names[] = {"甲", "乙", "丙"};
+    std::vector<ObjectStore::Id> ids;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ObjectStore::Id id = store.insert();
+        store.set(id, "id", Any(static_cast<long long>(10000 + i)));
+        store.set(id, "age", Any(i % 100));
+        store.set(id, "name", Any(std::string(names[i % 3])));
+        ids.push_back(id);
+    }
+    // 已有对象在建索引时立即加入
+    store.addHashIndex("name");
+
+    const char *first = static_cast<const char *>(store.get(ids[0]));
+    const char *second = static_cast<const char *>(store.get(ids[1]));
+    bool contiguous = second - first == static_cast<std::ptrdiff_t>(sizeof(Person));
+    ObjectStore::Id found = store.findOne("id", Any(10042LL));
+    std::vector<ObjectStore::Id> thirties = store.range("age", Any(30), Any(32));
+    bool ordered = thirties.size() == 30;
+    for (std::size_t i = 1; ordered && i < thirties.size(); ++i)
+    {
+        ordered = store.get<Person>(thirties[i - 1]).age_ <= store.get<Person>(thirties[i]).age_;
+    }
+    if (contiguous && found == ids[42] && store.get<Person>(found).age_ == 42 && ordered &&
+        store.find("name", Any(std::string("乙"))).size() == 333)
+    {
+        std::cout << "✓ 对象连续存放，哈希索引按键查找，有序索引按范围查找" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 索引查找结果错误" << std::endl;
+    }
+
+    // 通过存储写入时增量更新索引；删除的槽位被复用
+    store.set(ids[42], "age", Any(200));
+    store.set(ids[42], "id", Any(99999LL));
+    store.modify(ids[7], [](void *object)
+                 { static_cast<Person *>(object)->age_ = 201; });
+    store.erase(ids[8]);
+    std::vector<ObjectStore::Id> old = store.range("age", Any(200), Any(300));
+    bool updated = old.size() == 2 && old[0] == ids[42] && old[1] == ids[7] &&
+                   store.findOne("id", Any(10042LL)) == ObjectStore::npos &&
+                   store.findOne("id", Any(99999LL)) == ids[42] &&
+                   store.findOne("id", Any(10008LL)) == ObjectStore::npos &&
+                   store.size() == 999 && store.insert() == ids[8];
+    bool rejected = false;
+    try
+    {
+        store.find("id", Any(42));
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    if (updated && rejected)
+    {
+        std::cout << "✓ set / modify / erase 增量更新索引，键类型不一致时报错" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 索引更新结果错误" << std::endl;
+    }
+}
+
+/**
+ * @brief 测试枚举反射：名字与值互查、位标志、枚举字段按名字读写和 CSV
+ */
+void testEnumReflection()
+{
+    std::cout << "\n=== 测试枚举反射 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerEnum<Priority>("Priority",
+                                    {{"Low", Priority::Low}, {"Normal", Priority::Normal}, {"High", Priority::High}});
+    registry.registerEnum<Permission>("Permission",
+                                      {{"None", PermNone},
+                                       {"Read", PermRead},
+                                       {"Write", PermWrite},
+                                       {"Exec", PermExec},
+                                       {"ReadWrite", PermReadWrite}},
+                                      true);
+    registry.registerClass<Ticket>("Ticket");
+    registry.registerField("Ticket", "title", &Ticket::title_);
+    registry.registerField("Ticket", "priority", &Ticket::priority_);
+    registry.registerField("Ticket", "access", &Ticket::access_);
+    registry.registerField("Ticket", "estimate", &Ticket::estimate_);
+
+    bool names = registry.enumToString(Priority::High) == "High" &&
+                 registry.enumFromString<Priority>("Low") == Priority::Low &&
+                 registry.enumToString(static_cast<Priority>(9)) == "9" &&
+                 registry.enumInfo("Priority") == registry.enumInfo<Priority>() &&
+                 registry.enumInfo<Priority>()->nameOf(2) != nullptr;
+    bool flags = registry.enumToString(static_cast<Permission>(PermRead | PermExec)) == "Read|Exec" &&
+                 registry.enumToString(static_cast<Permission>(7)) == "ReadWrite|Exec" &&
+                 registry.enumToString(static_cast<Permission>(9)) == "Read|8" &&
+                 registry.enumToString(PermNone) == "None" &&
+                 registry.enumFromString<Permission>("Write | Exec") == static_cast<Permission>(6) &&
+                 registry.enumFromString<Permission>("Read|16") == static_cast<Permission>(17);
+    if (names && flags)
+    {
+        std::cout << "✓ 名字与值双向查找，位标志按组合格式化和解析" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 枚举名字转换错误" << std::endl;
+    }
+
+    // 枚举字段：类型操作表直接带有名字表
+    Ticket ticket;
+    const TypeOps &ops = registry.findField("Ticket", "priority")->fieldOps();
+    registry.setEnumName("Ticket", "access", &ticket, "Read|Write");
+    registry.setEnumName("Ticket", "priority", &ticket, "High");
+    bool rejected = false;
+    try
+    {
+        registry.setEnumName("Ticket", "priority", &ticket, "Urgent");
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    try
+    {
+        registry.getEnumName("Ticket", "estimate", &ticket);
+        rejected = false;
+    }
+    catch (const std::invalid_argument &)
+    {
+    }
+    if (ops.enumInfo != nullptr && ops.enumInfo() == registry.enumInfo<Priority>() &&
+        ticket.access_ == PermReadWrite && ticket.priority_ == Priority::High &&
+        registry.getEnumName("Ticket", "access", &ticket) == "ReadWrite" &&
+        any_cast<Priority>(registry.getValues("Ticket", "priority", &ticket)) == Priority::High && rejected)
+    {
+        std::cout << "✓ 枚举字段按名字读写，无效名字和非枚举字段报错" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 枚举字段读写错误" << std::endl;
+    }
+
+    // 取值稀疏的枚举用哈希表
+    enum Sparse : long long
+    {
+        Minus = -5,
+        One = 1,
+        Big = 1LL << 40
+    };
+    const EnumInfo &sparse = registry.registerEnum<Sparse>("Sparse", {{"Minus", Minus}, {"One", One}, {"Big", Big}});
+    long long big = 0;
+    bool sparseOk = *sparse.nameOf(-5) == "Minus" && *sparse.nameOf(1LL << 40) == "Big" &&
+                    sparse.nameOf(2) == nullptr && sparse.valueOf(NameRef("Big"), big) && big == (1LL << 40);
+
+    std::vector<Ticket> tickets(3);
+    tickets[0].title_ = "a";
+    tickets[0].priority_ = Priority::Low;
+    tickets[1].title_ = "b";
+    tickets[1].access_ = static_cast<Permission>(PermWrite | PermExec);
+    tickets[2].title_ = "c";
+    tickets[2].priority_ = Priority::High;
+    tickets[2].access_ = PermReadWrite;
+    std::string text = CsvWriter(registry, "Ticket").toString(tickets);
+    std::vector<Ticket> loaded = CsvReader(registry, "Ticket").read<Ticket>(text);
+    bool csv = text == "title,priority,access,estimate\na,Low,None,0\nb,Normal,Write|Exec,0\nc,High,ReadWrite,0\n" &&
+               loaded.size() == 3 && loaded[1].access_ == tickets[1].access_ &&
+               loaded[2].priority_ == Priority::High && loaded[2].access_ == PermReadWrite;
+    if (sparseOk && csv)
+    {
+        std::cout << "✓ 稀疏取值的枚举可查，CSV 按名字导出导入枚举字段" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 稀疏枚举或 CSV 枚举列错误: " << text << std::endl;
+    }
+}
+
+/**
+ * @brief 测试字段间的数据绑定：批量 flush、立即传播、链式传播与环
+ */
+void testDataBinding()
+{
+    std::cout << "\n=== 测试数据绑定 ===" << std::endl;
+
+    auto &registry = ReflectionRegistry::getInstance();
+    registry.registerClass<ProfileView>("ProfileView");
+    registry.registerField("ProfileView", "age", &ProfileView::age_);
+    registry.registerField("ProfileView", "ageLabel", &ProfileView::ageLabel_);
+    registry.registerField("ProfileView", "title", &ProfileView::title_);
+
+    Person person("绑定", 20);
+    ProfileView view;
+    {
+        BindingSet bindings(registry);
+        bindings.bind("Person", &person, "age", "ProfileView", &view, "age");
+        bindings.bind<int, std::string>("Person", &person, "age", "ProfileView", &view, "ageLabel",
+                                        [](const int &age)
+                                        { return std::to_string(age) + " 岁"; });
+        bindings.bind("Person", &person, "name", "ProfileView", &view, "title");
+        bool initial = view.age_ == 20 && view.ageLabel_ == "20 岁" && view.title_ == "绑定";
+
+        // 经注册表写入只记下受影响的绑定，flush 时一次同步
+        registry.setValue("Person", "age", &person, Any(30));
+        bool deferred = bindings.pending() == 2 && view.age_ == 20;
+        std::size_t applied = bindings.flush();
+        person.name_ = "直接修改";
+        bindings.markChanged("Person", &person, "name");
+        std::size_t second = bindings.flush();
+        if (initial && deferred && applied == 2 && view.age_ == 30 && view.ageLabel_ == "30 岁" && second == 1 &&
+            view.title_ == "直接修改" && bindings.flush() == 0 && bindings.size() == 3)
+        {
+            std::cout << "✓ 绑定时同步一次，之后 flush 只执行变化的绑定" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ 批量绑定同步错误" << std::endl;
+        }
+    }
+
+    // 已执行过的绑定在同一次 flush 中源再次变化时要再执行：a -> b 与 c -> a，先写 a 再写 c
+    {
+        ProfileView a, b, c;
+        int results[2][2];
+        const BindingSet::Mode modes[2] = {BindingSet::Mode::Batched, BindingSet::Mode::Eager};
+        for (int m = 0; m < 2; ++m)
+        {
+            BindingSet ordered(registry, modes[m]);
+            ordered.bind("ProfileView", &a, "age", "ProfileView", &b, "age");
+            ordered.bind("ProfileView", &c, "age", "ProfileView", &a, "age");
+            registry.setValue("ProfileView", "age", &a, Any(5));
+            registry.setValue("ProfileView", "age", &c, Any(9));
+            ordered.flush();
+            results[m][0] = a.age_;
+            results[m][1] = b.age_ + static_cast<int>(ordered.pending()) * 1000;
+        }
+        if (results[0][0] == 9 && results[0][1] == 9 && results[1][0] == 9 && results[1][1] == 9)
+        {
+            std::cout << "✓ flush 中源再次变化的绑定重新执行，与立即模式结果一致" << std::endl;
+        }
+        else
+        {
+            std::cout << "✗ flush 丢失了同一次 flush 中的后续变化" << std::endl;
+        }
+    }
+
+    // 其他线程经同一注册表写入无关字段时，监听者的登记、通知与 flush 可以并发
+    {
+        std::atomic<bool> stop(false);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 2; ++t)
+        {
+            writers.push_back(std::thread([&registry, &stop]()
+                                          {
+                                              ProfileView unrelated;
+                                              for (int i = 0; !stop.load(); ++i)
+                                              {
+                                                  registry.setValue("ProfileView", "age", &unrelated, Any(i));
+                                              }
+                                          }));
+        }
+        ProfileView from, to;
+        bool synced = true;
+        for (int round = 0; round < 200; ++round)
+        {
+            BindingSet concurrent(registry);
+            concurrent.bind("ProfileView", &from, "age", "ProfileView", &to, "age");
+            registry.setValue("ProfileView", "age", &from, Any(round));
+            concurrent.flush();
+            synced = synced && to.age_ == round;
+        }
+        stop.store(true);
+        for (auto &writer : writers)
+        {
+            writer.join();
+        }
+        std::cout << (synced ? "✓ 其他线程并发写入时绑定的登记与同步正确" : "✗ 并发写入时绑定同步错误")
+                  << std::endl;
+    }
+
+    // 立即传播：person.age -> view.age -> mirror.age 链式传播；两个标题互相绑定也不会无限循环
+    ProfileView mirror;
+    BindingSet eager(registry, BindingSet::Mode::Eager);
+    eager.bind("Person", &person, "age", "ProfileView", &view, "age");
+    BindingSet::Id chained = eager.bind("ProfileView", &view, "age", "ProfileView", &mirror, "age");
+    eager.bind("ProfileView", &view, "title", "ProfileView", &mirror, "title");
+    eager.bind("ProfileView", &mirror, "title", "ProfileView", &view, "title");
+    registry.setValue("Person", "age", &person, Any(41));
+    bool chain = view.age_ == 41 && mirror.age_ == 41;
+    registry.setValue("ProfileView", "title", &mirror, Any(std::string("环")));
+    bool cycle = view.title_ == "环" && mirror.title_ == "环";
+    eager.unbind(chained);
+    registry.setValue("Person", "age", &person, Any(42));
+    bool unbound = view.age_ == 42 && mirror.age_ == 41 && eager.size() == 3;
+
+    int errors = 0;
+    try
+    {
+        eager.bind("Person", &person, "age", "ProfileView", &view, "title");
+    }
+    catch (const std::invalid_argument &)
+    {
+        ++errors;
+    }
+    try
+    {
+        eager.bind("ProfileView", &view, "age", "Person", &person, "constantValue");
+    }
+    catch (const std::invalid_argument &)
+    {
+        ++errors;
+    }
+    if (chain && cycle && unbound && errors == 2)
+    {
+        std::cout << "✓ 立即模式链式传播，环在一次传播中终止，类型不符或目标只读时报错" << std::endl;
+    }
+    else
+    {
+        std::cout << "✗ 立即模式绑定错误" << std::endl;
+    }
+}
+
 /**
  * @brief 主函数
  */
@@ -606,6 +2674,29 @@ int main()
         // testErrorHandling();
         // testConstMemberAccess();
         // testConstMethodInvocation();
+        testLazyRegistration();
+        testInheritance();
+        testOverloadedMethods();
+        testAsyncInvocation();
+        testBatchInvocation();
+        testCallPlan();
+        testPropertyPath();
+        testContainerView();
+        testMemberVisitors();
+        testNameRefLookup();
+        testAnyAllocator();
+        testSharedAny();
+        testMemberTable();
+        testMemoryStats();
+        testRegistryInstances();
+        testPluginLoading();
+        testObjectCopy();
+        testObjectComparison();
+        testQuery();
+        testCsvTable();
+        testObjectStore();
+        testEnumReflection();
+        testDataBinding();
 
 
         std::cout << "\n=== 所有测试完成 ===" << std::endl;